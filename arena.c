@@ -0,0 +1,33 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+int ArenaInit(Arena *arena, size_t capacity) {
+    if (!arena) return 0;
+    memset(arena, 0, sizeof(*arena));
+    capacity = ArenaAlignSize(capacity ? capacity : ARENA_ALIGN);
+    arena->base = (uint8_t*)malloc(capacity);
+    if (!arena->base) return 0;
+    arena->capacity = capacity;
+    return 1;
+}
+
+void *ArenaAlloc(Arena *arena, size_t size) {
+    if (!arena || !arena->base) return NULL;
+    size = ArenaAlignSize(size);
+    if (size > arena->capacity - arena->used) return NULL;
+    void *p = arena->base + arena->used;
+    arena->used += size;
+    memset(p, 0, size);
+    return p;
+}
+
+void ArenaReset(Arena *arena) {
+    if (arena) arena->used = 0;
+}
+
+void ArenaRelease(Arena *arena) {
+    if (!arena) return;
+    free(arena->base);
+    memset(arena, 0, sizeof(*arena));
+}
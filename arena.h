@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 线性分配器：一次分配整块内存，按顺序切分，整体一次释放
+// 不支持单独释放；容量用尽时 ArenaAlloc 返回 NULL
+
+#define ARENA_ALIGN 8
+
+typedef struct {
+    uint8_t *base;
+    size_t capacity;
+    size_t used;
+} Arena;
+
+// 按 ARENA_ALIGN 对齐后的大小，便于预先累加所需容量
+static inline size_t ArenaAlignSize(size_t size) {
+    return (size + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+int ArenaInit(Arena *arena, size_t capacity);
+
+// 分配清零的内存
+void *ArenaAlloc(Arena *arena, size_t size);
+
+// 丢弃全部分配，保留内存块
+void ArenaReset(Arena *arena);
+
+void ArenaRelease(Arena *arena);
+
+#endif // ARENA_H
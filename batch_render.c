@@ -0,0 +1,473 @@
+// 批量无头渲染：读取多份课程表，在线程池中按 视图 x 尺寸 x DPI 渲染并写出 PNG 或 QOI
+// Linux: gcc -O2 -pthread batch_render.c render_core.c render_soft.c schedule.c schedule_index.c arena.c text_cache.c corner_tiles.c pixel_kernels.c frame_trace.c image_encode.c timetable_data.c -o timetable_batch -lm
+//
+// 用法: timetable_batch [--views day,week] [--sizes WxH,...] [--dpis N,...] [--today DAY] [--minute M]
+//                       [--format png|qoi] [--threads N] [--out-dir DIR] [--no-write] [--list FILE]
+//                       [--builtin] [FILE.ttb ...]
+// 每份课程表输出 <文件名>_<day|week>_<宽>x<高>_<dpi>.<png|qoi>（内置课程表的文件名为 builtin）；
+// --list 从文件逐行读取课程表路径（空行与 # 开头的行忽略）；--no-write 只渲染与编码，用于测吞吐
+// --out-dir 不存在时自动创建（含上级目录）；--today 须小于每份课程表的天数
+// 结束时在标准输出打印图像数、耗时、每秒图像数以及渲染/编码/写出各自的累计耗时
+
+#include "render_core.h"
+#include "render_soft.h"
+#include "pixel_kernels.h"
+#include "corner_tiles.h"
+#include "image_encode.h"
+#include "schedule.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define BATCH_MAX_VIEWS   2
+#define BATCH_MAX_SIZES   16
+#define BATCH_MAX_DPIS    8
+#define BATCH_MAX_THREADS 64
+#define BATCH_PATH_CHARS  1024
+
+typedef struct {
+    int width;
+    int height;
+} BatchSize;
+
+typedef struct {
+    char name[256];     // 输出文件名前缀
+    Schedule schedule;
+} BatchSchedule;
+
+typedef struct {
+    BatchSchedule *schedules;
+    int scheduleCount;
+    int views[BATCH_MAX_VIEWS];
+    int viewCount;
+    BatchSize sizes[BATCH_MAX_SIZES];
+    int sizeCount;
+    unsigned int dpis[BATCH_MAX_DPIS];
+    int dpiCount;
+    int today;
+    int minuteOfDay;
+    ImageFormat format;
+    const char *outDir;
+    int write;
+
+    int jobCount;
+    atomic_int nextJob;
+    atomic_int failures;
+} BatchContext;
+
+typedef struct {
+    BatchContext *context;
+    int images;
+    size_t bytes;
+    double renderMs;
+    double encodeMs;
+    double writeMs;
+} BatchWorker;
+
+static double NowMs(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq = {0};
+    if (!freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+static int CpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static int WriteFile_(const char *path, const void *data, size_t size) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return 0;
+    int ok = fwrite(data, 1, size, f) == size;
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
+
+// 创建一级目录；已存在时同样返回 1
+static int MakeDirectory(const char *path) {
+#ifdef _WIN32
+    if (CreateDirectoryA(path, NULL)) return 1;
+    DWORD attributes = GetFileAttributesA(path);
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    if (mkdir(path, 0777) == 0) return 1;
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+// 创建输出目录及不存在的上级目录；失败返回 0
+static int EnsureDirectory(const char *path) {
+    char buffer[BATCH_PATH_CHARS];
+    if (!path[0] || snprintf(buffer, sizeof(buffer), "%s", path) >= (int)sizeof(buffer)) return 0;
+    for (char *p = buffer + 1; *p; ++p) {
+        if (*p != '/' && *p != '\\') continue;
+        // 盘符（C:\）无需创建；中间目录的错误由最后一级的检查报告
+        if (!(p == buffer + 2 && buffer[1] == ':')) {
+            char separator = *p;
+            *p = '\0';
+            MakeDirectory(buffer);
+            *p = separator;
+        }
+    }
+    return MakeDirectory(buffer);
+}
+
+// 工作线程：各自持有渲染核心（含文本段缓存）、表面与编码缓冲，从共享计数器领取任务
+// 任务按课程表为主序排列，相邻任务多为同一课程表，文本段缓存命中率高
+static void RunWorker(BatchWorker *worker) {
+    BatchContext *ctx = worker->context;
+    TextBackend backend;
+    RenderSoftTextBackend(&backend);
+    RenderCore *core = RenderCoreCreate(&backend);
+    if (!core) {
+        atomic_fetch_add(&ctx->failures, 1);
+        return;
+    }
+
+    RenderSurface surface = {0};
+    ImageBuffer image = {0};
+    const Schedule *current = NULL;
+    int perSchedule = ctx->viewCount * ctx->sizeCount * ctx->dpiCount;
+
+    for (;;) {
+        int job = atomic_fetch_add(&ctx->nextJob, 1);
+        if (job >= ctx->jobCount) break;
+
+        int rest = job;
+        const BatchSchedule *entry = &ctx->schedules[rest / perSchedule];
+        rest %= perSchedule;
+        int viewMode = ctx->views[rest / (ctx->sizeCount * ctx->dpiCount)];
+        rest %= ctx->sizeCount * ctx->dpiCount;
+        BatchSize size = ctx->sizes[rest / ctx->dpiCount];
+        unsigned int dpi = ctx->dpis[rest % ctx->dpiCount];
+
+        double startMs = NowMs();
+        if (surface.width != size.width || surface.height != size.height) {
+            RenderSoftSurfaceFree(&surface);
+            if (!RenderSoftSurfaceCreate(&surface, size.width, size.height)) {
+                atomic_fetch_add(&ctx->failures, 1);
+                continue;
+            }
+        }
+        if (current != &entry->schedule) {
+            RenderCoreSetSchedule(core, &entry->schedule);
+            current = &entry->schedule;
+        }
+        RenderFrameParams params = {0};
+        params.viewMode = viewMode;
+        params.today = ctx->today;
+        params.dpi = dpi;
+        params.minuteOfDay = ctx->minuteOfDay;
+        RenderCoreDrawFrame(core, &surface, &params);
+        double renderedMs = NowMs();
+
+        if (!ImageEncode(ctx->format, surface.pixels, surface.width, surface.height, surface.stride, &image)) {
+            atomic_fetch_add(&ctx->failures, 1);
+            continue;
+        }
+        double encodedMs = NowMs();
+
+        if (ctx->write) {
+            char path[BATCH_PATH_CHARS];
+            snprintf(path, sizeof(path), "%s/%s_%s_%dx%d_%u.%s", ctx->outDir, entry->name,
+                     viewMode == 0 ? "day" : "week", size.width, size.height, dpi,
+                     ImageFormatExtension(ctx->format));
+            if (!WriteFile_(path, image.data, image.size)) {
+                fprintf(stderr, "cannot write %s\n", path);
+                atomic_fetch_add(&ctx->failures, 1);
+                continue;
+            }
+        }
+        double writtenMs = NowMs();
+
+        worker->images++;
+        worker->bytes += image.size;
+        worker->renderMs += renderedMs - startMs;
+        worker->encodeMs += encodedMs - renderedMs;
+        worker->writeMs += writtenMs - encodedMs;
+    }
+
+    ImageBufferFree(&image);
+    RenderSoftSurfaceFree(&surface);
+    RenderCoreDestroy(core);
+    CornerTilesClear();
+}
+
+#ifdef _WIN32
+static DWORD WINAPI WorkerEntry(LPVOID param) {
+    RunWorker((BatchWorker*)param);
+    return 0;
+}
+#else
+static void *WorkerEntry(void *param) {
+    RunWorker((BatchWorker*)param);
+    return NULL;
+}
+#endif
+
+// 在 count 个线程上运行；线程创建失败时由调用线程补上其份额
+static void RunPool(BatchWorker *workers, int count) {
+#ifdef _WIN32
+    HANDLE threads[BATCH_MAX_THREADS];
+    for (int i = 0; i < count; ++i) {
+        threads[i] = CreateThread(NULL, 0, WorkerEntry, &workers[i], 0, NULL);
+        if (!threads[i]) RunWorker(&workers[i]);
+    }
+    for (int i = 0; i < count; ++i) {
+        if (threads[i]) {
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        }
+    }
+#else
+    pthread_t threads[BATCH_MAX_THREADS];
+    int started[BATCH_MAX_THREADS];
+    for (int i = 0; i < count; ++i) {
+        started[i] = pthread_create(&threads[i], NULL, WorkerEntry, &workers[i]) == 0;
+        if (!started[i]) RunWorker(&workers[i]);
+    }
+    for (int i = 0; i < count; ++i) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+#endif
+}
+
+// 文件名（去掉目录与扩展名）作为输出前缀
+static void ScheduleNameFromPath(const char *path, char *name, size_t capacity) {
+    const char *base = path;
+    for (const char *p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') base = p + 1;
+    }
+    size_t length = strlen(base);
+    const char *dot = strrchr(base, '.');
+    if (dot && dot != base) length = (size_t)(dot - base);
+    if (length >= capacity) length = capacity - 1;
+    memcpy(name, base, length);
+    name[length] = 0;
+}
+
+static int AddSchedule(BatchContext *ctx, int *capacity, const char *path) {
+    if (ctx->scheduleCount == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 16;
+        BatchSchedule *schedules = (BatchSchedule*)realloc(ctx->schedules, sizeof(BatchSchedule) * (size_t)grown);
+        if (!schedules) return 0;
+        ctx->schedules = schedules;
+        *capacity = grown;
+    }
+    BatchSchedule *entry = &ctx->schedules[ctx->scheduleCount];
+    int ok = path ? ScheduleMapFile(path, &entry->schedule) : ScheduleFromBuiltin(&entry->schedule);
+    if (!ok) {
+        fprintf(stderr, "cannot load schedule %s\n", path ? path : "(builtin)");
+        return 0;
+    }
+    ScheduleNameFromPath(path ? path : "builtin", entry->name, sizeof(entry->name));
+    ctx->scheduleCount++;
+    return 1;
+}
+
+static int AddScheduleList(BatchContext *ctx, int *capacity, const char *listPath) {
+    FILE *f = fopen(listPath, "r");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", listPath);
+        return 0;
+    }
+    char line[BATCH_PATH_CHARS];
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), f)) {
+        size_t length = strcspn(line, "\r\n");
+        line[length] = 0;
+        if (length == 0 || line[0] == '#') continue;
+        ok = AddSchedule(ctx, capacity, line);
+    }
+    fclose(f);
+    return ok;
+}
+
+// 逗号分隔的列表；每项由 parse 解析，返回项数，出错返回 -1
+static int ParseList(const char *text, int maxItems, int (*parse)(const char *item, int index, void *out), void *out) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    int count = 0;
+    for (char *item = strtok(buffer, ","); item; item = strtok(NULL, ",")) {
+        if (count >= maxItems || !parse(item, count, out)) return -1;
+        count++;
+    }
+    return count;
+}
+
+static int ParseView(const char *item, int index, void *out) {
+    int *views = (int*)out;
+    if (strcmp(item, "day") == 0) views[index] = 0;
+    else if (strcmp(item, "week") == 0) views[index] = 1;
+    else return 0;
+    return 1;
+}
+
+static int ParseSize(const char *item, int index, void *out) {
+    BatchSize *sizes = (BatchSize*)out;
+    return sscanf(item, "%dx%d", &sizes[index].width, &sizes[index].height) == 2 &&
+           sizes[index].width > 0 && sizes[index].height > 0;
+}
+
+static int ParseDpi(const char *item, int index, void *out) {
+    unsigned int *dpis = (unsigned int*)out;
+    dpis[index] = (unsigned int)strtoul(item, NULL, 10);
+    return dpis[index] > 0;
+}
+
+static void PrintUsage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--views day,week] [--sizes WxH,...] [--dpis N,...] [--today DAY] [--minute M]\n"
+            "          [--format png|qoi] [--threads N] [--out-dir DIR] [--no-write] [--list FILE]\n"
+            "          [--builtin] [FILE.ttb ...]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    BatchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.views[0] = 0;
+    ctx.views[1] = 1;
+    ctx.viewCount = 2;
+    ctx.sizes[0].width = 420;
+    ctx.sizes[0].height = 360;
+    ctx.sizeCount = 1;
+    ctx.dpis[0] = 96;
+    ctx.dpiCount = 1;
+    ctx.minuteOfDay = -1;
+    ctx.format = IMAGE_FORMAT_PNG;
+    ctx.outDir = ".";
+    ctx.write = 1;
+    int threads = CpuCount();
+    int capacity = 0;
+    int ok = 1;
+
+    for (int i = 1; i < argc && ok; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--no-write") == 0) {
+            ctx.write = 0;
+        } else if (strcmp(arg, "--builtin") == 0) {
+            ok = AddSchedule(&ctx, &capacity, NULL);
+        } else if (arg[0] == '-' && arg[1] == '-' && !value) {
+            ok = 0;
+        } else if (strcmp(arg, "--views") == 0) {
+            ctx.viewCount = ParseList(argv[++i], BATCH_MAX_VIEWS, ParseView, ctx.views);
+            ok = ctx.viewCount > 0;
+        } else if (strcmp(arg, "--sizes") == 0) {
+            ctx.sizeCount = ParseList(argv[++i], BATCH_MAX_SIZES, ParseSize, ctx.sizes);
+            ok = ctx.sizeCount > 0;
+        } else if (strcmp(arg, "--dpis") == 0) {
+            ctx.dpiCount = ParseList(argv[++i], BATCH_MAX_DPIS, ParseDpi, ctx.dpis);
+            ok = ctx.dpiCount > 0;
+        } else if (strcmp(arg, "--today") == 0) {
+            ctx.today = atoi(argv[++i]);
+        } else if (strcmp(arg, "--minute") == 0) {
+            ctx.minuteOfDay = atoi(argv[++i]);
+        } else if (strcmp(arg, "--format") == 0) {
+            const char *format = argv[++i];
+            if (strcmp(format, "qoi") == 0) ctx.format = IMAGE_FORMAT_QOI;
+            else if (strcmp(format, "png") == 0) ctx.format = IMAGE_FORMAT_PNG;
+            else ok = 0;
+        } else if (strcmp(arg, "--threads") == 0) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--out-dir") == 0) {
+            ctx.outDir = argv[++i];
+        } else if (strcmp(arg, "--list") == 0) {
+            ok = AddScheduleList(&ctx, &capacity, argv[++i]);
+        } else if (arg[0] == '-') {
+            ok = 0;
+        } else {
+            ok = AddSchedule(&ctx, &capacity, arg);
+        }
+    }
+    if (!ok || ctx.scheduleCount == 0 || ctx.today < 0) {
+        PrintUsage(argv[0]);
+        for (int i = 0; i < ctx.scheduleCount; ++i) ScheduleClose(&ctx.schedules[i].schedule);
+        free(ctx.schedules);
+        return 2;
+    }
+    // 天数随课程表而定：--today 须落在每份课程表的网格内
+    for (int i = 0; i < ctx.scheduleCount && ok; ++i) {
+        if (ctx.today >= ctx.schedules[i].schedule.days) {
+            fprintf(stderr, "--today %d out of range: %s has %d days\n",
+                    ctx.today, ctx.schedules[i].name, ctx.schedules[i].schedule.days);
+            ok = 0;
+        }
+    }
+    // 写出前先建立输出目录，避免每张图都写入失败
+    if (ok && ctx.write && !EnsureDirectory(ctx.outDir)) {
+        fprintf(stderr, "cannot create output directory %s\n", ctx.outDir);
+        ok = 0;
+    }
+    if (!ok) {
+        for (int i = 0; i < ctx.scheduleCount; ++i) ScheduleClose(&ctx.schedules[i].schedule);
+        free(ctx.schedules);
+        return 1;
+    }
+
+    long long jobs = (long long)ctx.scheduleCount * ctx.viewCount * ctx.sizeCount * ctx.dpiCount;
+    ctx.jobCount = jobs > 0x7FFFFFFF ? 0x7FFFFFFF : (int)jobs;
+    if (threads < 1) threads = 1;
+    if (threads > BATCH_MAX_THREADS) threads = BATCH_MAX_THREADS;
+    if (threads > ctx.jobCount) threads = ctx.jobCount;
+
+    // 内核选择在首次使用时进行，先在主线程完成，避免工作线程同时初始化
+    PixelKernelsIsa();
+
+    BatchWorker workers[BATCH_MAX_THREADS];
+    memset(workers, 0, sizeof(workers));
+    for (int i = 0; i < threads; ++i) {
+        workers[i].context = &ctx;
+    }
+    double startMs = NowMs();
+    RunPool(workers, threads);
+    double elapsedMs = NowMs() - startMs;
+
+    BatchWorker total = {0};
+    for (int i = 0; i < threads; ++i) {
+        total.images += workers[i].images;
+        total.bytes += workers[i].bytes;
+        total.renderMs += workers[i].renderMs;
+        total.encodeMs += workers[i].encodeMs;
+        total.writeMs += workers[i].writeMs;
+    }
+    int failures = atomic_load(&ctx.failures);
+    printf("%d images (%d failed) in %.1f ms on %d threads: %.1f images/s, %.1f MB, isa %s\n",
+           total.images, failures, elapsedMs, threads,
+           elapsedMs > 0.0 ? total.images * 1000.0 / elapsedMs : 0.0,
+           total.bytes / 1048576.0, PixelKernelsIsaName(PixelKernelsIsa()));
+    printf("cpu time: render %.1f ms, encode %.1f ms, write %.1f ms\n",
+           total.renderMs, total.encodeMs, total.writeMs);
+
+    for (int i = 0; i < ctx.scheduleCount; ++i) {
+        ScheduleClose(&ctx.schedules[i].schedule);
+    }
+    free(ctx.schedules);
+    return failures ? 1 : 0;
+}
@@ -1,2 +1,5 @@
 @echo off
-gcc -municode timetable.c timetable_data.c sys_utils.c renderer.c -o timetable.exe -lgdi32 -lshell32 -luser32 -lwinmm -mwindow
+gcc -municode timetable.c timetable_data.c sys_utils.c renderer.c render_core.c render_gdi.c schedule.c schedule_index.c arena.c pixel_kernels.c corner_tiles.c text_cache.c frame_scheduler.c frame_governor.c frame_trace.c warm_start.c widget_controller.c -o timetable.exe -lgdi32 -lshell32 -luser32 -lwinmm -lpsapi -mwindow
+gcc -O2 render_bench.c render_core.c render_soft.c schedule.c schedule_index.c arena.c text_cache.c corner_tiles.c pixel_kernels.c frame_trace.c warm_start.c timetable_data.c -o render_bench.exe
+gcc -O2 batch_render.c render_core.c render_soft.c schedule.c schedule_index.c arena.c text_cache.c corner_tiles.c pixel_kernels.c frame_trace.c image_encode.c timetable_data.c -o timetable_batch.exe
+rem 测试在 Linux 下构建并运行：sh tests/run_tests.sh（各测试的单独构建命令见 README）
@@ -0,0 +1,102 @@
+#include "corner_tiles.h"
+#include "pixel_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 多显示器下 DPI 可能在少数几个值之间切换，保留少量条目即可
+#define CORNER_CACHE_ENTRIES 4
+
+typedef struct {
+    CornerTiles tiles;
+    unsigned long long lastUse;
+} CornerCacheEntry;
+
+// 缓存按线程独立：批量渲染的各工作线程互不加锁，窗口程序只有渲染线程使用
+static _Thread_local CornerCacheEntry g_cornerCache[CORNER_CACHE_ENTRIES];
+static _Thread_local unsigned long long g_cornerUseClock = 0;
+static _Thread_local CornerTileStats g_cornerStats = {0};
+
+int CornerTilesScaledRadius(int baseRadius, unsigned int dpi) {
+    // MulDiv 四舍五入
+    long long scaled = ((long long)baseRadius * dpi + 48) / 96;
+    return (scaled < 4) ? 4 : (int)scaled;
+}
+
+static void ReleaseEntry(CornerCacheEntry *entry) {
+    // 四个贴片共用一块分配
+    free(entry->tiles.tiles[0]);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static int BuildTiles(CornerTiles *out, int baseRadius, unsigned int dpi, uint8_t baseAlpha) {
+    int r = CornerTilesScaledRadius(baseRadius, dpi);
+    size_t tileBytes = (size_t)r * r;
+    uint8_t *block = (uint8_t*)malloc(tileBytes * CORNER_COUNT);
+    if (!block) return 0;
+
+    for (int c = 0; c < CORNER_COUNT; ++c) {
+        out->tiles[c] = block + tileBytes * c;
+    }
+
+    // 左/上侧圆心在贴片内侧边缘 (r - 0.5)，右/下侧圆心在贴片外一个像素 (-0.5)，
+    // 因此像素中心到圆心的偏移分别为 i + 1 - r 与 i + 1
+    for (int j = 0; j < r; ++j) {
+        int dyTop = j + 1 - r;
+        int dyBottom = j + 1;
+        for (int i = 0; i < r; ++i) {
+            int dxLeft = i + 1 - r;
+            int dxRight = i + 1;
+            size_t idx = (size_t)j * r + i;
+            out->tiles[CORNER_TOP_LEFT][idx] = PixelCornerAlpha(dxLeft, dyTop, r, baseAlpha);
+            out->tiles[CORNER_TOP_RIGHT][idx] = PixelCornerAlpha(dxRight, dyTop, r, baseAlpha);
+            out->tiles[CORNER_BOTTOM_LEFT][idx] = PixelCornerAlpha(dxLeft, dyBottom, r, baseAlpha);
+            out->tiles[CORNER_BOTTOM_RIGHT][idx] = PixelCornerAlpha(dxRight, dyBottom, r, baseAlpha);
+        }
+    }
+
+    out->baseRadius = baseRadius;
+    out->dpi = dpi;
+    out->baseAlpha = baseAlpha;
+    out->radius = r;
+    return 1;
+}
+
+const CornerTiles *CornerTilesGet(int baseRadius, unsigned int dpi, uint8_t baseAlpha) {
+    CornerCacheEntry *victim = &g_cornerCache[0];
+    ++g_cornerUseClock;
+
+    for (int i = 0; i < CORNER_CACHE_ENTRIES; ++i) {
+        CornerCacheEntry *entry = &g_cornerCache[i];
+        if (entry->tiles.radius > 0 &&
+            entry->tiles.baseRadius == baseRadius &&
+            entry->tiles.dpi == dpi &&
+            entry->tiles.baseAlpha == baseAlpha) {
+            entry->lastUse = g_cornerUseClock;
+            g_cornerStats.hits++;
+            return &entry->tiles;
+        }
+        if (entry->lastUse < victim->lastUse) {
+            victim = entry;
+        }
+    }
+
+    g_cornerStats.misses++;
+    ReleaseEntry(victim);
+    if (!BuildTiles(&victim->tiles, baseRadius, dpi, baseAlpha)) {
+        return NULL;
+    }
+    victim->lastUse = g_cornerUseClock;
+    return &victim->tiles;
+}
+
+void CornerTilesGetStats(CornerTileStats *stats) {
+    if (stats) {
+        *stats = g_cornerStats;
+    }
+}
+
+void CornerTilesClear(void) {
+    for (int i = 0; i < CORNER_CACHE_ENTRIES; ++i) {
+        ReleaseEntry(&g_cornerCache[i]);
+    }
+}
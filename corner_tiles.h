@@ -0,0 +1,47 @@
+#ifndef CORNER_TILES_H
+#define CORNER_TILES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 圆角抗锯齿 alpha 贴片缓存：按 (半径, DPI, 基准 alpha) 计算一次四个角的贴片
+// 缓存属于调用线程，返回的贴片只在该线程内有效；本模块不依赖 Win32
+
+typedef enum {
+    CORNER_TOP_LEFT = 0,
+    CORNER_TOP_RIGHT,
+    CORNER_BOTTOM_LEFT,
+    CORNER_BOTTOM_RIGHT,
+    CORNER_COUNT
+} CornerIndex;
+
+typedef struct {
+    int baseRadius;              // 96 DPI 下的圆角半径
+    unsigned int dpi;
+    uint8_t baseAlpha;
+    int radius;                  // 按 DPI 缩放后的像素半径，贴片边长
+    uint8_t *tiles[CORNER_COUNT]; // 每个贴片 radius*radius 字节，按行存放
+} CornerTiles;
+
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+} CornerTileStats;
+
+// 按 DPI 缩放圆角半径（与 max(4, MulDiv(radius, dpi, 96)) 一致）
+int CornerTilesScaledRadius(int baseRadius, unsigned int dpi);
+
+// 取得对应参数的贴片；首次请求时计算，之后命中缓存。失败返回 NULL
+const CornerTiles *CornerTilesGet(int baseRadius, unsigned int dpi, uint8_t baseAlpha);
+
+// 某个角第 row 行的 alpha
+static inline const uint8_t *CornerTilesRow(const CornerTiles *tiles, CornerIndex corner, int row) {
+    return tiles->tiles[corner] + (size_t)row * tiles->radius;
+}
+
+void CornerTilesGetStats(CornerTileStats *stats);
+
+// 释放调用线程缓存的全部贴片（工作线程退出前调用）
+void CornerTilesClear(void);
+
+#endif // CORNER_TILES_H
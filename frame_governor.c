@@ -0,0 +1,103 @@
+#include "frame_governor.h"
+#include <string.h>
+
+#define COST_SMOOTHING        0.125   // 帧成本滑动平均的权重
+#define UPGRADE_HEADROOM      0.75    // 升档后的预计开销需低于预算的这一比例
+#define UPGRADE_STREAK_FRAMES 30
+
+static const unsigned int g_tierFps[FRAME_TIER_COUNT] = {60, 30, 10};
+
+unsigned int FrameTierFps(FrameTier tier) {
+    return (unsigned int)tier < FRAME_TIER_COUNT ? g_tierFps[tier] : g_tierFps[FRAME_TIER_COUNT - 1];
+}
+
+uint32_t FrameTierIntervalMs(FrameTier tier) {
+    return 1000u / FrameTierFps(tier);
+}
+
+void FrameGovernorInit(FrameGovernor *governor, double budgetMs) {
+    memset(governor, 0, sizeof(*governor));
+    governor->budgetMs = budgetMs > 0.0 ? budgetMs : FRAME_GOVERNOR_DEFAULT_BUDGET_MS;
+    governor->costTier = FRAME_TIER_60;
+    governor->tier = FRAME_TIER_60;
+}
+
+static double CostPerSecond(const FrameGovernor *governor, FrameTier tier) {
+    return governor->avgCostMs * FrameTierFps(tier);
+}
+
+// 合并成本档位与电源、遮挡的上限，取较低的帧率
+static int Apply(FrameGovernor *governor) {
+    FrameTier ceiling = FRAME_TIER_60;
+    unsigned int limits = FRAME_LIMIT_NONE;
+    if (governor->onBattery) {
+        limits |= FRAME_LIMIT_BATTERY;
+        ceiling = FRAME_TIER_30;
+    }
+    if (governor->batterySaver) {
+        limits |= FRAME_LIMIT_SAVER;
+        ceiling = FRAME_TIER_10;
+    }
+    if (governor->occluded) {
+        limits |= FRAME_LIMIT_OCCLUDED;
+        ceiling = FRAME_TIER_10;
+    }
+
+    FrameTier tier = ceiling;
+    if (governor->costTier > ceiling) {
+        tier = governor->costTier;
+        limits |= FRAME_LIMIT_COST;
+    }
+    governor->limits = limits;
+    if (tier == governor->tier) return 0;
+    governor->tier = tier;
+    governor->stats.tierChanges++;
+    return 1;
+}
+
+int FrameGovernorSetPower(FrameGovernor *governor, int onBattery, int batterySaver) {
+    governor->onBattery = onBattery ? 1 : 0;
+    governor->batterySaver = batterySaver ? 1 : 0;
+    return Apply(governor);
+}
+
+int FrameGovernorSetOccluded(FrameGovernor *governor, int occluded) {
+    governor->occluded = occluded ? 1 : 0;
+    return Apply(governor);
+}
+
+int FrameGovernorRecordFrame(FrameGovernor *governor, double costMs) {
+    if (costMs < 0.0) costMs = 0.0;
+    governor->stats.framesAtTier[governor->tier]++;
+    if (governor->stats.samples++ == 0) {
+        governor->avgCostMs = costMs;
+    } else {
+        governor->avgCostMs += (costMs - governor->avgCostMs) * COST_SMOOTHING;
+    }
+
+    // 超出预算立即降到能容纳的档位；升档需要较高档位连续留有余量，避免在边界来回切换
+    FrameTier costTier = governor->costTier;
+    while (costTier < FRAME_TIER_10 && CostPerSecond(governor, costTier) > governor->budgetMs) {
+        costTier++;
+    }
+    if (costTier == governor->costTier && costTier > FRAME_TIER_60 &&
+        CostPerSecond(governor, costTier - 1) <= governor->budgetMs * UPGRADE_HEADROOM) {
+        if (++governor->upgradeStreak >= UPGRADE_STREAK_FRAMES) {
+            costTier--;
+            governor->upgradeStreak = 0;
+        }
+    } else {
+        governor->upgradeStreak = 0;
+    }
+    governor->costTier = costTier;
+    return Apply(governor);
+}
+
+uint32_t FrameGovernorMarqueeIntervalMs(const FrameGovernor *governor, unsigned int pixelsPerSecond) {
+    uint32_t interval = FrameTierIntervalMs(governor->tier);
+    if (pixelsPerSecond > 0) {
+        uint32_t perPixel = (1000u + pixelsPerSecond - 1) / pixelsPerSecond;
+        if (perPixel > interval) interval = perPixel;
+    }
+    return interval;
+}
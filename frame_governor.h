@@ -0,0 +1,62 @@
+#ifndef FRAME_GOVERNOR_H
+#define FRAME_GOVERNOR_H
+
+#include <stdint.h>
+
+// 帧率调节：按实测帧成本、电源状态与每秒渲染预算为滚动帧与缩放动画选择帧率档位
+// 成本超出预算时立即降档，较高档位连续一段时间都留有余量才升档；本模块不依赖 Win32
+// 档位是帧率上限：滚动帧还受文本移动速度（由调用方传入）限制，实际帧率见 FrameGovernorMarqueeIntervalMs
+
+#define FRAME_GOVERNOR_DEFAULT_BUDGET_MS 50.0   // 每秒最多用于渲染与提交的毫秒数（约单核 5%）
+
+typedef enum {
+    FRAME_TIER_60 = 0,
+    FRAME_TIER_30,
+    FRAME_TIER_10,
+    FRAME_TIER_COUNT
+} FrameTier;
+
+// 限制最高档位的原因，按位组合
+typedef enum {
+    FRAME_LIMIT_NONE       = 0,
+    FRAME_LIMIT_COST       = 1 << 0,   // 帧成本超出预算
+    FRAME_LIMIT_BATTERY    = 1 << 1,   // 使用电池：最高 30 FPS
+    FRAME_LIMIT_SAVER      = 1 << 2,   // 节电模式：最高 10 FPS
+    FRAME_LIMIT_OCCLUDED   = 1 << 3    // 窗口被其他窗口完全遮挡：最高 10 FPS
+} FrameLimit;
+
+typedef struct {
+    unsigned long long samples;                   // 记录的帧数
+    unsigned long long tierChanges;
+    unsigned long long framesAtTier[FRAME_TIER_COUNT];
+} FrameGovernorStats;
+
+typedef struct {
+    double budgetMs;        // 每秒的渲染预算
+    double avgCostMs;       // 帧成本（渲染 + 提交）的指数滑动平均
+    int onBattery;
+    int batterySaver;
+    int occluded;
+    int upgradeStreak;      // 较高档位连续留有余量的帧数
+    FrameTier costTier;     // 只按成本选择的档位
+    FrameTier tier;         // 实际使用的档位
+    unsigned int limits;    // FrameLimit 的组合
+    FrameGovernorStats stats;
+} FrameGovernor;
+
+// budgetMs <= 0 时使用 FRAME_GOVERNOR_DEFAULT_BUDGET_MS
+void FrameGovernorInit(FrameGovernor *governor, double budgetMs);
+
+// 以下三项返回 1 表示档位因此改变
+int FrameGovernorSetPower(FrameGovernor *governor, int onBattery, int batterySaver);
+int FrameGovernorSetOccluded(FrameGovernor *governor, int occluded);
+int FrameGovernorRecordFrame(FrameGovernor *governor, double costMs);
+
+unsigned int FrameTierFps(FrameTier tier);
+uint32_t FrameTierIntervalMs(FrameTier tier);
+
+// 滚动帧间隔：不短于当前档位，也不短于文本移动一个像素所需的时间（更快只会重复同一帧）
+// 例如 40 像素/秒时不短于 25 ms，60 FPS 档位下滚动帧实际为 40 FPS
+uint32_t FrameGovernorMarqueeIntervalMs(const FrameGovernor *governor, unsigned int pixelsPerSecond);
+
+#endif // FRAME_GOVERNOR_H
@@ -0,0 +1,132 @@
+#include "frame_scheduler.h"
+#include <string.h>
+
+// 定时器可能比截止时间略早触发，这一范围内视为已到期，避免紧接着的空唤醒
+#define FRAME_SCHEDULER_SLACK_MS 2
+
+void FrameSchedulerInit(FrameScheduler *scheduler, const FrameClock *clock,
+                        uint32_t animationIntervalMs, uint32_t marqueeIntervalMs) {
+    if (!scheduler || !clock || !clock->now) return;
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->clock = *clock;
+    scheduler->animationIntervalMs = animationIntervalMs ? animationIntervalMs : 1;
+    scheduler->marqueeIntervalMs = marqueeIntervalMs ? marqueeIntervalMs : 1;
+}
+
+uint64_t FrameSchedulerNow(const FrameScheduler *scheduler) {
+    return scheduler->clock.now(scheduler->clock.user);
+}
+
+void FrameSchedulerSetIntervals(FrameScheduler *scheduler, uint32_t animationIntervalMs, uint32_t marqueeIntervalMs) {
+    scheduler->animationIntervalMs = animationIntervalMs ? animationIntervalMs : 1;
+    scheduler->marqueeIntervalMs = marqueeIntervalMs ? marqueeIntervalMs : 1;
+    uint64_t now = FrameSchedulerNow(scheduler);
+    if (scheduler->animating && scheduler->nextAnimationMs > now + scheduler->animationIntervalMs) {
+        scheduler->nextAnimationMs = now + scheduler->animationIntervalMs;
+    }
+    if (scheduler->marqueeActive && scheduler->nextMarqueeMs > now + scheduler->marqueeIntervalMs) {
+        scheduler->nextMarqueeMs = now + scheduler->marqueeIntervalMs;
+    }
+}
+
+void FrameSchedulerStartAnimation(FrameScheduler *scheduler) {
+    scheduler->animating = 1;
+    scheduler->nextAnimationMs = FrameSchedulerNow(scheduler);
+}
+
+void FrameSchedulerStopAnimation(FrameScheduler *scheduler) {
+    if (!scheduler->animating) return;
+    scheduler->animating = 0;
+    // 动画结束后滚动从一个完整间隔之后继续
+    scheduler->nextMarqueeMs = FrameSchedulerNow(scheduler) + scheduler->marqueeIntervalMs;
+}
+
+void FrameSchedulerSetMarquee(FrameScheduler *scheduler, int active) {
+    if (active && !scheduler->marqueeActive) {
+        scheduler->nextMarqueeMs = FrameSchedulerNow(scheduler) + scheduler->marqueeIntervalMs;
+    }
+    scheduler->marqueeActive = active ? 1 : 0;
+}
+
+void FrameSchedulerSetContentDelay(FrameScheduler *scheduler, int64_t delayMs) {
+    if (delayMs < 0) {
+        scheduler->hasContentDeadline = 0;
+        return;
+    }
+    scheduler->hasContentDeadline = 1;
+    scheduler->contentDeadlineMs = FrameSchedulerNow(scheduler) + (uint64_t)delayMs;
+}
+
+int FrameSchedulerInvalidate(FrameScheduler *scheduler, FrameInvalidateReason reason) {
+    if ((unsigned int)reason >= FRAME_INVALIDATE_REASON_COUNT) return 0;
+    int first = (scheduler->invalidated == 0);
+    scheduler->invalidated |= 1u << reason;
+    scheduler->stats.invalidations[reason]++;
+    return first;
+}
+
+unsigned int FrameSchedulerTakeInvalidations(FrameScheduler *scheduler) {
+    unsigned int reasons = scheduler->invalidated;
+    scheduler->invalidated = 0;
+    if (reasons) {
+        scheduler->stats.invalidatedFrames++;
+    }
+    return reasons;
+}
+
+static void ConsiderDeadline(uint64_t deadline, int *found, uint64_t *earliest) {
+    if (!*found || deadline < *earliest) {
+        *earliest = deadline;
+        *found = 1;
+    }
+}
+
+int64_t FrameSchedulerNextDelay(const FrameScheduler *scheduler) {
+    int found = 0;
+    uint64_t earliest = 0;
+    if (scheduler->animating) {
+        ConsiderDeadline(scheduler->nextAnimationMs, &found, &earliest);
+    } else if (scheduler->marqueeActive) {
+        ConsiderDeadline(scheduler->nextMarqueeMs, &found, &earliest);
+    }
+    if (scheduler->hasContentDeadline) {
+        ConsiderDeadline(scheduler->contentDeadlineMs, &found, &earliest);
+    }
+    if (!found) return FRAME_SCHEDULER_NO_DEADLINE;
+
+    uint64_t now = FrameSchedulerNow(scheduler);
+    return (earliest > now) ? (int64_t)(earliest - now) : 0;
+}
+
+// 下一次截止时间：按固定间隔推进；落后超过一个间隔时从现在重新计时，不补帧
+static uint64_t Advance(uint64_t deadline, uint32_t interval, uint64_t now) {
+    deadline += interval;
+    return (deadline + FRAME_SCHEDULER_SLACK_MS <= now) ? now + interval : deadline;
+}
+
+unsigned int FrameSchedulerDispatch(FrameScheduler *scheduler) {
+    uint64_t now = FrameSchedulerNow(scheduler);
+    uint64_t due = now + FRAME_SCHEDULER_SLACK_MS;
+    unsigned int reasons = FRAME_WAKE_NONE;
+    scheduler->stats.wakeups++;
+
+    if (scheduler->animating && scheduler->nextAnimationMs <= due) {
+        reasons |= FRAME_WAKE_ANIMATION;
+        scheduler->nextAnimationMs = Advance(scheduler->nextAnimationMs, scheduler->animationIntervalMs, now);
+        scheduler->stats.animationFrames++;
+    } else if (!scheduler->animating && scheduler->marqueeActive && scheduler->nextMarqueeMs <= due) {
+        reasons |= FRAME_WAKE_MARQUEE;
+        scheduler->nextMarqueeMs = Advance(scheduler->nextMarqueeMs, scheduler->marqueeIntervalMs, now);
+        scheduler->stats.marqueeFrames++;
+    }
+    if (scheduler->hasContentDeadline && scheduler->contentDeadlineMs <= due) {
+        reasons |= FRAME_WAKE_CONTENT;
+        scheduler->hasContentDeadline = 0;
+        scheduler->stats.contentFrames++;
+    }
+
+    if (reasons == FRAME_WAKE_NONE) {
+        scheduler->stats.idleWakeups++;
+    }
+    return reasons;
+}
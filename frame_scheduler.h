@@ -0,0 +1,99 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <stdint.h>
+
+// 帧调度：根据动画帧、滚动帧与下一次内容变化计算最近的截止时间，只设置一个定时器
+// 完整重绘的请求按原因记录并合并，每个帧截止时间最多重绘一次
+// 时钟可替换（Windows 上为 QPC，测试中可用手动推进的虚拟时钟），本模块不依赖 Win32
+
+#define FRAME_SCHEDULER_NO_DEADLINE  (-1)
+
+typedef enum {
+    FRAME_WAKE_NONE      = 0,
+    FRAME_WAKE_ANIMATION = 1 << 0,   // 窗口缩放动画的下一帧
+    FRAME_WAKE_MARQUEE   = 1 << 1,   // 溢出文本的下一滚动帧
+    FRAME_WAKE_CONTENT   = 1 << 2    // 内容变化（节次切换、跨天）需要完整重绘
+} FrameWakeReason;
+
+// 请求完整重绘的原因；同一帧截止时间之前的多次请求合并为一次重绘，按原因分别计数
+typedef enum {
+    FRAME_INVALIDATE_CREATE = 0,    // 窗口创建后的首帧
+    FRAME_INVALIDATE_SIZE,          // WM_SIZE（含动画中 SetWindowPos 引起的）
+    FRAME_INVALIDATE_PAINT,         // WM_PAINT
+    FRAME_INVALIDATE_ANIMATION,     // 缩放动画的一帧
+    FRAME_INVALIDATE_CONTENT,       // 节次切换、跨天
+    FRAME_INVALIDATE_SETTINGS,      // HUD 等显示设置变化
+    FRAME_INVALIDATE_REASON_COUNT
+} FrameInvalidateReason;
+
+// 返回单调时间（毫秒）
+typedef struct {
+    uint64_t (*now)(void *user);
+    void *user;
+} FrameClock;
+
+typedef struct {
+    unsigned long long wakeups;        // Dispatch 调用次数
+    unsigned long long idleWakeups;    // 唤醒时没有到期的工作
+    unsigned long long animationFrames;
+    unsigned long long marqueeFrames;
+    unsigned long long contentFrames;
+    unsigned long long invalidations[FRAME_INVALIDATE_REASON_COUNT];  // 各原因的重绘请求数
+    unsigned long long invalidatedFrames;  // 合并后实际发出的完整重绘数；请求总数与之的比即渲染放大倍数
+} FrameSchedulerStats;
+
+typedef struct {
+    FrameClock clock;
+    uint32_t animationIntervalMs;
+    uint32_t marqueeIntervalMs;
+
+    int animating;
+    uint64_t nextAnimationMs;
+    int marqueeActive;
+    uint64_t nextMarqueeMs;
+    int hasContentDeadline;
+    uint64_t contentDeadlineMs;
+    unsigned int invalidated;       // 尚未处理的重绘请求，按 1 << FrameInvalidateReason 置位
+
+    FrameSchedulerStats stats;
+} FrameScheduler;
+
+void FrameSchedulerInit(FrameScheduler *scheduler, const FrameClock *clock,
+                        uint32_t animationIntervalMs, uint32_t marqueeIntervalMs);
+
+uint64_t FrameSchedulerNow(const FrameScheduler *scheduler);
+
+// 调整动画与滚动帧间隔（帧率档位变化时）；已排定的下一帧不晚于一个新间隔
+void FrameSchedulerSetIntervals(FrameScheduler *scheduler, uint32_t animationIntervalMs, uint32_t marqueeIntervalMs);
+
+// 动画开始后立即到期一帧，之后每 animationIntervalMs 一帧，直到 Stop
+void FrameSchedulerStartAnimation(FrameScheduler *scheduler);
+void FrameSchedulerStopAnimation(FrameScheduler *scheduler);
+
+// 有溢出文本时开启滚动帧（动画期间暂停，动画帧本身会完整重绘）
+void FrameSchedulerSetMarquee(FrameScheduler *scheduler, int active);
+
+// 下一次内容变化的时间（相对现在的毫秒数）；delayMs < 0 表示没有
+void FrameSchedulerSetContentDelay(FrameScheduler *scheduler, int64_t delayMs);
+
+// 距最近截止时间的毫秒数；FRAME_SCHEDULER_NO_DEADLINE 表示无需唤醒
+int64_t FrameSchedulerNextDelay(const FrameScheduler *scheduler);
+
+// 唤醒时调用：返回已到期的工作（FrameWakeReason 的组合），并推进对应的下一次截止时间
+// 内容截止到期后即清除，由调用方在重绘后重新设置
+unsigned int FrameSchedulerDispatch(FrameScheduler *scheduler);
+
+// 请求完整重绘：只记录原因，在下一次帧截止时间由 FrameSchedulerTakeInvalidations 一并取出
+// 返回 1 表示这是尚未处理的第一个请求，调用方需确保很快唤醒（动画期间由下一动画帧处理，无需另外唤醒）
+int FrameSchedulerInvalidate(FrameScheduler *scheduler, FrameInvalidateReason reason);
+
+// 取出并清除尚未处理的重绘请求（1 << FrameInvalidateReason 的组合）；非 0 时调用方完整重绘一次
+unsigned int FrameSchedulerTakeInvalidations(FrameScheduler *scheduler);
+
+// 仅在动画期间需要提高系统定时器精度
+static inline int FrameSchedulerWantsHighResolution(const FrameScheduler *scheduler) {
+    return scheduler->animating;
+}
+
+#endif // FRAME_SCHEDULER_H
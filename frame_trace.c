@@ -0,0 +1,181 @@
+#include "frame_trace.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_TRACE_MASK     (FRAME_TRACE_CAPACITY - 1)
+#define FPS_WINDOW_MS        1000.0
+#define TRACE_TID_UI         1
+#define TRACE_TID_RENDER     2
+
+// sequence 为写入时的序号 + 1，写入过程中为 0；读取前后序号一致才采用
+typedef struct {
+    atomic_uint sequence;
+    int stage;
+    double startMs;
+    double endMs;
+} TraceEvent;
+
+typedef struct {
+    int stage;
+    double startMs;
+    double endMs;
+} TraceSample;
+
+atomic_int g_frameTraceEnabled = 0;
+FrameTraceClock g_frameTraceClock = NULL;
+
+static TraceEvent g_events[FRAME_TRACE_CAPACITY];
+static atomic_uint g_head = 0;
+
+static const char *const g_stageNames[FRAME_STAGE_COUNT] = {
+    "frame", "clear", "text", "composite", "static", "marquee", "present"
+};
+
+const char *FrameTraceStageName(FrameStage stage) {
+    return (stage >= 0 && stage < FRAME_STAGE_COUNT) ? g_stageNames[stage] : "?";
+}
+
+void FrameTraceEnable(FrameTraceClock clock) {
+    if (!clock) return;
+    atomic_store(&g_frameTraceEnabled, 0);
+    for (int i = 0; i < FRAME_TRACE_CAPACITY; ++i) {
+        atomic_store_explicit(&g_events[i].sequence, 0, memory_order_relaxed);
+    }
+    atomic_store(&g_head, 0);
+    g_frameTraceClock = clock;
+    atomic_store_explicit(&g_frameTraceEnabled, 1, memory_order_release);
+}
+
+void FrameTraceDisable(void) {
+    atomic_store(&g_frameTraceEnabled, 0);
+}
+
+void FrameTraceRecord(FrameStage stage, double startMs, double endMs) {
+    unsigned int index = atomic_fetch_add_explicit(&g_head, 1, memory_order_relaxed);
+    TraceEvent *event = &g_events[index & FRAME_TRACE_MASK];
+    atomic_store_explicit(&event->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    event->stage = (int)stage;
+    event->startMs = startMs;
+    event->endMs = endMs;
+    atomic_store_explicit(&event->sequence, index + 1, memory_order_release);
+}
+
+// 复制缓冲中完整写入的事件，返回个数
+static int SnapshotEvents(TraceSample *out) {
+    int count = 0;
+    for (int i = 0; i < FRAME_TRACE_CAPACITY; ++i) {
+        TraceEvent *event = &g_events[i];
+        unsigned int before = atomic_load_explicit(&event->sequence, memory_order_acquire);
+        if (!before) continue;
+        TraceSample sample = {event->stage, event->startMs, event->endMs};
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&event->sequence, memory_order_relaxed) != before) continue;
+        if (sample.stage < 0 || sample.stage >= FRAME_STAGE_COUNT) continue;
+        out[count++] = sample;
+    }
+    return count;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 最近秩分位数
+static double Percentile(const double *sorted, int count, double q) {
+    int rank = (int)ceil(q * count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+void FrameTraceSummarize(FrameTraceSummary *summary) {
+    if (!summary) return;
+    memset(summary, 0, sizeof(*summary));
+
+    TraceSample *samples = (TraceSample*)malloc(sizeof(TraceSample) * FRAME_TRACE_CAPACITY);
+    double *durations = (double*)malloc(sizeof(double) * FRAME_TRACE_CAPACITY);
+    if (!samples || !durations) {
+        free(samples);
+        free(durations);
+        return;
+    }
+    int count = SnapshotEvents(samples);
+
+    double latestMs = 0.0;
+    for (int i = 0; i < count; ++i) {
+        if (samples[i].endMs > latestMs) latestMs = samples[i].endMs;
+    }
+
+    for (int stage = 0; stage < FRAME_STAGE_COUNT; ++stage) {
+        int n = 0;
+        for (int i = 0; i < count; ++i) {
+            if (samples[i].stage == stage) {
+                durations[n++] = samples[i].endMs - samples[i].startMs;
+            }
+        }
+        summary->samples[stage] = n;
+        if (n == 0) continue;
+        qsort(durations, (size_t)n, sizeof(double), CompareDouble);
+        summary->p50Ms[stage] = Percentile(durations, n, 0.50);
+        summary->p99Ms[stage] = Percentile(durations, n, 0.99);
+    }
+
+    // 窗口程序按提交计帧率；无头渲染没有提交阶段，按渲染帧计
+    int rateStage = summary->samples[FRAME_STAGE_PRESENT] ? FRAME_STAGE_PRESENT : FRAME_STAGE_FRAME;
+    int recent = 0;
+    for (int i = 0; i < count; ++i) {
+        if (samples[i].stage == rateStage && samples[i].endMs > latestMs - FPS_WINDOW_MS) {
+            recent++;
+        }
+    }
+    summary->framesPerSecond = recent * (1000.0 / FPS_WINDOW_MS);
+
+    free(samples);
+    free(durations);
+}
+
+int FrameTraceFormatHud(const FrameTraceSummary *summary, TTCHAR *out, int capacity) {
+    if (!summary || !out || capacity <= 0) return 0;
+    char text[512];
+    int used = snprintf(text, sizeof(text), "%.1f fps", summary->framesPerSecond);
+    for (int stage = 0; stage < FRAME_STAGE_COUNT && used < (int)sizeof(text); ++stage) {
+        if (!summary->samples[stage]) continue;
+        used += snprintf(text + used, sizeof(text) - (size_t)used, "\n%s p50 %.2f p99 %.2f ms",
+                         g_stageNames[stage], summary->p50Ms[stage], summary->p99Ms[stage]);
+    }
+
+    // 只有 ASCII，逐字节扩展为 TTCHAR
+    int length = 0;
+    for (const char *p = text; *p && length < capacity - 1; ++p) {
+        out[length++] = (TTCHAR)(unsigned char)*p;
+    }
+    out[length] = 0;
+    return length;
+}
+
+int FrameTraceWriteChrome(FILE *file) {
+    if (!file) return 0;
+    TraceSample *samples = (TraceSample*)malloc(sizeof(TraceSample) * FRAME_TRACE_CAPACITY);
+    if (!samples) return 0;
+    int count = SnapshotEvents(samples);
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"ui\"}},\n",
+            TRACE_TID_UI);
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"render\"}}",
+            TRACE_TID_RENDER);
+    // 时间单位为微秒
+    for (int i = 0; i < count; ++i) {
+        const TraceSample *s = &samples[i];
+        fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                g_stageNames[s->stage], s->startMs * 1000.0, (s->endMs - s->startMs) * 1000.0,
+                s->stage == FRAME_STAGE_PRESENT ? TRACE_TID_UI : TRACE_TID_RENDER);
+    }
+    fprintf(file, "\n]}\n");
+    free(samples);
+    return ferror(file) ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#ifndef FRAME_TRACE_H
+#define FRAME_TRACE_H
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include "timetable_data.h"
+
+// 帧阶段计时：各阶段的起止时间写入固定大小的环形缓冲，供 HUD 统计与导出 Chrome trace
+// 关闭时每个计时点只是一次标志判断；时钟由调用方提供（窗口程序为 QPC 的 GetClockMs），本模块不依赖 Win32
+// 渲染线程与 UI 线程可同时写入
+
+#define FRAME_TRACE_CAPACITY 2048   // 环形缓冲事件数，须为 2 的幂
+
+typedef enum {
+    FRAME_STAGE_FRAME = 0,  // 渲染线程处理一次请求的总耗时
+    FRAME_STAGE_CLEAR,      // 清空文本覆盖度层
+    FRAME_STAGE_TEXT,       // 布局与文本（DrawTimetable）
+    FRAME_STAGE_COMPOSITE,  // 背景填充与圆角遮罩（同一遍合成）
+    FRAME_STAGE_STATIC,     // 复制预先合成的静态层
+    FRAME_STAGE_MARQUEE,    // 滚动帧的局部重绘
+    FRAME_STAGE_PRESENT,    // UpdateLayeredWindow（UI 线程）
+    FRAME_STAGE_COUNT
+} FrameStage;
+
+typedef double (*FrameTraceClock)(void);   // 单调时间（毫秒）
+
+typedef struct {
+    int samples[FRAME_STAGE_COUNT];     // 环形缓冲中该阶段的事件数
+    double p50Ms[FRAME_STAGE_COUNT];
+    double p99Ms[FRAME_STAGE_COUNT];
+    double framesPerSecond;             // 最近一秒内提交的帧数（无提交时按渲染帧计）
+} FrameTraceSummary;
+
+extern atomic_int g_frameTraceEnabled;
+extern FrameTraceClock g_frameTraceClock;
+
+// 开始记录并清空缓冲
+void FrameTraceEnable(FrameTraceClock clock);
+void FrameTraceDisable(void);
+
+void FrameTraceRecord(FrameStage stage, double startMs, double endMs);
+
+static inline int FrameTraceEnabled(void) {
+    return atomic_load_explicit(&g_frameTraceEnabled, memory_order_acquire);
+}
+
+// 计时点：FrameTraceBegin 取起点，FrameTraceEnd 记录 [起点, 现在)
+static inline double FrameTraceBegin(void) {
+    return FrameTraceEnabled() ? g_frameTraceClock() : 0.0;
+}
+
+static inline void FrameTraceEnd(FrameStage stage, double startMs) {
+    if (FrameTraceEnabled()) {
+        FrameTraceRecord(stage, startMs, g_frameTraceClock());
+    }
+}
+
+const char *FrameTraceStageName(FrameStage stage);
+
+// 按缓冲中现有事件统计各阶段 p50/p99 与帧率
+void FrameTraceSummarize(FrameTraceSummary *summary);
+
+// HUD 文本：每行一项，以 '\n' 分隔并以 0 结尾；返回写入的字符数（不含结尾 0）
+int FrameTraceFormatHud(const FrameTraceSummary *summary, TTCHAR *out, int capacity);
+
+// 以 Chrome trace 事件格式（chrome://tracing、Perfetto 可读）写出缓冲中的事件；成功返回 1
+int FrameTraceWriteChrome(FILE *file);
+
+#endif // FRAME_TRACE_H
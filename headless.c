@@ -0,0 +1,224 @@
+// 无头渲染驱动：用软件文本后端渲染一帧，输出 PAM 图像与像素校验和
+// Linux: gcc -O2 headless.c render_core.c render_soft.c schedule.c schedule_index.c arena.c text_cache.c corner_tiles.c pixel_kernels.c frame_trace.c timetable_data.c -o timetable_headless -lm
+//
+// 用法: timetable_headless [--view day|week] [--today DAY] [--dpi N] [--size WxH]
+//                          [--time MS] [--minute M] [--isa scalar|sse2|avx2] [--schedule FILE.ttb]
+//                          [--out FILE.pam] [--expect HASH] [--hud] [--trace FILE.json]
+//                          [--background TOP,BOTTOM[,GRID,ALPHA]]
+// --today 为星期（0 为周一），须小于课程表的天数
+// --minute 为当天第几分钟（如 8:30 为 510），用于突出当前节次；--expect 给出黄金校验和时，结果不一致返回 1
+// --hud 在左上角叠加各阶段耗时（输出随机器变化，不可与黄金校验和比对）；--trace 写出 Chrome trace
+// --background 使用渐变底色（十六进制 RRGGBB）与网格线（颜色与 0-255 的混合比例），如 102040,000000,ffffff,40
+
+#include "render_core.h"
+#include "render_soft.h"
+#include "pixel_kernels.h"
+#include "frame_trace.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double MonotonicMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+// FNV-1a 64，按 BGRA 字节顺序计算，与主机字节序无关
+static uint64_t SurfaceChecksum(const RenderSurface *surface) {
+    uint64_t h = 14695981039346656037ull;
+    size_t count = (size_t)surface->width * surface->height;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = surface->pixels[i];
+        for (int b = 0; b < 4; ++b) {
+            h = (h ^ ((p >> (8 * b)) & 0xFF)) * 1099511628211ull;
+        }
+    }
+    return h;
+}
+
+// PAM (RGB_ALPHA)，像素按预乘值原样输出，便于逐字节比对
+static int WritePam(const char *path, const RenderSurface *surface) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return 0;
+    fprintf(f, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n",
+            surface->width, surface->height);
+    size_t count = (size_t)surface->width * surface->height;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t p = surface->pixels[i];
+        unsigned char rgba[4] = {
+            (unsigned char)(p >> 16), (unsigned char)(p >> 8), (unsigned char)p, (unsigned char)(p >> 24)
+        };
+        fwrite(rgba, 1, 4, f);
+    }
+    return fclose(f) == 0;
+}
+
+static void PrintUsage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--view day|week] [--today DAY] [--dpi N] [--size WxH] [--time MS] [--minute M]\n"
+            "          [--isa scalar|sse2|avx2] [--schedule FILE.ttb] [--out FILE.pam] [--expect HASH]\n"
+            "          [--hud] [--trace FILE.json] [--background TOP,BOTTOM[,GRID,ALPHA]]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    RenderFrameParams params = {0};
+    params.viewMode = 1;
+    params.today = 0;
+    params.dpi = 96;
+    params.timeMs = 0;
+    params.minuteOfDay = -1;
+    int width = 420;
+    int height = 360;
+    const char *outPath = NULL;
+    const char *expect = NULL;
+    const char *schedulePath = NULL;
+    const char *tracePath = NULL;
+    int hud = 0;
+    RenderBackground background = {0};
+    int hasBackground = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--hud") == 0) {
+            hud = 1;
+            continue;
+        }
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!value) {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        if (strcmp(arg, "--view") == 0) {
+            params.viewMode = (strcmp(value, "day") == 0) ? 0 : 1;
+        } else if (strcmp(arg, "--today") == 0) {
+            params.today = atoi(value);
+        } else if (strcmp(arg, "--dpi") == 0) {
+            params.dpi = (unsigned int)atoi(value);
+        } else if (strcmp(arg, "--size") == 0) {
+            if (sscanf(value, "%dx%d", &width, &height) != 2) {
+                PrintUsage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(arg, "--time") == 0) {
+            params.timeMs = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "--minute") == 0) {
+            params.minuteOfDay = atoi(value);
+        } else if (strcmp(arg, "--isa") == 0) {
+            PixelIsa isa = PIXEL_ISA_AVX2;
+            if (strcmp(value, "scalar") == 0) isa = PIXEL_ISA_SCALAR;
+            else if (strcmp(value, "sse2") == 0) isa = PIXEL_ISA_SSE2;
+            PixelKernelsForceIsa(isa);
+        } else if (strcmp(arg, "--schedule") == 0) {
+            schedulePath = value;
+        } else if (strcmp(arg, "--out") == 0) {
+            outPath = value;
+        } else if (strcmp(arg, "--expect") == 0) {
+            expect = value;
+        } else if (strcmp(arg, "--trace") == 0) {
+            tracePath = value;
+        } else if (strcmp(arg, "--background") == 0) {
+            unsigned int top = 0, bottom = 0, grid = 0, alpha = 0;
+            int fields = sscanf(value, "%x,%x,%x,%u", &top, &bottom, &grid, &alpha);
+            if (fields != 2 && fields != 4) {
+                PrintUsage(argv[0]);
+                return 2;
+            }
+            background.topRgb = top & 0xFFFFFF;
+            background.bottomRgb = bottom & 0xFFFFFF;
+            background.gridRgb = grid & 0xFFFFFF;
+            background.gridAlpha = (uint8_t)(alpha > 255 ? 255 : alpha);
+            hasBackground = 1;
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    if (width <= 0 || height <= 0 || params.dpi == 0 || params.today < 0) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    Schedule schedule;
+    int loaded = schedulePath ? ScheduleMapFile(schedulePath, &schedule) : ScheduleFromBuiltin(&schedule);
+    if (!loaded) {
+        fprintf(stderr, "cannot load schedule %s\n", schedulePath ? schedulePath : "(builtin)");
+        return 1;
+    }
+    // 天数随课程表而定，加载后才能检查 --today
+    if (params.today >= schedule.days) {
+        fprintf(stderr, "--today %d out of range: schedule has %d days\n", params.today, schedule.days);
+        ScheduleClose(&schedule);
+        return 2;
+    }
+
+    TextBackend backend;
+    RenderSoftTextBackend(&backend);
+    RenderCore *core = RenderCoreCreate(&backend);
+    RenderSurface surface;
+    if (!core || !RenderSoftSurfaceCreate(&surface, width, height)) {
+        fprintf(stderr, "out of memory\n");
+        RenderCoreDestroy(core);
+        ScheduleClose(&schedule);
+        return 1;
+    }
+    RenderCoreSetSchedule(core, &schedule);
+    if (hasBackground) {
+        RenderCoreSetBackground(core, &background);
+    }
+
+    if (hud || tracePath) {
+        FrameTraceEnable(MonotonicMs);
+    }
+
+    // 先以时间 0 渲染确定滚动起点，再按 --time 渲染，与窗口中的滚动相位一致
+    uint64_t timeMs = params.timeMs;
+    params.timeMs = 0;
+    RenderCoreDrawFrame(core, &surface, &params);
+    if (timeMs != 0) {
+        params.timeMs = timeMs;
+        RenderCoreDrawFrame(core, &surface, &params);
+    }
+    // HUD 显示此前各帧的统计，叠加后再渲染一次
+    TTCHAR hudText[512];
+    if (hud) {
+        FrameTraceSummary summary;
+        FrameTraceSummarize(&summary);
+        FrameTraceFormatHud(&summary, hudText, (int)(sizeof(hudText) / sizeof(hudText[0])));
+        params.overlayText = hudText;
+        RenderCoreDrawFrame(core, &surface, &params);
+    }
+
+    uint64_t checksum = SurfaceChecksum(&surface);
+    printf("%016" PRIx64 "  %dx%d view=%s today=%d dpi=%u time=%" PRIu64 " isa=%s\n",
+           checksum, width, height, params.viewMode == 0 ? "day" : "week", params.today,
+           params.dpi, timeMs, PixelKernelsIsaName(PixelKernelsIsa()));
+
+    int status = 0;
+    if (outPath && !WritePam(outPath, &surface)) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        status = 1;
+    }
+    if (tracePath) {
+        FILE *traceFile = fopen(tracePath, "w");
+        int written = traceFile && FrameTraceWriteChrome(traceFile);
+        if (traceFile && fclose(traceFile) != 0) written = 0;
+        if (!written) {
+            fprintf(stderr, "cannot write %s\n", tracePath);
+            status = 1;
+        }
+    }
+    if (expect && strtoull(expect, NULL, 16) != checksum) {
+        fprintf(stderr, "checksum mismatch: expected %s\n", expect);
+        status = 1;
+    }
+
+    RenderSoftSurfaceFree(&surface);
+    RenderCoreDestroy(core);
+    ScheduleClose(&schedule);
+    return status;
+}
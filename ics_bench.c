@@ -0,0 +1,256 @@
+// iCalendar 导入基准：生成合成的整学期日历导出，测量流式解析与重复展开的吞吐，并与直接读文件比较
+// Linux: gcc -O2 ics_bench.c ics_import.c schedule_index.c schedule.c arena.c timetable_data.c -o ics_bench
+//
+// 用法: ics_bench [--events N] [--min-ms N] [--out FILE.ics]
+// 每个用例一行 CSV：case,events,bytes,iterations,ms_per_pass,mb_per_second,events_per_second,occurrences
+// memory 为从内存解析，file 为经 stdio 读文件解析，read 为只读文件不解析（同一文件、页缓存已热），
+// 二者之比即解析相对磁盘读取的开销；--out 只写出合成日历（可交给 schedule_convert）后退出
+
+#include "ics_import.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define BENCH_COURSES 24
+
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+} TextBuffer;
+
+static double g_minMs = 300.0;
+
+static double NowMs(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq = {0};
+    if (!freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+static int Append(TextBuffer *buffer, const char *text, size_t length) {
+    if (buffer->size + length > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 1 << 20;
+        while (capacity < buffer->size + length) capacity *= 2;
+        char *grown = (char*)realloc(buffer->data, capacity);
+        if (!grown) return 0;
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, text, length);
+    buffer->size += length;
+    return 1;
+}
+
+// 按 RFC 5545 每 75 字节折行
+static int AppendLine(TextBuffer *buffer, const char *line) {
+    size_t length = strlen(line);
+    size_t offset = 0;
+    int ok = 1;
+    while (ok && length - offset > 75) {
+        ok = Append(buffer, line + offset, 75) && Append(buffer, "\r\n ", 3);
+        offset += 75;
+    }
+    return ok && Append(buffer, line + offset, length - offset) && Append(buffer, "\r\n", 2);
+}
+
+static void FormatDate(int32_t days, char *out) {
+    // 自 1970-01-01 起的天数 -> YYYYMMDD
+    int32_t z = days + 719468;
+    int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int32_t dayOfEra = z - era * 146097;
+    int32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int32_t mp = (5 * dayOfYear + 2) / 153;
+    int day = (int)(dayOfYear - (153 * mp + 2) / 5 + 1);
+    int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    int year = (int)(yearOfEra + era * 400 + (month <= 2));
+    sprintf(out, "%04d%02d%02d", year, month, day);
+}
+
+// 合成整学期导出：大部分是逐次展开的单次事件（教务系统常见的导出方式），
+// 每 10 个事件中有 1 个是带 EXDATE 的每周重复；附带 DTSTAMP、UID、较长的 DESCRIPTION 与提醒
+static int BuildFeed(TextBuffer *feed, int events) {
+    static const char *const names[BENCH_COURSES] = {
+        "高等数学", "线性代数", "大学英语", "大学物理", "程序设计基础", "数据结构", "离散数学", "概率论与数理统计",
+        "体育", "思想道德与法治", "中国近现代史纲要", "大学物理实验", "计算机组成原理", "操作系统", "计算机网络",
+        "数据库系统", "编译原理", "软件工程", "人工智能导论", "机器学习", "数字电路", "信号与系统", "形势与政策",
+        "Academic Writing"
+    };
+    int periodCount = 0;
+    const PeriodTime *periods = ScheduleDefaultPeriods(&periodCount);
+    int32_t semesterStart = 0;
+    IcsParseDate("2024-09-02", &semesterStart);
+
+    int ok = AppendLine(feed, "BEGIN:VCALENDAR") && AppendLine(feed, "VERSION:2.0") &&
+             AppendLine(feed, "PRODID:-//Timetable//Synthetic Feed//ZH") &&
+             AppendLine(feed, "X-WR-TIMEZONE:Asia/Shanghai");
+    unsigned int seed = 12345;
+    char line[512];
+    char date[16];
+    for (int i = 0; ok && i < events; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int course = (int)((seed >> 16) % BENCH_COURSES);
+        int period = (int)((seed >> 8) % (unsigned int)periodCount);
+        int span = (period + 1 < periodCount && periods[period + 1].startMinute - periods[period].endMinute <= 10) ? 1 : 0;
+        int week = (int)((seed >> 4) % 18);
+        int weekday = (int)(seed % 5);
+        int start = periods[period].startMinute;
+        int end = periods[period + span].endMinute;
+        int recurring = (i % 10) == 0;
+
+        FormatDate(semesterStart + (recurring ? 0 : week * 7) + weekday, date);
+        ok = AppendLine(feed, "BEGIN:VEVENT");
+        snprintf(line, sizeof(line), "UID:%08d-%04x@timetable.example.edu.cn", i, seed & 0xFFFF);
+        ok = ok && AppendLine(feed, line) && AppendLine(feed, "DTSTAMP:20240820T080000Z");
+        snprintf(line, sizeof(line), "DTSTART;TZID=Asia/Shanghai:%sT%02d%02d00", date, start / 60, start % 60);
+        ok = ok && AppendLine(feed, line);
+        snprintf(line, sizeof(line), "DTEND;TZID=Asia/Shanghai:%sT%02d%02d00", date, end / 60, end % 60);
+        ok = ok && AppendLine(feed, line);
+        if (recurring) {
+            ok = ok && AppendLine(feed, "RRULE:FREQ=WEEKLY;UNTIL=20250112T155959Z;WKST=MO");
+            FormatDate(semesterStart + 7 * 7 + weekday, date);
+            snprintf(line, sizeof(line), "EXDATE;TZID=Asia/Shanghai:%sT%02d%02d00", date, start / 60, start % 60);
+            ok = ok && AppendLine(feed, line);
+        }
+        snprintf(line, sizeof(line), "SUMMARY:%s", names[course]);
+        ok = ok && AppendLine(feed, line);
+        snprintf(line, sizeof(line), "LOCATION:第%d教学楼%d%02d", course % 6 + 1, period % 5 + 1, (int)(seed % 40) + 1);
+        ok = ok && AppendLine(feed, line);
+        snprintf(line, sizeof(line),
+                 "DESCRIPTION:课程：%s\\n教师：张老师\\n学分：%d\\n周次：1-18周\\n备注：请携带教材与笔记本\\, 按时签到",
+                 names[course], course % 4 + 1);
+        ok = ok && AppendLine(feed, line) &&
+             AppendLine(feed, "BEGIN:VALARM") && AppendLine(feed, "ACTION:DISPLAY") &&
+             AppendLine(feed, "TRIGGER:-PT15M") && AppendLine(feed, "DESCRIPTION:上课提醒") &&
+             AppendLine(feed, "END:VALARM") && AppendLine(feed, "END:VEVENT");
+    }
+    return ok && AppendLine(feed, "END:VCALENDAR");
+}
+
+static int CountOccurrence(void *user, const IcsOccurrence *occurrence) {
+    (void)occurrence;
+    ++*(long*)user;
+    return 1;
+}
+
+static void Report(const char *name, int events, size_t bytes, long iterations, double elapsedMs, long occurrences) {
+    double perPass = iterations > 0 ? elapsedMs / iterations : 0.0;
+    double mbPerSecond = perPass > 0.0 ? bytes / 1048576.0 / (perPass / 1000.0) : 0.0;
+    double eventsPerSecond = perPass > 0.0 ? events / (perPass / 1000.0) : 0.0;
+    printf("%s,%d,%zu,%ld,%.3f,%.1f,%.0f,%ld\n", name, events, bytes, iterations, perPass, mbPerSecond,
+           eventsPerSecond, occurrences);
+    fflush(stdout);
+}
+
+static int ReadWholeFile(const char *path, char *buffer, size_t capacity) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    while (fread(buffer, 1, capacity, f) == capacity) {
+    }
+    fclose(f);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    int events = 50000;
+    const char *outPath = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            g_minMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--events N] [--min-ms N] [--out FILE.ics]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (events <= 0) events = 1;
+
+    TextBuffer feed = {0};
+    if (!BuildFeed(&feed, events)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    const char *filePath = outPath ? outPath : "ics_bench.tmp.ics";
+    FILE *f = fopen(filePath, "wb");
+    int written = f && fwrite(feed.data, 1, feed.size, f) == feed.size;
+    if (f && fclose(f) != 0) written = 0;
+    if (!written) {
+        fprintf(stderr, "cannot write %s\n", filePath);
+        free(feed.data);
+        return 1;
+    }
+    if (outPath) {
+        printf("%s: %d events, %zu bytes\n", outPath, events, feed.size);
+        free(feed.data);
+        return 0;
+    }
+
+    IcsImportOptions options = {0};
+    options.periods = ScheduleDefaultPeriods(&options.periodCount);
+    IcsImportStats stats;
+    printf("case,events,bytes,iterations,ms_per_pass,mb_per_second,events_per_second,occurrences\n");
+
+    long occurrences = 0;
+    long iterations = 0;
+    double start = NowMs();
+    double elapsed = 0.0;
+    int ok = 1;
+    do {
+        occurrences = 0;
+        ok = IcsImportMemory(feed.data, feed.size, &options, CountOccurrence, &occurrences, &stats);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (ok && elapsed < g_minMs);
+    Report("memory", events, feed.size, iterations, elapsed, occurrences);
+
+    iterations = 0;
+    start = NowMs();
+    do {
+        occurrences = 0;
+        FILE *in = fopen(filePath, "rb");
+        ok = in && IcsImportFile(in, &options, CountOccurrence, &occurrences, &stats);
+        if (in) fclose(in);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (ok && elapsed < g_minMs);
+    Report("file", events, feed.size, iterations, elapsed, occurrences);
+
+    // 同样以 64 KiB 分块读取，不解析
+    char *chunk = (char*)malloc(65536);
+    iterations = 0;
+    start = NowMs();
+    do {
+        ok = chunk && ReadWholeFile(filePath, chunk, 65536);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (ok && elapsed < g_minMs);
+    Report("read", events, feed.size, iterations, elapsed, 0);
+
+    free(chunk);
+    remove(filePath);
+    free(feed.data);
+    if (!ok) {
+        fprintf(stderr, "import failed near line %ld\n", stats.errorLine);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,612 @@
+#include "ics_import.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ICS_READ_CHUNK  65536
+#define ICS_NO_TIME     (-1)    // 只有日期（VALUE=DATE）
+
+typedef struct {
+    int32_t date;   // 自 1970-01-01 起的天数
+    int minute;     // 当天第几分钟，ICS_NO_TIME 表示只有日期
+} IcsTime;
+
+typedef enum {
+    ICS_FREQ_NONE = 0,
+    ICS_FREQ_DAILY,
+    ICS_FREQ_WEEKLY,
+    ICS_FREQ_OTHER      // 其他频率只取首次
+} IcsFrequency;
+
+// 当前 VEVENT 的状态，大小固定
+typedef struct {
+    int nested;         // VEVENT 内嵌组件（如 VALARM）的层数，其属性忽略
+    int hasStart;
+    int hasEnd;
+    int hasDuration;
+    int cancelled;
+    int invalid;
+    IcsTime start;
+    IcsTime end;
+    int durationMinutes;
+    char summary[ICS_MAX_TEXT];
+    size_t summaryLength;
+    char location[ICS_MAX_TEXT];
+    size_t locationLength;
+
+    IcsFrequency frequency;
+    int interval;
+    unsigned int byDay;     // 第 d 位对应星期 d（0=周一）
+    int count;              // 0 表示不限
+    int hasUntil;
+    IcsTime until;
+    IcsTime exdates[ICS_MAX_EXDATES];
+    int exdateCount;
+} IcsEvent;
+
+typedef struct {
+    const IcsImportOptions *options;
+    IcsOccurrenceCallback callback;
+    void *user;
+    IcsImportStats *stats;
+    int inEvent;
+    int stop;
+    IcsEvent event;
+    char line[ICS_MAX_LINE];
+    char chunk[ICS_READ_CHUNK];
+} IcsParser;
+
+static char UpperAscii(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+// text[0, length) 与大写关键字 keyword 按 ASCII 忽略大小写比较
+static int KeywordIs(const char *text, size_t length, const char *keyword) {
+    size_t i = 0;
+    for (; i < length; ++i) {
+        if (!keyword[i] || UpperAscii(text[i]) != keyword[i]) return 0;
+    }
+    return keyword[i] == 0;
+}
+
+// 公历日期 -> 自 1970-01-01 起的天数
+static int32_t DaysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return (int32_t)era * 146097 + dayOfEra - 719468;
+}
+
+int IcsWeekday(int32_t days) {
+    // 1970-01-01 为周四
+    int weekday = (int)((days + 3) % 7);
+    return weekday < 0 ? weekday + 7 : weekday;
+}
+
+static int ParseDigits(const char *text, int count, int *value) {
+    int v = 0;
+    for (int i = 0; i < count; ++i) {
+        if (text[i] < '0' || text[i] > '9') return 0;
+        v = v * 10 + (text[i] - '0');
+    }
+    *value = v;
+    return 1;
+}
+
+static int ParseDateDigits(const char *text, int32_t *days) {
+    int year, month, day;
+    if (!ParseDigits(text, 4, &year) || !ParseDigits(text + 4, 2, &month) || !ParseDigits(text + 6, 2, &day) ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+    *days = DaysFromCivil(year, month, day);
+    return 1;
+}
+
+int IcsParseDate(const char *text, int32_t *days) {
+    if (!text || !days) return 0;
+    char digits[8];
+    int n = 0;
+    for (const char *p = text; *p; ++p) {
+        if (*p == '-') continue;
+        if (n == 8) return 0;
+        digits[n++] = *p;
+    }
+    return n == 8 && ParseDateDigits(digits, days);
+}
+
+// DATE（YYYYMMDD）或 DATE-TIME（YYYYMMDDTHHMMSS[Z]）；UTC 时间换算为本地时间
+static int ParseIcsTime(const char *text, size_t length, int utcOffsetMinutes, IcsTime *out) {
+    if (length < 8 || !ParseDateDigits(text, &out->date)) return 0;
+    if (length == 8) {
+        out->minute = ICS_NO_TIME;
+        return 1;
+    }
+    int hour, minute, second;
+    if (length < 15 || UpperAscii(text[8]) != 'T' || !ParseDigits(text + 9, 2, &hour) ||
+        !ParseDigits(text + 11, 2, &minute) || !ParseDigits(text + 13, 2, &second) || hour > 23 || minute > 59) {
+        return 0;
+    }
+    out->minute = hour * 60 + minute;
+    if (length > 15) {
+        if (length != 16 || UpperAscii(text[15]) != 'Z') return 0;
+        out->minute += utcOffsetMinutes;
+        while (out->minute < 0) {
+            out->minute += MINUTES_PER_DAY;
+            out->date--;
+        }
+        while (out->minute >= MINUTES_PER_DAY) {
+            out->minute -= MINUTES_PER_DAY;
+            out->date++;
+        }
+    }
+    return 1;
+}
+
+// [+-]P[nW][nD][T[nH][nM][nS]] -> 分钟（秒舍去）
+static int ParseDuration(const char *text, size_t length, int *minutes) {
+    size_t i = 0;
+    int sign = 1;
+    if (i < length && (text[i] == '+' || text[i] == '-')) {
+        if (text[i] == '-') sign = -1;
+        ++i;
+    }
+    if (i >= length || UpperAscii(text[i]) != 'P') return 0;
+    ++i;
+
+    long total = 0;
+    int inTime = 0;
+    int any = 0;
+    while (i < length) {
+        char c = UpperAscii(text[i]);
+        if (c == 'T') {
+            inTime = 1;
+            ++i;
+            continue;
+        }
+        long value = 0;
+        size_t digits = 0;
+        while (i < length && text[i] >= '0' && text[i] <= '9' && digits < 9) {
+            value = value * 10 + (text[i] - '0');
+            ++i;
+            ++digits;
+        }
+        if (digits == 0 || i >= length) return 0;
+        c = UpperAscii(text[i++]);
+        if (c == 'W' && !inTime) total += value * 7 * MINUTES_PER_DAY;
+        else if (c == 'D' && !inTime) total += value * MINUTES_PER_DAY;
+        else if (c == 'H' && inTime) total += value * 60;
+        else if (c == 'M' && inTime) total += value;
+        else if (c == 'S' && inTime) total += value / 60;
+        else return 0;
+        any = 1;
+    }
+    if (!any) return 0;
+    *minutes = (int)(sign * total);
+    return 1;
+}
+
+// TEXT 值去转义并截断到 capacity - 1 字节（不截断 UTF-8 多字节字符）；换行改为空格
+static size_t UnescapeText(const char *text, size_t length, char *out, size_t capacity, int *truncated) {
+    size_t n = 0;
+    for (size_t i = 0; i < length; ++i) {
+        char c = text[i];
+        if (c == '\\' && i + 1 < length) {
+            c = text[++i];
+            if (c == 'n' || c == 'N') c = ' ';
+        }
+        if (n + 1 >= capacity) {
+            *truncated = 1;
+            while (n > 0 && ((unsigned char)out[n - 1] & 0xC0) == 0x80) --n;
+            if (n > 0 && ((unsigned char)out[n - 1] & 0x80)) --n;
+            break;
+        }
+        out[n++] = c;
+    }
+    return n;
+}
+
+static int WeekdayFromCode(const char *text, size_t length) {
+    static const char *const codes[7] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+    // 月/年重复的序号前缀（如 +1MO、-1FR）不影响星期
+    while (length > 2 && (text[0] == '+' || text[0] == '-' || (text[0] >= '0' && text[0] <= '9'))) {
+        ++text;
+        --length;
+    }
+    for (int d = 0; d < 7; ++d) {
+        if (KeywordIs(text, length, codes[d])) return d;
+    }
+    return -1;
+}
+
+static void ParseRule(IcsParser *p, const char *value, size_t length) {
+    IcsEvent *e = &p->event;
+    size_t i = 0;
+    while (i < length) {
+        size_t partEnd = i;
+        while (partEnd < length && value[partEnd] != ';') ++partEnd;
+        size_t eq = i;
+        while (eq < partEnd && value[eq] != '=') ++eq;
+
+        const char *key = value + i;
+        size_t keyLength = eq - i;
+        const char *v = value + eq + 1;
+        size_t vLength = (eq < partEnd) ? partEnd - eq - 1 : 0;
+        if (KeywordIs(key, keyLength, "FREQ")) {
+            if (KeywordIs(v, vLength, "WEEKLY")) e->frequency = ICS_FREQ_WEEKLY;
+            else if (KeywordIs(v, vLength, "DAILY")) e->frequency = ICS_FREQ_DAILY;
+            else e->frequency = ICS_FREQ_OTHER;
+        } else if (KeywordIs(key, keyLength, "INTERVAL")) {
+            int interval = 0;
+            if (vLength > 0 && vLength < 6 && ParseDigits(v, (int)vLength, &interval) && interval > 0) {
+                e->interval = interval;
+            }
+        } else if (KeywordIs(key, keyLength, "COUNT")) {
+            int count = 0;
+            if (vLength > 0 && vLength < 7 && ParseDigits(v, (int)vLength, &count) && count > 0) {
+                e->count = count;
+            }
+        } else if (KeywordIs(key, keyLength, "UNTIL")) {
+            e->hasUntil = ParseIcsTime(v, vLength, p->options->utcOffsetMinutes, &e->until);
+        } else if (KeywordIs(key, keyLength, "BYDAY")) {
+            size_t j = 0;
+            while (j < vLength) {
+                size_t dayEnd = j;
+                while (dayEnd < vLength && v[dayEnd] != ',') ++dayEnd;
+                int weekday = WeekdayFromCode(v + j, dayEnd - j);
+                if (weekday >= 0) e->byDay |= 1u << weekday;
+                j = dayEnd + 1;
+            }
+        }
+        i = partEnd + 1;
+    }
+}
+
+static void AddExdates(IcsParser *p, const char *value, size_t length) {
+    IcsEvent *e = &p->event;
+    size_t i = 0;
+    while (i < length) {
+        size_t end = i;
+        while (end < length && value[end] != ',') ++end;
+        IcsTime t;
+        if (ParseIcsTime(value + i, end - i, p->options->utcOffsetMinutes, &t)) {
+            if (e->exdateCount < ICS_MAX_EXDATES) {
+                e->exdates[e->exdateCount++] = t;
+            } else {
+                p->stats->truncated++;
+            }
+        }
+        i = end + 1;
+    }
+}
+
+// 与 [startMinute, endMinute) 重叠的节次范围；没有时返回 0
+static int MapPeriods(const IcsImportOptions *options, int startMinute, int endMinute, int *first, int *last) {
+    if (endMinute <= startMinute) endMinute = startMinute + 1;   // 无时长的事件取开始时刻所在的节次
+    *first = -1;
+    for (int i = 0; i < options->periodCount; ++i) {
+        const PeriodTime *period = &options->periods[i];
+        if (period->startMinute < endMinute && startMinute < period->endMinute) {
+            if (*first < 0) *first = i;
+            *last = i;
+        }
+    }
+    return *first >= 0;
+}
+
+static int IsExcluded(const IcsEvent *e, int32_t date, int minute) {
+    for (int i = 0; i < e->exdateCount; ++i) {
+        if (e->exdates[i].date == date && (e->exdates[i].minute == ICS_NO_TIME || e->exdates[i].minute == minute)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int InDateRange(const IcsImportOptions *options, int32_t date) {
+    return options->firstDate >= options->lastDate || (date >= options->firstDate && date < options->lastDate);
+}
+
+// 一次上课：去掉 EXDATE 与日期范围外的，其余映射到网格后交给回调
+static void EmitOccurrence(IcsParser *p, int32_t date, int mapped, int firstSlot, int lastSlot) {
+    const IcsEvent *e = &p->event;
+    if (IsExcluded(e, date, e->start.minute) || !InDateRange(p->options, date)) return;
+    p->stats->occurrences++;
+    if (!mapped) {
+        p->stats->unmapped++;
+        return;
+    }
+
+    IcsOccurrence occurrence;
+    occurrence.day = IcsWeekday(date);
+    occurrence.firstSlot = firstSlot;
+    occurrence.lastSlot = lastSlot;
+    occurrence.date = date;
+    occurrence.summary = e->summary;
+    occurrence.summaryLength = e->summaryLength;
+    occurrence.location = e->location;
+    occurrence.locationLength = e->locationLength;
+    if (!p->callback(p->user, &occurrence)) {
+        p->stop = 1;
+    }
+}
+
+// 出现时间是否已超过 UNTIL（UNTIL 只有日期时包含当天）
+static int PastUntil(const IcsEvent *e, int32_t date) {
+    if (!e->hasUntil) return 0;
+    if (date != e->until.date) return date > e->until.date;
+    return e->until.minute != ICS_NO_TIME && e->start.minute > e->until.minute;
+}
+
+// END:VEVENT：按重复规则依次展开（日期递增），COUNT 按展开次数计、含被 EXDATE 排除的
+static void ExpandEvent(IcsParser *p) {
+    const IcsEvent *e = &p->event;
+    const IcsImportOptions *options = p->options;
+    p->stats->events++;
+    if (e->cancelled || e->invalid || !e->hasStart || e->start.minute == ICS_NO_TIME) {
+        p->stats->skipped++;
+        return;
+    }
+
+    int duration = 0;
+    if (e->hasEnd && e->end.minute != ICS_NO_TIME) {
+        duration = (int)(e->end.date - e->start.date) * MINUTES_PER_DAY + e->end.minute - e->start.minute;
+    } else if (e->hasDuration) {
+        duration = e->durationMinutes;
+    }
+    int endMinute = e->start.minute + duration;
+    if (endMinute > MINUTES_PER_DAY) endMinute = MINUTES_PER_DAY;
+    int firstSlot = 0;
+    int lastSlot = 0;
+    int mapped = MapPeriods(options, e->start.minute, endMinute, &firstSlot, &lastSlot);
+
+    int limit = e->count > 0 ? e->count : ICS_MAX_EXPANSION;
+    int ranged = options->firstDate < options->lastDate;
+    if (e->frequency == ICS_FREQ_NONE || e->frequency == ICS_FREQ_OTHER) {
+        EmitOccurrence(p, e->start.date, mapped, firstSlot, lastSlot);
+        return;
+    }
+
+    int interval = e->interval > 0 ? e->interval : 1;
+    if (e->frequency == ICS_FREQ_DAILY) {
+        int32_t date = e->start.date;
+        // 没有 COUNT 时可直接跳到日期范围的起点
+        if (ranged && e->count == 0 && date < options->firstDate) {
+            date += (options->firstDate - date) / interval * interval;
+        }
+        for (int n = 0; n < limit && !p->stop; ++n, date += interval) {
+            if (PastUntil(e, date) || (ranged && date >= options->lastDate)) break;
+            EmitOccurrence(p, date, mapped, firstSlot, lastSlot);
+        }
+        return;
+    }
+
+    // 每周：以周一为一周的开始（WKST=MO），每 interval 周取 BYDAY 列出的各天，早于 DTSTART 的不算
+    unsigned int byDay = e->byDay ? e->byDay : 1u << IcsWeekday(e->start.date);
+    int32_t weekStart = e->start.date - IcsWeekday(e->start.date);
+    int32_t stride = 7 * interval;
+    if (ranged && e->count == 0 && weekStart + stride <= options->firstDate) {
+        weekStart += (options->firstDate - weekStart) / stride * stride;
+    }
+    int n = 0;
+    for (; n < limit && !p->stop; weekStart += stride) {
+        for (int d = 0; d < 7 && n < limit && !p->stop; ++d) {
+            if (!(byDay & (1u << d))) continue;
+            int32_t date = weekStart + d;
+            if (date < e->start.date) continue;
+            if (PastUntil(e, date) || (ranged && date >= options->lastDate)) return;
+            n++;
+            EmitOccurrence(p, date, mapped, firstSlot, lastSlot);
+        }
+    }
+}
+
+static void BeginEvent(IcsParser *p) {
+    IcsEvent *e = &p->event;
+    // EXDATE 数组不必清零，只清除其余状态
+    memset(e, 0, offsetof(IcsEvent, exdates));
+    e->exdateCount = 0;
+    p->inEvent = 1;
+}
+
+// 处理 VEVENT 内的一个属性；name 与参数已拆开，value 为冒号之后的部分
+static void EventProperty(IcsParser *p, const char *name, size_t nameLength, int dateOnly,
+                          const char *value, size_t length) {
+    IcsEvent *e = &p->event;
+    int utcOffset = p->options->utcOffsetMinutes;
+    int truncated = 0;
+    if (KeywordIs(name, nameLength, "DTSTART")) {
+        e->hasStart = ParseIcsTime(value, length, utcOffset, &e->start);
+        if (!e->hasStart) e->invalid = 1;
+        if (dateOnly) e->start.minute = ICS_NO_TIME;
+    } else if (KeywordIs(name, nameLength, "DTEND")) {
+        e->hasEnd = ParseIcsTime(value, length, utcOffset, &e->end);
+    } else if (KeywordIs(name, nameLength, "DURATION")) {
+        e->hasDuration = ParseDuration(value, length, &e->durationMinutes);
+    } else if (KeywordIs(name, nameLength, "SUMMARY")) {
+        e->summaryLength = UnescapeText(value, length, e->summary, sizeof(e->summary), &truncated);
+    } else if (KeywordIs(name, nameLength, "LOCATION")) {
+        e->locationLength = UnescapeText(value, length, e->location, sizeof(e->location), &truncated);
+    } else if (KeywordIs(name, nameLength, "RRULE")) {
+        ParseRule(p, value, length);
+    } else if (KeywordIs(name, nameLength, "EXDATE")) {
+        AddExdates(p, value, length);
+    } else if (KeywordIs(name, nameLength, "STATUS")) {
+        e->cancelled = KeywordIs(value, length, "CANCELLED");
+    }
+    if (truncated) p->stats->truncated++;
+}
+
+// 处理一个逻辑行（折行已展开，不含行尾）
+static void ProcessLine(IcsParser *p, char *line, size_t length) {
+    if (length == 0) return;
+    p->stats->lines++;
+
+    // 属性名到 ';' 或 ':' 为止；参数中带引号的值可能含 ':'
+    size_t nameEnd = 0;
+    while (nameEnd < length && line[nameEnd] != ';' && line[nameEnd] != ':') ++nameEnd;
+    size_t colon = nameEnd;
+    int quoted = 0;
+    while (colon < length && (quoted || line[colon] != ':')) {
+        if (line[colon] == '"') quoted = !quoted;
+        ++colon;
+    }
+    if (colon >= length) return;
+    const char *value = line + colon + 1;
+    size_t valueLength = length - colon - 1;
+
+    if (KeywordIs(line, nameEnd, "BEGIN")) {
+        if (KeywordIs(value, valueLength, "VEVENT")) {
+            if (p->inEvent) {
+                p->stats->errorLine = p->stats->lines;
+                p->stop = 1;
+                return;
+            }
+            BeginEvent(p);
+        } else if (p->inEvent) {
+            p->event.nested++;
+        }
+        return;
+    }
+    if (KeywordIs(line, nameEnd, "END")) {
+        if (KeywordIs(value, valueLength, "VEVENT")) {
+            if (!p->inEvent || p->event.nested != 0) {
+                p->stats->errorLine = p->stats->lines;
+                p->stop = 1;
+                return;
+            }
+            p->inEvent = 0;
+            ExpandEvent(p);
+        } else if (p->inEvent && p->event.nested > 0) {
+            p->event.nested--;
+        }
+        return;
+    }
+    if (!p->inEvent || p->event.nested > 0) return;
+
+    // 只关心 VALUE=DATE 参数（全天事件）
+    int dateOnly = 0;
+    for (size_t i = nameEnd; i < colon;) {
+        size_t end = i + 1;
+        while (end < colon && line[end] != ';') ++end;
+        if (KeywordIs(line + i + 1, end - i - 1, "VALUE=DATE")) dateOnly = 1;
+        i = end;
+    }
+    EventProperty(p, line, nameEnd, dateOnly, value, valueLength);
+}
+
+int IcsImport(IcsReadCallback read, void *readUser, const IcsImportOptions *options,
+              IcsOccurrenceCallback callback, void *user, IcsImportStats *stats) {
+    if (!read || !options || !callback || !stats || options->periodCount < 0 ||
+        (options->periodCount > 0 && !options->periods)) {
+        return 0;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    IcsParser *p = (IcsParser*)malloc(sizeof(IcsParser));
+    if (!p) return 0;
+    p->options = options;
+    p->callback = callback;
+    p->user = user;
+    p->stats = stats;
+    p->inEvent = 0;
+    p->stop = 0;
+
+    // 折行：以空格或制表符开头的物理行接在上一行之后（去掉该字符）
+    size_t lineLength = 0;
+    int haveLine = 0;
+    int atLineStart = 1;
+    int lineTruncated = 0;
+    char lastByte = 0;
+    size_t n;
+    while (!p->stop && (n = read(readUser, p->chunk, sizeof(p->chunk))) > 0) {
+        const char *chunk = p->chunk;
+        size_t i = 0;
+        while (i < n && !p->stop) {
+            if (atLineStart) {
+                atLineStart = 0;
+                if ((chunk[i] == ' ' || chunk[i] == '\t') && haveLine) {
+                    ++i;
+                } else {
+                    if (haveLine) {
+                        ProcessLine(p, p->line, lineLength);
+                        if (p->stop) break;
+                    }
+                    lineLength = 0;
+                    lineTruncated = 0;
+                    haveLine = 1;
+                }
+            }
+
+            const char *newline = (const char*)memchr(chunk + i, '\n', n - i);
+            size_t end = newline ? (size_t)(newline - chunk) : n;
+            size_t segment = end - i;
+            if (segment > 0) {
+                size_t room = sizeof(p->line) - lineLength;
+                size_t copy = segment < room ? segment : room;
+                memcpy(p->line + lineLength, chunk + i, copy);
+                lineLength += copy;
+                if (copy < segment && !lineTruncated) {
+                    lineTruncated = 1;
+                    stats->truncated++;
+                }
+                lastByte = chunk[end - 1];
+            }
+            if (newline) {
+                // 行尾的 CR 可能在上一块的末尾
+                if (lastByte == '\r' && lineLength > 0 && p->line[lineLength - 1] == '\r') {
+                    lineLength--;
+                }
+                lastByte = 0;
+                atLineStart = 1;
+                i = end + 1;
+            } else {
+                i = n;
+            }
+        }
+    }
+    if (!p->stop && haveLine) {
+        if (lineLength > 0 && p->line[lineLength - 1] == '\r') lineLength--;
+        ProcessLine(p, p->line, lineLength);
+    }
+
+    int ok = !p->stop;
+    if (!ok && stats->errorLine == 0) {
+        stats->errorLine = stats->lines;    // 回调要求停止
+    }
+    free(p);
+    return ok;
+}
+
+static size_t ReadFileChunk(void *user, char *buffer, size_t capacity) {
+    return fread(buffer, 1, capacity, (FILE*)user);
+}
+
+int IcsImportFile(FILE *file, const IcsImportOptions *options,
+                  IcsOccurrenceCallback callback, void *user, IcsImportStats *stats) {
+    if (!file) return 0;
+    return IcsImport(ReadFileChunk, file, options, callback, user, stats);
+}
+
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t offset;
+} MemoryReader;
+
+static size_t ReadMemoryChunk(void *user, char *buffer, size_t capacity) {
+    MemoryReader *reader = (MemoryReader*)user;
+    size_t n = reader->size - reader->offset;
+    if (n > capacity) n = capacity;
+    memcpy(buffer, reader->data + reader->offset, n);
+    reader->offset += n;
+    return n;
+}
+
+int IcsImportMemory(const char *data, size_t size, const IcsImportOptions *options,
+                    IcsOccurrenceCallback callback, void *user, IcsImportStats *stats) {
+    if (!data && size > 0) return 0;
+    MemoryReader reader = {data, size, 0};
+    return IcsImport(ReadMemoryChunk, &reader, options, callback, user, stats);
+}
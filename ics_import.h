@@ -0,0 +1,79 @@
+#ifndef ICS_IMPORT_H
+#define ICS_IMPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "schedule_index.h"
+
+// iCalendar (.ics) 导入：流式读取 VEVENT，展开每周/每天重复（RRULE）并去掉 EXDATE，
+// 按节次时间表把每次上课映射到 (星期, 节次) 网格
+// 内存占用与文件大小无关：只有固定大小的读缓冲、逻辑行缓冲与当前事件的状态
+// 本模块不依赖 Win32
+//
+// 支持的子集：
+//   DTSTART / DTEND / DURATION（本地时间、带 TZID 的时间按墙上时间处理，UTC 时间按 utcOffsetMinutes 换算；
+//   全天事件跳过），SUMMARY、LOCATION（TEXT 转义），STATUS:CANCELLED（跳过），
+//   RRULE 的 FREQ=WEEKLY/DAILY、INTERVAL、BYDAY、UNTIL、COUNT，EXDATE（可多行、逗号分隔）
+// 带 RECURRENCE-ID 的修改实例按独立事件处理；其他 FREQ 只取首次
+
+#define ICS_MAX_LINE      4096    // 展开折行后的逻辑行上限，超出部分截断
+#define ICS_MAX_TEXT      512     // SUMMARY / LOCATION 的 UTF-8 字节上限
+#define ICS_MAX_EXDATES   256     // 单个事件记录的 EXDATE 上限，超出的不再排除
+#define ICS_MAX_EXPANSION 1000    // 无 UNTIL/COUNT 的重复最多展开的次数
+
+// 一次上课映射到网格后的结果：day 为星期（0=周一），[firstSlot, lastSlot] 为与之重叠的节次
+// summary / location 为 UTF-8，不以 0 结尾，只在回调期间有效
+typedef struct {
+    int day;
+    int firstSlot;
+    int lastSlot;
+    int32_t date;           // 自 1970-01-01 起的天数（本地日期）
+    const char *summary;
+    size_t summaryLength;
+    const char *location;
+    size_t locationLength;
+} IcsOccurrence;
+
+// 返回 0 时停止导入
+typedef int (*IcsOccurrenceCallback)(void *user, const IcsOccurrence *occurrence);
+
+// 数据来源：读满 buffer 或到达末尾前不必返回，返回 0 表示结束
+typedef size_t (*IcsReadCallback)(void *user, char *buffer, size_t capacity);
+
+typedef struct {
+    const PeriodTime *periods;  // 节次时间，按开始时间递增
+    int periodCount;
+    int utcOffsetMinutes;       // UTC 时间（以 Z 结尾）换算为本地时间的偏移
+    int32_t firstDate;          // 只导入 [firstDate, lastDate) 内的上课（自 1970-01-01 起的天数）
+    int32_t lastDate;           // firstDate >= lastDate 表示不限日期
+} IcsImportOptions;
+
+typedef struct {
+    long lines;                 // 逻辑行数（折行展开后）
+    long events;                // VEVENT 数
+    long occurrences;           // 展开并去掉 EXDATE 后落在日期范围内的上课次数
+    long unmapped;              // 与任何节次都不重叠的上课次数
+    long skipped;               // 跳过的事件：全天、取消、缺少 DTSTART 或时间无法解析
+    long truncated;             // 截断的行或文本、超出上限的 EXDATE
+    long errorLine;             // 出错时的逻辑行号，0 表示没有错误
+} IcsImportStats;
+
+// 导入一个 .ics 数据流；每次上课调用一次 callback。成功返回 1
+// 失败（事件嵌套错误或回调返回 0）时 stats->errorLine 指出位置
+int IcsImport(IcsReadCallback read, void *readUser, const IcsImportOptions *options,
+              IcsOccurrenceCallback callback, void *user, IcsImportStats *stats);
+
+// 便捷形式：从文件或内存读取
+int IcsImportFile(FILE *file, const IcsImportOptions *options,
+                  IcsOccurrenceCallback callback, void *user, IcsImportStats *stats);
+int IcsImportMemory(const char *data, size_t size, const IcsImportOptions *options,
+                    IcsOccurrenceCallback callback, void *user, IcsImportStats *stats);
+
+// "YYYY-MM-DD" 或 "YYYYMMDD" -> 自 1970-01-01 起的天数；失败返回 0
+int IcsParseDate(const char *text, int32_t *days);
+
+// 自 1970-01-01 起的天数 -> 星期（0=周一）
+int IcsWeekday(int32_t days);
+
+#endif // ICS_IMPORT_H
@@ -0,0 +1,424 @@
+#include "image_encode.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFLATE_WINDOW      32768
+#define DEFLATE_HASH_BITS   15
+#define DEFLATE_MIN_MATCH   4       // 按 4 字节哈希，比 deflate 允许的最短匹配长 1
+#define DEFLATE_MAX_MATCH   258
+#define QOI_HEADER_SIZE     14
+#define QOI_END_SIZE        8
+
+static const uint16_t g_lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t g_lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t g_distanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t g_distanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// 固定 Huffman 码（已按 deflate 的低位在前顺序反转）与长度/距离到码号的查找表，每次编码时生成
+typedef struct {
+    uint16_t literalCode[288];
+    uint8_t literalBits[288];
+    uint8_t lengthSymbol[DEFLATE_MAX_MATCH + 1];   // 长度 -> 码号 0..28
+    uint8_t distanceSymbol[512];                   // 距离 <= 256 用 [d - 1]，否则用 [256 + ((d - 1) >> 7)]
+    uint32_t crcTable[256];
+} DeflateTables;
+
+typedef struct {
+    uint8_t *out;
+    size_t pos;
+    uint64_t bits;
+    int count;
+} BitWriter;
+
+static uint32_t ReverseBits(uint32_t code, int bits) {
+    uint32_t result = 0;
+    for (int i = 0; i < bits; ++i) {
+        result = (result << 1) | ((code >> i) & 1);
+    }
+    return result;
+}
+
+static void BuildTables(DeflateTables *t) {
+    for (int s = 0; s < 288; ++s) {
+        uint32_t code;
+        int bits;
+        if (s < 144) {
+            code = 0x30 + s;
+            bits = 8;
+        } else if (s < 256) {
+            code = 0x190 + (s - 144);
+            bits = 9;
+        } else if (s < 280) {
+            code = s - 256;
+            bits = 7;
+        } else {
+            code = 0xC0 + (s - 280);
+            bits = 8;
+        }
+        t->literalCode[s] = (uint16_t)ReverseBits(code, bits);
+        t->literalBits[s] = (uint8_t)bits;
+    }
+
+    for (int code = 0; code < 29; ++code) {
+        int end = (code == 28) ? DEFLATE_MAX_MATCH + 1 : g_lengthBase[code + 1];
+        for (int len = g_lengthBase[code]; len < end; ++len) {
+            t->lengthSymbol[len] = (uint8_t)code;
+        }
+    }
+
+    for (int code = 0; code < 30; ++code) {
+        int end = (code == 29) ? DEFLATE_WINDOW + 1 : g_distanceBase[code + 1];
+        for (int d = g_distanceBase[code]; d < end; ++d) {
+            int slot = (d <= 256) ? d - 1 : 256 + ((d - 1) >> 7);
+            t->distanceSymbol[slot] = (uint8_t)code;
+        }
+    }
+
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        t->crcTable[n] = c;
+    }
+}
+
+static inline void PutBits(BitWriter *w, uint32_t value, int bits) {
+    w->bits |= (uint64_t)value << w->count;
+    w->count += bits;
+    while (w->count >= 8) {
+        w->out[w->pos++] = (uint8_t)w->bits;
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+static inline void PutSymbol(BitWriter *w, const DeflateTables *t, int symbol) {
+    PutBits(w, t->literalCode[symbol], t->literalBits[symbol]);
+}
+
+static void PutMatch(BitWriter *w, const DeflateTables *t, int length, int distance) {
+    int lengthCode = t->lengthSymbol[length];
+    PutSymbol(w, t, 257 + lengthCode);
+    if (g_lengthExtra[lengthCode]) {
+        PutBits(w, (uint32_t)(length - g_lengthBase[lengthCode]), g_lengthExtra[lengthCode]);
+    }
+    int distanceCode = t->distanceSymbol[(distance <= 256) ? distance - 1 : 256 + ((distance - 1) >> 7)];
+    PutBits(w, ReverseBits((uint32_t)distanceCode, 5), 5);
+    if (g_distanceExtra[distanceCode]) {
+        PutBits(w, (uint32_t)(distance - g_distanceBase[distanceCode]), g_distanceExtra[distanceCode]);
+    }
+}
+
+static inline uint32_t Load32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t Load64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t Adler32(const uint8_t *data, size_t size) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0) {
+        // 5552 为 b 不溢出 32 位的最大块长
+        size_t block = size < 5552 ? size : 5552;
+        size -= block;
+        // 每次 8 字节：b 增加 8a 加上各字节的加权和，减少循环携带的依赖
+        for (; block >= 8; block -= 8, data += 8) {
+            b += a * 8 + data[0] * 8u + data[1] * 7u + data[2] * 6u + data[3] * 5u +
+                 data[4] * 4u + data[5] * 3u + data[6] * 2u + data[7];
+            a += (uint32_t)data[0] + data[1] + data[2] + data[3] + data[4] + data[5] + data[6] + data[7];
+        }
+        while (block--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static uint32_t Crc32(const DeflateTables *t, const uint8_t *data, size_t size) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        c = t->crcTable[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// zlib 流：单个固定 Huffman 块，贪心匹配，每个位置只取哈希表中的一个候选
+static size_t Deflate(const DeflateTables *t, const uint8_t *src, size_t size, int32_t *heads, uint8_t *out) {
+    BitWriter w = {out, 0, 0, 0};
+    out[w.pos++] = 0x78;    // CM = 8, 32K 窗口
+    out[w.pos++] = 0x01;    // 最快压缩级别，(0x78 << 8 | 0x01) % 31 == 0
+    PutBits(&w, 1, 1);      // BFINAL
+    PutBits(&w, 1, 2);      // BTYPE = 01 固定 Huffman
+
+    for (size_t i = 0; i < ((size_t)1 << DEFLATE_HASH_BITS); ++i) {
+        heads[i] = -1;
+    }
+
+    size_t i = 0;
+    while (i + DEFLATE_MIN_MATCH <= size) {
+        uint32_t v = Load32(src + i);
+        uint32_t h = (v * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+        int32_t candidate = heads[h];
+        heads[h] = (int32_t)i;
+
+        if (candidate >= 0 && i - (size_t)candidate <= DEFLATE_WINDOW && Load32(src + candidate) == v) {
+            size_t limit = size - i;
+            if (limit > DEFLATE_MAX_MATCH) limit = DEFLATE_MAX_MATCH;
+            size_t length = DEFLATE_MIN_MATCH;
+            while (length + 8 <= limit && Load64(src + candidate + length) == Load64(src + i + length)) {
+                length += 8;
+            }
+            while (length < limit && src[candidate + length] == src[i + length]) {
+                ++length;
+            }
+            PutMatch(&w, t, (int)length, (int)(i - (size_t)candidate));
+            i += length;
+            continue;
+        }
+        PutSymbol(&w, t, src[i]);
+        ++i;
+    }
+    for (; i < size; ++i) {
+        PutSymbol(&w, t, src[i]);
+    }
+    PutSymbol(&w, t, 256);
+    if (w.count > 0) {
+        PutBits(&w, 0, 8 - w.count);
+    }
+
+    uint32_t adler = Adler32(src, size);
+    out[w.pos++] = (uint8_t)(adler >> 24);
+    out[w.pos++] = (uint8_t)(adler >> 16);
+    out[w.pos++] = (uint8_t)(adler >> 8);
+    out[w.pos++] = (uint8_t)adler;
+    return w.pos;
+}
+
+static int Reserve(uint8_t **data, size_t *capacity, size_t needed) {
+    if (needed <= *capacity) return 1;
+    uint8_t *grown = (uint8_t*)realloc(*data, needed);
+    if (!grown) return 0;
+    *data = grown;
+    *capacity = needed;
+    return 1;
+}
+
+static void PutBe32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+// 预乘 BGRA -> 直通 RGBA（按内存顺序打包为小端 uint32）
+// 渲染结果大片同色，转换结果按源像素缓存在调用方，同一像素不重复计算
+typedef struct {
+    uint32_t source;
+    uint32_t rgba;
+} UnpremultiplyCache;
+
+static inline uint32_t Unpremultiply(uint32_t p, UnpremultiplyCache *cache) {
+    if (p == cache->source) return cache->rgba;
+    uint32_t a = p >> 24;
+    uint32_t reciprocal = a ? (255u * 65536u + a / 2) / a : 0;
+    uint32_t r = (((p >> 16) & 0xFF) * reciprocal + 0x8000) >> 16;
+    uint32_t g = (((p >> 8) & 0xFF) * reciprocal + 0x8000) >> 16;
+    uint32_t b = ((p & 0xFF) * reciprocal + 0x8000) >> 16;
+    if (r > 255) r = 255;
+    if (g > 255) g = 255;
+    if (b > 255) b = 255;
+    cache->source = p;
+    cache->rgba = r | (g << 8) | (b << 16) | (a << 24);
+    return cache->rgba;
+}
+
+static inline void StoreRgba(uint8_t *dst, uint32_t rgba) {
+    dst[0] = (uint8_t)rgba;
+    dst[1] = (uint8_t)(rgba >> 8);
+    dst[2] = (uint8_t)(rgba >> 16);
+    dst[3] = (uint8_t)(rgba >> 24);
+}
+
+static void WriteChunkHeader(uint8_t *p, uint32_t length, const char *type) {
+    PutBe32(p, length);
+    memcpy(p + 4, type, 4);
+}
+
+static void WriteChunkCrc(const DeflateTables *t, uint8_t *chunk, uint32_t length) {
+    PutBe32(chunk + 8 + length, Crc32(t, chunk + 4, (size_t)length + 4));
+}
+
+static int EncodePng(const uint32_t *pixels, int width, int height, int stride, ImageBuffer *out) {
+    // 原始扫描线：每行一个过滤类型字节（0，不过滤）加 RGBA
+    size_t rowBytes = 1 + (size_t)width * 4;
+    size_t rawSize = rowBytes * height;
+    if (!Reserve(&out->scratch, &out->scratchCapacity, rawSize)) return 0;
+    if (!out->hashHeads) {
+        out->hashHeads = (int32_t*)malloc(sizeof(int32_t) << DEFLATE_HASH_BITS);
+        if (!out->hashHeads) return 0;
+    }
+
+    UnpremultiplyCache cache = {0, 0};
+    for (int y = 0; y < height; ++y) {
+        uint8_t *row = out->scratch + rowBytes * y;
+        const uint32_t *src = pixels + (size_t)y * stride;
+        row[0] = 0;
+        for (int x = 0; x < width; ++x) {
+            StoreRgba(row + 1 + (size_t)x * 4, Unpremultiply(src[x], &cache));
+        }
+    }
+
+    // 最坏情况每字节 9 位，另加 zlib 头尾与块尾
+    size_t zlibBound = rawSize + rawSize / 8 + 16;
+    size_t idatOffset = 8 + 25;
+    if (!Reserve(&out->data, &out->capacity, idatOffset + 12 + zlibBound + 12)) return 0;
+
+    DeflateTables *tables = (DeflateTables*)malloc(sizeof(DeflateTables));
+    if (!tables) return 0;
+    BuildTables(tables);
+
+    uint8_t *p = out->data;
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    memcpy(p, signature, 8);
+
+    uint8_t *ihdr = p + 8;
+    WriteChunkHeader(ihdr, 13, "IHDR");
+    PutBe32(ihdr + 8, (uint32_t)width);
+    PutBe32(ihdr + 12, (uint32_t)height);
+    ihdr[16] = 8;   // 位深
+    ihdr[17] = 6;   // RGBA
+    ihdr[18] = 0;   // deflate
+    ihdr[19] = 0;   // 自适应过滤
+    ihdr[20] = 0;   // 不隔行
+    WriteChunkCrc(tables, ihdr, 13);
+
+    uint8_t *idat = p + idatOffset;
+    size_t zlibSize = Deflate(tables, out->scratch, rawSize, out->hashHeads, idat + 8);
+    WriteChunkHeader(idat, (uint32_t)zlibSize, "IDAT");
+    WriteChunkCrc(tables, idat, (uint32_t)zlibSize);
+
+    uint8_t *iend = idat + 12 + zlibSize;
+    WriteChunkHeader(iend, 0, "IEND");
+    WriteChunkCrc(tables, iend, 0);
+
+    out->size = (size_t)(iend + 12 - p);
+    free(tables);
+    return 1;
+}
+
+static int EncodeQoi(const uint32_t *pixels, int width, int height, int stride, ImageBuffer *out) {
+    size_t count = (size_t)width * height;
+    if (!Reserve(&out->data, &out->capacity, QOI_HEADER_SIZE + count * 5 + QOI_END_SIZE)) return 0;
+
+    uint8_t *p = out->data;
+    memcpy(p, "qoif", 4);
+    PutBe32(p + 4, (uint32_t)width);
+    PutBe32(p + 8, (uint32_t)height);
+    p[12] = 4;      // RGBA
+    p[13] = 0;      // sRGB，alpha 为线性
+    size_t pos = QOI_HEADER_SIZE;
+
+    uint32_t index[64];
+    memset(index, 0, sizeof(index));
+    uint32_t prev = 0xFF000000u;
+    int run = 0;
+    UnpremultiplyCache cache = {0, 0};
+
+    for (int y = 0; y < height; ++y) {
+        const uint32_t *src = pixels + (size_t)y * stride;
+        for (int x = 0; x < width; ++x) {
+            uint32_t rgba = Unpremultiply(src[x], &cache);
+            int last = (y == height - 1 && x == width - 1);
+
+            if (rgba == prev) {
+                if (++run == 62 || last) {
+                    p[pos++] = (uint8_t)(0xC0 | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                p[pos++] = (uint8_t)(0xC0 | (run - 1));
+                run = 0;
+            }
+
+            uint8_t px[4];
+            StoreRgba(px, rgba);
+            int slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            if (index[slot] == rgba) {
+                p[pos++] = (uint8_t)slot;
+            } else {
+                index[slot] = rgba;
+                if ((rgba >> 24) == (prev >> 24)) {
+                    int dr = (int8_t)(px[0] - (uint8_t)prev);
+                    int dg = (int8_t)(px[1] - (uint8_t)(prev >> 8));
+                    int db = (int8_t)(px[2] - (uint8_t)(prev >> 16));
+                    int drg = dr - dg;
+                    int dbg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        p[pos++] = (uint8_t)(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                    } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                        p[pos++] = (uint8_t)(0x80 | (dg + 32));
+                        p[pos++] = (uint8_t)((drg + 8) << 4 | (dbg + 8));
+                    } else {
+                        p[pos++] = 0xFE;
+                        p[pos++] = px[0];
+                        p[pos++] = px[1];
+                        p[pos++] = px[2];
+                    }
+                } else {
+                    p[pos++] = 0xFF;
+                    memcpy(p + pos, px, 4);
+                    pos += 4;
+                }
+            }
+            prev = rgba;
+        }
+    }
+
+    memset(p + pos, 0, QOI_END_SIZE - 1);
+    pos += QOI_END_SIZE - 1;
+    p[pos++] = 1;
+    out->size = pos;
+    return 1;
+}
+
+int ImageEncode(ImageFormat format, const uint32_t *pixels, int width, int height, int stride, ImageBuffer *out) {
+    if (!pixels || !out || width <= 0 || height <= 0 || stride < width) return 0;
+    out->size = 0;
+    return (format == IMAGE_FORMAT_QOI) ? EncodeQoi(pixels, width, height, stride, out)
+                                        : EncodePng(pixels, width, height, stride, out);
+}
+
+void ImageBufferFree(ImageBuffer *buffer) {
+    if (!buffer) return;
+    free(buffer->data);
+    free(buffer->scratch);
+    free(buffer->hashHeads);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+const char *ImageFormatExtension(ImageFormat format) {
+    return (format == IMAGE_FORMAT_QOI) ? "qoi" : "png";
+}
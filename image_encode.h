@@ -0,0 +1,34 @@
+#ifndef IMAGE_ENCODE_H
+#define IMAGE_ENCODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 图像编码：把渲染得到的预乘 BGRA 像素编码为 PNG 或 QOI（直通 alpha 的 RGBA），供无头渲染写出文件
+// PNG 使用固定 Huffman 码与单候选哈希匹配的快速 deflate，压缩率让位于速度
+// 本模块不依赖 Win32，可在多个线程中各自使用自己的 ImageBuffer 同时编码
+
+typedef enum {
+    IMAGE_FORMAT_PNG = 0,
+    IMAGE_FORMAT_QOI
+} ImageFormat;
+
+// 编码结果与编码所需的临时内存；可反复使用，容量只增不减
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    uint8_t *scratch;       // PNG 的原始扫描线
+    size_t scratchCapacity;
+    int32_t *hashHeads;     // deflate 匹配用的哈希表
+} ImageBuffer;
+
+// pixels 为预乘 BGRA，每行 stride 个像素；成功返回 1，结果在 out->data[0, out->size)
+int ImageEncode(ImageFormat format, const uint32_t *pixels, int width, int height, int stride, ImageBuffer *out);
+
+void ImageBufferFree(ImageBuffer *buffer);
+
+// "png" / "qoi"
+const char *ImageFormatExtension(ImageFormat format);
+
+#endif // IMAGE_ENCODE_H
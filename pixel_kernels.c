@@ -0,0 +1,350 @@
+#include "pixel_kernels.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PIXEL_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#define PIXEL_RGB_MASK 0x00FFFFFFu
+#define PIXEL_ALPHA_OPAQUE 0xFF000000u
+
+typedef void (*PixelFillFn)(uint32_t *dst, size_t count, uint32_t value);
+typedef void (*PixelCompositeFn)(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t bgValue);
+typedef void (*PixelCompositeOverFn)(uint32_t *dst, const uint8_t *coverage, const uint32_t *background, size_t count);
+
+static PixelIsa g_pixelIsa = PIXEL_ISA_SCALAR;
+static PixelFillFn g_fillFn = NULL;
+static PixelCompositeFn g_compositeFn = NULL;
+static PixelCompositeOverFn g_compositeOverFn = NULL;
+
+// 定点除 255（对 0..65535 精确等于整数除法）
+static inline uint32_t Div255(uint32_t x) {
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+uint32_t PixelPremultiply(uint32_t rgb, uint8_t alpha) {
+    uint32_t r = Div255(((rgb >> 16) & 0xFF) * alpha);
+    uint32_t g = Div255(((rgb >> 8) & 0xFF) * alpha);
+    uint32_t b = Div255((rgb & 0xFF) * alpha);
+    return ((uint32_t)alpha << 24) | (r << 16) | (g << 8) | b;
+}
+
+uint8_t PixelCornerAlpha(int dx, int dy, int radius, uint8_t baseAlpha) {
+    // 距离平方为整数，内外两侧用整数比较直接判定；只有抗锯齿过渡带才需要插值
+    long dist2i = (long)dx * dx + (long)dy * dy;
+    long r2 = (long)radius * radius;
+    if (dist2i + radius <= r2) return baseAlpha;      // dist2 <= (r - 0.5)^2
+    if (dist2i >= r2 + radius + 1) return 0;          // dist2 >= (r + 0.5)^2
+
+    // 过渡带保持与原单精度公式逐字节一致（恰好落在 .5 的情况取决于浮点舍入）
+    float dist2 = (float)dist2i;
+    float rFloat = (float)radius;
+    float rMinus = rFloat - 0.5f;
+    float rPlus = rFloat + 0.5f;
+    float rMinus2 = rMinus * rMinus;
+    float rPlus2 = rPlus * rPlus;
+    float mask = (rPlus2 - dist2) / (rPlus2 - rMinus2);
+    if (mask < 0.0f) mask = 0.0f;
+    if (mask > 1.0f) mask = 1.0f;
+    return (uint8_t)(baseAlpha * mask + 0.5f);
+}
+
+static void FillScalar(uint32_t *dst, size_t count, uint32_t value) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = value;
+    }
+}
+
+static inline uint32_t CompositePixel(uint32_t p, uint32_t c, uint32_t bgValue) {
+    if (c == 0) return bgValue;
+    uint32_t src = p | PIXEL_ALPHA_OPAQUE;
+    if (c == 255) return src;
+
+    uint32_t inv = 255 - c;
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t v = ((src >> shift) & 0xFF) * c + ((bgValue >> shift) & 0xFF) * inv;
+        out |= Div255(v) << shift;
+    }
+    return out;
+}
+
+static void CompositeScalar(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t bgValue) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = CompositePixel(dst[i], coverage[i], bgValue);
+    }
+}
+
+static void CompositeOverScalar(uint32_t *dst, const uint8_t *coverage, const uint32_t *background, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = CompositePixel(dst[i], coverage[i], background[i]);
+    }
+}
+
+#ifdef PIXEL_KERNELS_X86
+__attribute__((target("sse2")))
+static void FillSse2(uint32_t *dst, size_t count, uint32_t value) {
+    __m128i v = _mm_set1_epi32((int)value);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+    FillScalar(dst + i, count - i, value);
+}
+
+// 16 位通道上的 (a * c + b * (255 - c)) / 255
+__attribute__((target("sse2")))
+static inline __m128i LerpDiv255Sse2(__m128i a16, __m128i b16, __m128i c16, __m128i inv16) {
+    __m128i v = _mm_add_epi16(_mm_mullo_epi16(a16, c16), _mm_mullo_epi16(b16, inv16));
+    __m128i t = _mm_add_epi16(v, _mm_add_epi16(_mm_set1_epi16(1), _mm_srli_epi16(v, 8)));
+    return _mm_srli_epi16(t, 8);
+}
+
+__attribute__((target("sse2")))
+static void CompositeSse2(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t bgValue) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    const __m128i opaque = _mm_set1_epi32((int)PIXEL_ALPHA_OPAQUE);
+    const __m128i bg = _mm_set1_epi32((int)bgValue);
+    const __m128i bgLo = _mm_unpacklo_epi8(bg, zero);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t c4;
+        memcpy(&c4, coverage + i, sizeof(c4));
+        if (c4 == 0) {
+            _mm_storeu_si128((__m128i*)(dst + i), bg);
+            continue;
+        }
+
+        // 每个像素的覆盖度扩展到 4 个通道
+        __m128i c = _mm_cvtsi32_si128((int)c4);
+        c = _mm_unpacklo_epi8(c, c);
+        c = _mm_unpacklo_epi16(c, c);
+        __m128i inv = _mm_xor_si128(c, ones);
+
+        __m128i src = _mm_or_si128(_mm_loadu_si128((const __m128i*)(dst + i)), opaque);
+        __m128i lo = LerpDiv255Sse2(_mm_unpacklo_epi8(src, zero), bgLo,
+                                    _mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(inv, zero));
+        __m128i hi = LerpDiv255Sse2(_mm_unpackhi_epi8(src, zero), bgLo,
+                                    _mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(inv, zero));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    CompositeScalar(dst + i, coverage + i, count - i, bgValue);
+}
+
+__attribute__((target("sse2")))
+static void CompositeOverSse2(uint32_t *dst, const uint8_t *coverage, const uint32_t *background, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    const __m128i opaque = _mm_set1_epi32((int)PIXEL_ALPHA_OPAQUE);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i bg = _mm_loadu_si128((const __m128i*)(background + i));
+        uint32_t c4;
+        memcpy(&c4, coverage + i, sizeof(c4));
+        if (c4 == 0) {
+            _mm_storeu_si128((__m128i*)(dst + i), bg);
+            continue;
+        }
+
+        __m128i c = _mm_cvtsi32_si128((int)c4);
+        c = _mm_unpacklo_epi8(c, c);
+        c = _mm_unpacklo_epi16(c, c);
+        __m128i inv = _mm_xor_si128(c, ones);
+
+        __m128i src = _mm_or_si128(_mm_loadu_si128((const __m128i*)(dst + i)), opaque);
+        __m128i lo = LerpDiv255Sse2(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(bg, zero),
+                                    _mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(inv, zero));
+        __m128i hi = LerpDiv255Sse2(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(bg, zero),
+                                    _mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(inv, zero));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    CompositeOverScalar(dst + i, coverage + i, background + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void FillAvx2(uint32_t *dst, size_t count, uint32_t value) {
+    __m256i v = _mm256_set1_epi32((int)value);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+    FillScalar(dst + i, count - i, value);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i LerpDiv255Avx2(__m256i a16, __m256i b16, __m256i c16, __m256i inv16) {
+    __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(a16, c16), _mm256_mullo_epi16(b16, inv16));
+    __m256i t = _mm256_add_epi16(v, _mm256_add_epi16(_mm256_set1_epi16(1), _mm256_srli_epi16(v, 8)));
+    return _mm256_srli_epi16(t, 8);
+}
+
+__attribute__((target("avx2")))
+static void CompositeAvx2(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t bgValue) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8((char)0xFF);
+    const __m256i opaque = _mm256_set1_epi32((int)PIXEL_ALPHA_OPAQUE);
+    const __m256i bg = _mm256_set1_epi32((int)bgValue);
+    const __m256i bgLo = _mm256_unpacklo_epi8(bg, zero);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t c8;
+        memcpy(&c8, coverage + i, sizeof(c8));
+        if (c8 == 0) {
+            _mm256_storeu_si256((__m256i*)(dst + i), bg);
+            continue;
+        }
+
+        __m128i c16 = _mm_loadl_epi64((const __m128i*)(coverage + i));
+        c16 = _mm_unpacklo_epi8(c16, c16);
+        __m256i c = _mm256_set_m128i(_mm_unpackhi_epi16(c16, c16), _mm_unpacklo_epi16(c16, c16));
+        __m256i inv = _mm256_xor_si256(c, ones);
+
+        __m256i src = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(dst + i)), opaque);
+        __m256i lo = LerpDiv255Avx2(_mm256_unpacklo_epi8(src, zero), bgLo,
+                                    _mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(inv, zero));
+        __m256i hi = LerpDiv255Avx2(_mm256_unpackhi_epi8(src, zero), bgLo,
+                                    _mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(inv, zero));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    CompositeScalar(dst + i, coverage + i, count - i, bgValue);
+}
+
+__attribute__((target("avx2")))
+static void CompositeOverAvx2(uint32_t *dst, const uint8_t *coverage, const uint32_t *background, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8((char)0xFF);
+    const __m256i opaque = _mm256_set1_epi32((int)PIXEL_ALPHA_OPAQUE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i bg = _mm256_loadu_si256((const __m256i*)(background + i));
+        uint64_t c8;
+        memcpy(&c8, coverage + i, sizeof(c8));
+        if (c8 == 0) {
+            _mm256_storeu_si256((__m256i*)(dst + i), bg);
+            continue;
+        }
+
+        __m128i c16 = _mm_loadl_epi64((const __m128i*)(coverage + i));
+        c16 = _mm_unpacklo_epi8(c16, c16);
+        __m256i c = _mm256_set_m128i(_mm_unpackhi_epi16(c16, c16), _mm_unpacklo_epi16(c16, c16));
+        __m256i inv = _mm256_xor_si256(c, ones);
+
+        __m256i src = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(dst + i)), opaque);
+        __m256i lo = LerpDiv255Avx2(_mm256_unpacklo_epi8(src, zero), _mm256_unpacklo_epi8(bg, zero),
+                                    _mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(inv, zero));
+        __m256i hi = LerpDiv255Avx2(_mm256_unpackhi_epi8(src, zero), _mm256_unpackhi_epi8(bg, zero),
+                                    _mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(inv, zero));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    CompositeOverScalar(dst + i, coverage + i, background + i, count - i);
+}
+#endif
+
+static PixelIsa DetectIsa(void) {
+#ifdef PIXEL_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return PIXEL_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2")) return PIXEL_ISA_SSE2;
+#endif
+    return PIXEL_ISA_SCALAR;
+}
+
+static void SelectIsa(PixelIsa isa) {
+    PixelIsa best = DetectIsa();
+    if (isa > best) isa = best;
+
+    g_fillFn = FillScalar;
+    g_compositeFn = CompositeScalar;
+    g_compositeOverFn = CompositeOverScalar;
+#ifdef PIXEL_KERNELS_X86
+    if (isa == PIXEL_ISA_AVX2) {
+        g_fillFn = FillAvx2;
+        g_compositeFn = CompositeAvx2;
+        g_compositeOverFn = CompositeOverAvx2;
+    } else if (isa == PIXEL_ISA_SSE2) {
+        g_fillFn = FillSse2;
+        g_compositeFn = CompositeSse2;
+        g_compositeOverFn = CompositeOverSse2;
+    }
+#endif
+    g_pixelIsa = isa;
+}
+
+static void EnsureKernels(void) {
+    if (!g_fillFn) {
+        SelectIsa(PIXEL_ISA_AVX2);
+    }
+}
+
+PixelIsa PixelKernelsIsa(void) {
+    EnsureKernels();
+    return g_pixelIsa;
+}
+
+const char *PixelKernelsIsaName(PixelIsa isa) {
+    switch (isa) {
+    case PIXEL_ISA_AVX2: return "avx2";
+    case PIXEL_ISA_SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+void PixelKernelsForceIsa(PixelIsa isa) {
+    SelectIsa(isa);
+}
+
+void PixelFill(uint32_t *dst, size_t count, uint32_t value) {
+    if (!dst || count == 0) return;
+    EnsureKernels();
+    g_fillFn(dst, count, value);
+}
+
+void PixelCompositeSpan(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t bgValue) {
+    if (!dst || !coverage || count == 0) return;
+    EnsureKernels();
+    g_compositeFn(dst, coverage, count, bgValue);
+}
+
+void PixelCompositeSpanOver(uint32_t *dst, const uint8_t *coverage, const uint32_t *background, size_t count) {
+    if (!dst || !coverage || !background || count == 0) return;
+    EnsureKernels();
+    g_compositeOverFn(dst, coverage, background, count);
+}
+
+void PixelCompositeSpanMasked(uint32_t *dst, const uint8_t *coverage, const uint8_t *alpha,
+                              size_t count, uint32_t bgRgb) {
+    if (!dst || !coverage || !alpha) return;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = CompositePixel(dst[i], coverage[i], PixelPremultiply(bgRgb, alpha[i]));
+    }
+}
+
+void PixelBlendCoverage(uint32_t *dst, uint8_t *coverage, const uint8_t *src, size_t count, uint32_t rgb) {
+    if (!dst || !coverage || !src) return;
+    rgb &= PIXEL_RGB_MASK;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t s = src[i];
+        if (s == 0) continue;
+
+        uint32_t old = coverage[i];
+        if (old == 0 || s == 255) {
+            dst[i] = rgb;
+            coverage[i] = (uint8_t)s;
+            continue;
+        }
+
+        // 文本重叠（少见）：按 over 合成覆盖度，颜色按各自贡献加权
+        uint32_t keep = Div255(old * (255 - s));
+        uint32_t total = s + keep;
+        uint32_t prev = dst[i];
+        uint32_t out = 0;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t v = ((rgb >> shift) & 0xFF) * s + ((prev >> shift) & 0xFF) * keep;
+            out |= ((v + total / 2) / total) << shift;
+        }
+        dst[i] = out;
+        coverage[i] = (uint8_t)total;
+    }
+}
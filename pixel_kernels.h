@@ -0,0 +1,47 @@
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 像素格式：32bpp 预乘 BGRA，按小端读作 0xAARRGGBB，与 DIB 内存布局一致
+// 本模块不依赖 Win32，可直接在 Linux 上用 gcc/clang 编译
+
+typedef enum {
+    PIXEL_ISA_SCALAR = 0,
+    PIXEL_ISA_SSE2,
+    PIXEL_ISA_AVX2
+} PixelIsa;
+
+// 当前选用的指令集（首次调用任一内核时按 CPU 能力自动选择）
+PixelIsa PixelKernelsIsa(void);
+const char *PixelKernelsIsaName(PixelIsa isa);
+
+// 强制指定指令集（用于对比与基准测试）；CPU 不支持时退回可用的最高级别
+void PixelKernelsForceIsa(PixelIsa isa);
+
+// 按 alpha 预乘 0x00RRGGBB 颜色并返回 0xAARRGGBB（定点除 255，结果与 (c * a) / 255 一致）
+uint32_t PixelPremultiply(uint32_t rgb, uint8_t alpha);
+
+// 以同一像素值填充
+void PixelFill(uint32_t *dst, size_t count, uint32_t value);
+
+// 文本覆盖度与背景合成：dst 的 RGB 为文本颜色（未预乘），coverage 为文本覆盖度
+// 输出 = 文本色 * c + 背景 * (255 - c)，alpha 同理（文本视为不透明），一次遍历完成
+// bgValue 为已按 alpha 预乘的背景像素（0xAARRGGBB）
+void PixelCompositeSpan(uint32_t *dst, const uint8_t *coverage, size_t count, uint32_t bgValue);
+
+// 同上，但背景 alpha 逐像素给出（圆角区域）：背景为 bgRgb 按 alpha[i] 预乘
+void PixelCompositeSpanMasked(uint32_t *dst, const uint8_t *coverage, const uint8_t *alpha,
+                              size_t count, uint32_t bgRgb);
+
+// 同上，但背景逐像素给出（已预乘，含圆角 alpha）：用于渐变、网格线等预先合成的背景
+void PixelCompositeSpanOver(uint32_t *dst, const uint8_t *coverage, const uint32_t *background, size_t count);
+
+// 把一段文本覆盖度（src）以颜色 rgb 叠加到文本层：更新 dst 的文本颜色与 coverage
+void PixelBlendCoverage(uint32_t *dst, uint8_t *coverage, const uint8_t *src, size_t count, uint32_t rgb);
+
+// 圆角平滑遮罩后的 alpha（偏移为到圆心的整数像素差）
+uint8_t PixelCornerAlpha(int dx, int dy, int radius, uint8_t baseAlpha);
+
+#endif // PIXEL_KERNELS_H
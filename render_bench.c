@@ -0,0 +1,315 @@
+// 渲染基准：背景合成、圆角遮罩、完整帧（复制静态层并重绘逐帧变化的区域）、滚动帧与冷/预热启动，覆盖多种窗口尺寸与 DPI
+// Linux: gcc -O2 render_bench.c render_core.c render_soft.c schedule.c schedule_index.c arena.c text_cache.c corner_tiles.c pixel_kernels.c frame_trace.c warm_start.c timetable_data.c -o render_bench -lm
+//
+// 用法: render_bench [--isa scalar|sse2|avx2] [--min-ms N] [--quick]
+// 每个用例一行 CSV：case,width,height,dpi,isa,iterations,ns_per_pixel,frames_per_second
+// ns_per_pixel 按该用例实际处理的像素计：background、frame 与 frame-styled（渐变与网格线背景）为整窗，corner 为四个角的正方形，
+// marquee 为滚动帧的脏矩形；cold-start 为新建渲染核心后的第一帧（字体、测量、布局与静态层都从零开始），
+// warm-start 为从预热缓存文件读回同一帧，二者均按整窗计；--quick 只测默认尺寸，用于快速比对
+
+#include "render_core.h"
+#include "render_soft.h"
+#include "pixel_kernels.h"
+#include "corner_tiles.h"
+#include "schedule.h"
+#include "warm_start.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define BENCH_DAYS        7
+#define BENCH_CLASSES     16
+#define BENCH_NAME_CHARS  96
+
+typedef struct {
+    int width;
+    int height;
+} BenchSize;
+
+static const BenchSize g_sizes[] = {
+    {400, 300}, {1280, 720}, {1920, 1080}, {3840, 2160}, {7680, 4320}
+};
+static const unsigned int g_dpis[] = {96, 144, 192, 288};
+
+static double g_minMs = 200.0;
+
+static double NowMs(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq = {0};
+    if (!freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+static void Report(const char *name, int width, int height, unsigned int dpi,
+                   long iterations, double elapsedMs, double pixels) {
+    double nsPerPixel = (pixels > 0.0) ? elapsedMs * 1e6 / pixels : 0.0;
+    double fps = (elapsedMs > 0.0) ? iterations * 1000.0 / elapsedMs : 0.0;
+    printf("%s,%d,%d,%u,%s,%ld,%.4f,%.2f\n", name, width, height, dpi,
+           PixelKernelsIsaName(PixelKernelsIsa()), iterations, nsPerPixel, fps);
+    fflush(stdout);
+}
+
+// 密集的合成课程表：每节都有课，名称长短不一（中英混排），每天至少一门超出单元格需要滚动
+static int BuildDenseSchedule(Schedule *schedule, TTCHAR (*names)[BENCH_NAME_CHARS],
+                              TTCHAR (*locations)[16]) {
+    static const TTCHAR pattern[] = TT_TEXT("高等数学Linear代数程序设计Physics实验");
+    const int patternLength = (int)(sizeof(pattern) / sizeof(pattern[0])) - 1;
+
+    ScheduleEntry entries[BENCH_DAYS * BENCH_CLASSES];
+    int count = 0;
+    for (int d = 0; d < BENCH_DAYS; ++d) {
+        for (int c = 0; c < BENCH_CLASSES; ++c) {
+            int index = d * BENCH_CLASSES + c;
+            int length = (c == 0) ? BENCH_NAME_CHARS - 1 : 2 + (index * 7) % 12;
+            for (int i = 0; i < length; ++i) {
+                names[index][i] = pattern[(index + i) % patternLength];
+            }
+            names[index][length] = 0;
+            char location[16];
+            int locationLength = snprintf(location, sizeof(location), "A%d-%d", d + 1, 100 + c);
+            for (int i = 0; i <= locationLength; ++i) {
+                locations[index][i] = (TTCHAR)(unsigned char)location[i];
+            }
+            entries[count].day = d;
+            entries[count].slot = c;
+            entries[count].name = names[index];
+            entries[count].location = locations[index];
+            count++;
+        }
+    }
+
+    Arena storage;
+    size_t size = 0;
+    if (!ScheduleBuildImage(BENCH_DAYS, BENCH_CLASSES, entries, count, &storage, &size)) return 0;
+    if (!ScheduleOpenMemory(storage.base, size, schedule)) {
+        ArenaRelease(&storage);
+        return 0;
+    }
+    schedule->storage = storage;
+    return 1;
+}
+
+// 背景合成：没有文本时每行整段交给 PixelCompositeSpan（CompositeLayer 的中间部分）
+static void BenchBackground(RenderSurface *surface, unsigned int dpi) {
+    uint32_t bgBase = PixelPremultiply(RENDER_RGB(0, 0, 0), WINDOW_ALPHA);
+    size_t count = (size_t)surface->width * surface->height;
+    memset(surface->coverage, 0, count);
+
+    long iterations = 0;
+    double start = NowMs();
+    double elapsed = 0.0;
+    do {
+        for (int y = 0; y < surface->height; ++y) {
+            size_t offset = (size_t)y * surface->width;
+            PixelCompositeSpan(surface->pixels + offset, surface->coverage + offset,
+                               (size_t)surface->width, bgBase);
+        }
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (elapsed < g_minMs || iterations < 3);
+    Report("background", surface->width, surface->height, dpi, iterations, elapsed,
+           (double)count * iterations);
+}
+
+// 圆角遮罩：四个角的正方形逐行使用贴片 alpha 合成
+static void BenchCorners(RenderSurface *surface, unsigned int dpi) {
+    const CornerTiles *tiles = CornerTilesGet(CORNER_RADIUS, dpi, WINDOW_ALPHA);
+    if (!tiles) return;
+    int r = tiles->radius;
+    if (r * 2 > surface->width || r * 2 > surface->height) return;
+    uint32_t bgRgb = RENDER_RGB(0, 0, 0);
+    int width = surface->width;
+    int height = surface->height;
+
+    long iterations = 0;
+    double start = NowMs();
+    double elapsed = 0.0;
+    do {
+        for (int row = 0; row < r; ++row) {
+            size_t top = (size_t)row * width;
+            size_t bottom = (size_t)(height - r + row) * width;
+            size_t right = (size_t)(width - r);
+            PixelCompositeSpanMasked(surface->pixels + top, surface->coverage + top,
+                                     CornerTilesRow(tiles, CORNER_TOP_LEFT, row), (size_t)r, bgRgb);
+            PixelCompositeSpanMasked(surface->pixels + top + right, surface->coverage + top + right,
+                                     CornerTilesRow(tiles, CORNER_TOP_RIGHT, row), (size_t)r, bgRgb);
+            PixelCompositeSpanMasked(surface->pixels + bottom, surface->coverage + bottom,
+                                     CornerTilesRow(tiles, CORNER_BOTTOM_LEFT, row), (size_t)r, bgRgb);
+            PixelCompositeSpanMasked(surface->pixels + bottom + right, surface->coverage + bottom + right,
+                                     CornerTilesRow(tiles, CORNER_BOTTOM_RIGHT, row), (size_t)r, bgRgb);
+        }
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (elapsed < g_minMs || iterations < 3);
+    Report("corner", width, height, dpi, iterations, elapsed, 4.0 * r * r * iterations);
+}
+
+// 完整帧：复制静态层并重绘逐帧变化的区域（文本段缓存与静态层已预热）
+// background 不为 NULL 时使用渐变与网格线背景，验证它们不增加逐帧开销
+static void BenchFrame(RenderCore *core, RenderSurface *surface, unsigned int dpi, const RenderBackground *background) {
+    RenderCoreSetBackground(core, background);
+    RenderFrameParams params = {0};
+    params.viewMode = 1;
+    params.dpi = dpi;
+    params.minuteOfDay = -1;
+    RenderCoreDrawFrame(core, surface, &params);
+
+    long iterations = 0;
+    double start = NowMs();
+    double elapsed = 0.0;
+    do {
+        RenderCoreDrawFrame(core, surface, &params);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (elapsed < g_minMs || iterations < 3);
+    Report(background ? "frame-styled" : "frame", surface->width, surface->height, dpi, iterations, elapsed,
+           (double)surface->width * surface->height * iterations);
+    RenderCoreSetBackground(core, NULL);
+}
+
+// 滚动帧：时间每次前进 16 ms，只重绘溢出文本的裁剪矩形
+static void BenchMarquee(RenderCore *core, RenderSurface *surface, unsigned int dpi) {
+    RenderFrameParams params = {0};
+    params.viewMode = 1;
+    params.dpi = dpi;
+    params.minuteOfDay = -1;
+    RenderCoreDrawFrame(core, surface, &params);
+    if (!RenderCoreHasOverflow(core)) return;
+
+    long iterations = 0;
+    double pixels = 0.0;
+    double start = NowMs();
+    double elapsed = 0.0;
+    do {
+        params.timeMs += 16;
+        RenderRect dirty;
+        if (!RenderCoreDrawMarquee(core, surface, &params, &dirty)) return;
+        pixels += (double)(dirty.right - dirty.left) * (dirty.bottom - dirty.top);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (elapsed < g_minMs || iterations < 3);
+    Report("marquee", surface->width, surface->height, dpi, iterations, elapsed, pixels);
+}
+
+// 冷启动与预热启动的第一帧：前者每次新建渲染核心（文本段缓存为空），后者从缓存文件读回前者的结果
+static void BenchStartup(const Schedule *schedule, RenderSurface *surface, unsigned int dpi) {
+    TextBackend backend;
+    RenderSoftTextBackend(&backend);
+    RenderFrameParams params = {0};
+    params.viewMode = 1;
+    params.dpi = dpi;
+    params.minuteOfDay = 600;
+    double pixels = (double)surface->width * surface->height;
+
+    long iterations = 0;
+    double start = NowMs();
+    double elapsed = 0.0;
+    do {
+        RenderCore *core = RenderCoreCreate(&backend);
+        if (!core) return;
+        RenderCoreSetSchedule(core, schedule);
+        RenderCoreDrawFrame(core, surface, &params);
+        RenderCoreDestroy(core);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (elapsed < g_minMs || iterations < 3);
+    Report("cold-start", surface->width, surface->height, dpi, iterations, elapsed, pixels * iterations);
+
+    const char *path = "render_bench.tmp.warm";
+    WarmStartKey key = {WarmStartScheduleHash(schedule), surface->width, surface->height, dpi, params.viewMode, 0};
+    if (!WarmStartSave(path, &key, 0, 24 * 60, surface->pixels, surface->stride)) return;
+    int ok = 1;
+    iterations = 0;
+    start = NowMs();
+    elapsed = 0.0;
+    do {
+        ok = WarmStartLoad(path, &key, params.minuteOfDay, surface->pixels, surface->stride);
+        iterations++;
+        elapsed = NowMs() - start;
+    } while (ok && (elapsed < g_minMs || iterations < 3));
+    remove(path);
+    if (!ok) return;
+    Report("warm-start", surface->width, surface->height, dpi, iterations, elapsed, pixels * iterations);
+}
+
+static void PrintUsage(const char *prog) {
+    fprintf(stderr, "usage: %s [--isa scalar|sse2|avx2] [--min-ms N] [--quick]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    int quick = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            quick = 1;
+        } else if (strcmp(argv[i], "--isa") == 0 && i + 1 < argc) {
+            const char *value = argv[++i];
+            PixelIsa isa = PIXEL_ISA_AVX2;
+            if (strcmp(value, "scalar") == 0) isa = PIXEL_ISA_SCALAR;
+            else if (strcmp(value, "sse2") == 0) isa = PIXEL_ISA_SSE2;
+            PixelKernelsForceIsa(isa);
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            g_minMs = atof(argv[++i]);
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    static TTCHAR names[BENCH_DAYS * BENCH_CLASSES][BENCH_NAME_CHARS];
+    static TTCHAR locations[BENCH_DAYS * BENCH_CLASSES][16];
+    Schedule schedule;
+    if (!BuildDenseSchedule(&schedule, names, locations)) {
+        fprintf(stderr, "cannot build schedule\n");
+        return 1;
+    }
+    TextBackend backend;
+    RenderSoftTextBackend(&backend);
+    RenderCore *core = RenderCoreCreate(&backend);
+    if (!core) {
+        ScheduleClose(&schedule);
+        return 1;
+    }
+    RenderCoreSetSchedule(core, &schedule);
+    const RenderBackground styled = {RENDER_RGB(16, 24, 48), RENDER_RGB(0, 0, 0), RENDER_RGB(255, 255, 255), 40};
+
+    printf("case,width,height,dpi,isa,iterations,ns_per_pixel,frames_per_second\n");
+    int sizeCount = quick ? 1 : (int)(sizeof(g_sizes) / sizeof(g_sizes[0]));
+    int dpiCount = quick ? 1 : (int)(sizeof(g_dpis) / sizeof(g_dpis[0]));
+    int status = 0;
+    for (int s = 0; s < sizeCount; ++s) {
+        RenderSurface surface;
+        if (!RenderSoftSurfaceCreate(&surface, g_sizes[s].width, g_sizes[s].height)) {
+            fprintf(stderr, "cannot allocate %dx%d\n", g_sizes[s].width, g_sizes[s].height);
+            status = 1;
+            continue;
+        }
+        for (int d = 0; d < dpiCount; ++d) {
+            BenchBackground(&surface, g_dpis[d]);
+            BenchCorners(&surface, g_dpis[d]);
+            BenchFrame(core, &surface, g_dpis[d], NULL);
+            BenchFrame(core, &surface, g_dpis[d], &styled);
+            BenchMarquee(core, &surface, g_dpis[d]);
+            BenchStartup(&schedule, &surface, g_dpis[d]);
+        }
+        RenderSoftSurfaceFree(&surface);
+    }
+
+    RenderCoreDestroy(core);
+    ScheduleClose(&schedule);
+    return status;
+}
@@ -0,0 +1,1315 @@
+#include "render_core.h"
+#include "pixel_kernels.h"
+#include "corner_tiles.h"
+#include "schedule.h"
+#include "schedule_index.h"
+#include "frame_trace.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_COLOR_NAME      RENDER_RGB(255, 255, 255)
+#define TEXT_COLOR_LOCATION  RENDER_RGB(200, 200, 200)   // 稍微淡一点的颜色
+#define TEXT_COLOR_HOLIDAY   RENDER_RGB(255, 215, 0)
+#define LAYER_BACKGROUND_RGB RENDER_RGB(0, 0, 0)         // 黑色背景
+#define HIGHLIGHT_RGB        RENDER_RGB(255, 255, 255)   // 当前节次底色
+#define HIGHLIGHT_COVERAGE   36
+#define OVERLAY_RGB          RENDER_RGB(144, 238, 144)
+#define OVERLAY_MAX_CHARS    512
+#define OVERLAY_MAX_LINES    16
+#define LAYOUT_CELL_LINES    2                           // 课程名称与位置
+#define DAMAGE_MARGIN        2                           // 居中文本记录的范围比单元格宽出的像素
+#define STATIC_DYNAMIC_SHARE 4                           // 滚动文本超过窗口面积的 1/4 时逐区域重绘不比整帧省，不用静态层
+
+// 一帧内绘制过的文本，滚动帧据此只重绘溢出文本所在的区域
+typedef enum {
+    TEXT_ITEM_LINE = 0,
+    TEXT_ITEM_HOLIDAY,
+    TEXT_ITEM_HIGHLIGHT,    // 当前节次的单元格底色
+    TEXT_ITEM_OVERLAY       // 叠加文本的一行，text 指向 RenderCore.overlay
+} TextItemKind;
+
+typedef struct {
+    TextItemKind kind;
+    RenderRect cell;    // 所在单元格（节假日文字为整列）
+    RenderRect bounds;  // 该文本可能写入的像素范围
+    const TTCHAR *text; // 仅叠加文本使用；课程文本经布局树取得，课程表热重载后仍然有效
+    int node;           // TEXT_ITEM_LINE：布局树中的节点与行
+    int line;
+    int scrolling;      // 溢出滚动的文本，bounds 即其裁剪矩形
+} TextItem;
+
+// 上一次完整渲染时的参数；任何一项变化都需要完整重绘
+typedef struct {
+    int valid;
+    int width;
+    int height;
+    int viewMode;
+    unsigned int dpi;
+    int today;
+    int currentPeriod;
+} FrameState;
+
+// 保留的布局树：单元格矩形、预先测量的文本尺寸与溢出标记
+// 只在尺寸、视图、DPI、日期或课程表数据变化时重建，逐帧绘制只遍历它
+typedef enum {
+    LAYOUT_NODE_CELL = 0,   // 一节课的单元格，子项为其文本行（可能没有）
+    LAYOUT_NODE_HOLIDAY     // 整天无课的一列（日视图为整个区域）
+} LayoutNodeKind;
+
+typedef enum {
+    LAYOUT_FIELD_NAME = 0,
+    LAYOUT_FIELD_LOCATION
+} LayoutField;
+
+typedef struct {
+    const TTCHAR *text;     // 指向课程表映射内存
+    int length;
+    LayoutField field;
+    int yOffset;
+    uint32_t color;
+    int extentWidth;
+    int extentHeight;
+    int overflow;           // 超出单元格宽度，按时间滚动
+} LayoutLine;
+
+typedef struct {
+    LayoutNodeKind kind;
+    int day;
+    int slot;
+    RenderRect rect;
+    int lineCount;
+    LayoutLine lines[LAYOUT_CELL_LINES];
+} LayoutNode;
+
+// 按字符串 ID 缓存的测量结果：同一门课的各次出现共用一次测量，字体与 DPI 不变时重建布局不再查找文本段缓存
+typedef struct {
+    int length;         // 0 表示尚未测量
+    int extentWidth;
+    int extentHeight;
+} StringExtent;
+
+typedef struct {
+    int valid;
+    int width;
+    int height;
+    int viewMode;
+    unsigned int dpi;
+    int today;
+    unsigned int scheduleVersion;
+
+    LayoutNode *nodes;      // 容量随课程表网格尺寸分配
+    int nodeCapacity;
+    int nodeCount;
+    int *cellNodes;         // [day * classes + slot] 对应的节点下标，不在布局中为 -1
+    int hasOverflow;
+} LayoutTree;
+
+// 预先合成的静态层：背景、圆角与课程文本（不含当前节次底色与叠加文本）
+// 只在布局、课程表数据或背景变化时重建；完整渲染复制它，再只在逐帧变化的内容所在区域重新合成
+typedef struct {
+    int valid;
+    int width;
+    int height;
+    unsigned int layoutVersion;
+    unsigned int scheduleVersion;
+    unsigned int backgroundVersion;
+    uint32_t *pixels;           // 合成结果，width * height 按行紧密存放
+    size_t pixelCapacity;
+    uint32_t *background;       // 非默认背景：逐像素的预乘背景（含圆角与网格线），不使用静态层时也用于合成
+    size_t backgroundCapacity;
+    int backgroundReady;        // background 已按以下尺寸与布局建立
+    int backgroundWidth;
+    int backgroundHeight;
+    unsigned int backgroundLayoutVersion;
+    unsigned int backgroundBuiltVersion;
+    TextItem *items;            // 建立时记录的文本
+    int itemCapacity;
+    int itemCount;
+    int *nodeItems;             // [布局节点] 该节点的第一条记录在 items 中的下标，底色按此插入
+    int nodeCapacity;
+} StaticLayer;
+
+struct RenderCore {
+    TextCache *textCache;
+    const Schedule *schedule;
+    ScheduleIndex index;        // 随课程表构建，按天占用与节次时间查询
+    int indexValid;
+
+    TextItem *textItems;    // 容量随课程表网格尺寸分配
+    int textItemCapacity;
+    int textItemCount;
+    int recordTextItems;
+
+    TTCHAR overlay[OVERLAY_MAX_CHARS];  // 上一次完整渲染的叠加文本，按行以 0 分隔
+
+    FrameState frameState;
+    LayoutTree layout;
+    unsigned int layoutVersion;     // 每次重建布局树递增
+    StaticLayer staticLayer;
+    RenderBackground background;
+    int hasBackground;              // 0 为默认纯色背景，直接按常量合成
+    unsigned int backgroundVersion;
+    unsigned int scheduleVersion;   // 每次设置课程表递增，作为布局树的数据版本
+    uint8_t *cellChanged;           // 热重载时逐格比较的结果，与 layout.cellNodes 同容量
+    int cellCapacity;
+    RenderRect damage;              // 热重载后内容变化、尚未重绘的区域
+    int damagePending;
+    StringExtent *stringExtents;    // [字符串 ID]，容量随课程表的字符串数分配
+    int stringExtentCapacity;
+    int extentFontHeight;           // stringExtents 对应的字体高度与 DPI
+    unsigned int extentDpi;
+
+    int scrollEpochSet;
+    uint64_t scrollEpoch;
+
+    // 当前绘制上下文
+    RenderSurface *surface;
+    RenderRect clip;
+    int fontHeight;
+    unsigned int dpi;
+    uint64_t timeMs;
+};
+
+static int MinInt(int a, int b) { return a < b ? a : b; }
+static int MaxInt(int a, int b) { return a > b ? a : b; }
+
+int RenderScaleForDpi(int value, unsigned int dpi) {
+    // 与 MulDiv 相同的四舍五入
+    long long product = (long long)value * (long long)dpi;
+    long long half = 48;
+    return (int)(product >= 0 ? (product + half) / 96 : (product - half) / 96);
+}
+
+static int TextLength(const TTCHAR *text) {
+    int len = 0;
+    while (text[len]) ++len;
+    return len;
+}
+
+static int IntersectRenderRect(RenderRect *out, const RenderRect *a, const RenderRect *b) {
+    RenderRect r;
+    r.left = MaxInt(a->left, b->left);
+    r.top = MaxInt(a->top, b->top);
+    r.right = MinInt(a->right, b->right);
+    r.bottom = MinInt(a->bottom, b->bottom);
+    if (r.left >= r.right || r.top >= r.bottom) {
+        memset(out, 0, sizeof(*out));
+        return 0;
+    }
+    *out = r;
+    return 1;
+}
+
+static void UnionRenderRect(RenderRect *out, const RenderRect *a, const RenderRect *b) {
+    RenderRect r;
+    r.left = MinInt(a->left, b->left);
+    r.top = MinInt(a->top, b->top);
+    r.right = MaxInt(a->right, b->right);
+    r.bottom = MaxInt(a->bottom, b->bottom);
+    *out = r;
+}
+
+static int RectsIntersect(const RenderRect *a, const RenderRect *b) {
+    return a->left < b->right && b->left < a->right &&
+           a->top < b->bottom && b->top < a->bottom;
+}
+
+RenderCore *RenderCoreCreate(const TextBackend *textBackend) {
+    RenderCore *core = (RenderCore*)calloc(1, sizeof(RenderCore));
+    if (!core) return NULL;
+
+    core->textCache = TextCacheCreate(textBackend);
+    if (!core->textCache) {
+        free(core);
+        return NULL;
+    }
+    return core;
+}
+
+void RenderCoreDestroy(RenderCore *core) {
+    if (!core) return;
+    free(core->textItems);
+    free(core->layout.nodes);
+    free(core->layout.cellNodes);
+    free(core->cellChanged);
+    free(core->stringExtents);
+    free(core->staticLayer.pixels);
+    free(core->staticLayer.background);
+    free(core->staticLayer.items);
+    free(core->staticLayer.nodeItems);
+    ScheduleIndexRelease(&core->index);
+    TextCacheDestroy(core->textCache);
+    free(core);
+}
+
+int RenderCoreMinutesUntilChange(const RenderCore *core, int minuteOfDay) {
+    if (minuteOfDay < 0 || minuteOfDay >= MINUTES_PER_DAY) return 1;
+    int next = core && core->indexValid ? ScheduleIndexNextBoundary(&core->index, minuteOfDay) : MINUTES_PER_DAY;
+    return next - minuteOfDay;
+}
+
+TextCache *RenderCoreTextCache(RenderCore *core) {
+    return core ? core->textCache : NULL;
+}
+
+int RenderCoreHasOverflow(const RenderCore *core) {
+    return core && core->layout.valid ? core->layout.hasOverflow : 0;
+}
+
+void RenderCoreInvalidate(RenderCore *core) {
+    if (core) core->frameState.valid = 0;
+}
+
+void RenderCoreSetBackground(RenderCore *core, const RenderBackground *background) {
+    if (!core) return;
+    core->hasBackground = (background != NULL);
+    if (background) {
+        core->background = *background;
+    }
+    core->backgroundVersion++;
+    core->staticLayer.valid = 0;
+    core->frameState.valid = 0;
+}
+
+static int BuildScheduleIndex(ScheduleIndex *index, const Schedule *schedule) {
+    int periodCount = 0;
+    const PeriodTime *periods = ScheduleDefaultPeriods(&periodCount);
+    return ScheduleIndexBuild(index, schedule, periods, periodCount);
+}
+
+// 字符串 ID 只在一份课程表内有意义，换课程表时清空按 ID 缓存的测量结果
+static void ResetStringExtents(RenderCore *core) {
+    int needed = core->schedule ? core->schedule->stringCount + 1 : 0;
+    if (needed > core->stringExtentCapacity) {
+        StringExtent *extents = (StringExtent*)realloc(core->stringExtents, sizeof(StringExtent) * (size_t)needed);
+        if (extents) {
+            core->stringExtents = extents;
+            core->stringExtentCapacity = needed;
+        }
+    }
+    if (core->stringExtents) {
+        memset(core->stringExtents, 0, sizeof(StringExtent) * (size_t)core->stringExtentCapacity);
+    }
+}
+
+void RenderCoreSetSchedule(RenderCore *core, const Schedule *schedule) {
+    if (!core) return;
+    // 记录的文本指向旧课程表的字符串，必须在完整重绘前丢弃
+    core->schedule = schedule;
+    core->textItemCount = 0;
+    core->frameState.valid = 0;
+    core->layout.valid = 0;
+    core->damagePending = 0;
+    core->scheduleVersion++;
+
+    ScheduleIndexRelease(&core->index);
+    core->indexValid = schedule ? BuildScheduleIndex(&core->index, schedule) : 0;
+    ResetStringExtents(core);
+
+    // 每节课最多两行文本，每天最多一处节假日文字，另加当前节次底色与叠加文本各行
+    int days = schedule ? schedule->days : 0;
+    int classes = schedule ? schedule->classes : 0;
+    int needed = days * classes * 2 + (days > 0 ? days : 1) + 1 + OVERLAY_MAX_LINES;
+    if (needed > core->textItemCapacity) {
+        TextItem *items = (TextItem*)realloc(core->textItems, sizeof(TextItem) * (size_t)needed);
+        if (items) {
+            core->textItems = items;
+            core->textItemCapacity = needed;
+        }
+    }
+
+    // 布局树：每节课一个节点，每天最多一个节假日节点
+    int nodesNeeded = days * classes + (days > 0 ? days : 1);
+    if (nodesNeeded > core->layout.nodeCapacity) {
+        LayoutNode *nodes = (LayoutNode*)realloc(core->layout.nodes, sizeof(LayoutNode) * (size_t)nodesNeeded);
+        if (nodes) {
+            core->layout.nodes = nodes;
+            core->layout.nodeCapacity = nodesNeeded;
+        }
+    }
+    int cellsNeeded = days * classes;
+    if (cellsNeeded > core->cellCapacity) {
+        int *cellNodes = (int*)realloc(core->layout.cellNodes, sizeof(int) * (size_t)cellsNeeded);
+        if (cellNodes) core->layout.cellNodes = cellNodes;
+        uint8_t *cellChanged = (uint8_t*)realloc(core->cellChanged, (size_t)cellsNeeded);
+        if (cellChanged) core->cellChanged = cellChanged;
+        if (cellNodes && cellChanged) core->cellCapacity = cellsNeeded;
+    }
+}
+
+// 文本覆盖度与背景合成：四角正方形使用缓存的 alpha 贴片，其余整段交给 SIMD 内核
+// area 限定处理范围（局部重绘时只处理脏矩形）
+static void CompositeLayer(uint32_t *pixels, const uint8_t *coverage, int width, int height, int stride,
+                           const CornerTiles *tiles, uint32_t bgRgb, uint32_t bgBase,
+                           const RenderRect *area) {
+    int corner = tiles->radius;
+    // 左侧圆角优先于右侧，上侧优先于下侧（窗口小于两倍圆角时与原逐像素判定一致）
+    int leftEnd = MinInt(corner, width);
+    int rightStart = MaxInt(leftEnd, width - corner);
+    int topEnd = MinInt(corner, height);
+    int bottomStart = MaxInt(topEnd, height - corner);
+    // 右/下侧贴片从 width - corner / height - corner 开始，被左/上侧占用的部分跳过
+    int rightOrigin = width - corner;
+
+    int x0 = MaxInt(0, area->left);
+    int x1 = MinInt(width, area->right);
+    int y0 = MaxInt(0, area->top);
+    int y1 = MinInt(height, area->bottom);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    // 本行内三段（左角、中间、右角）与 [x0, x1) 的交集
+    int midStart = MaxInt(x0, leftEnd);
+    int midEnd = MinInt(x1, rightStart);
+    int leftStop = MinInt(x1, leftEnd);
+    int rightFrom = MaxInt(x0, rightStart);
+
+    for (int y = y0; y < y1; ++y) {
+        uint32_t *row = pixels + (size_t)y * stride;
+        const uint8_t *cov = coverage + (size_t)y * stride;
+        if (y >= topEnd && y < bottomStart) {
+            PixelCompositeSpan(row + x0, cov + x0, (size_t)(x1 - x0), bgBase);
+            continue;
+        }
+
+        int top = (y < topEnd);
+        int tileRow = top ? y : (y - (height - corner));
+        const uint8_t *leftAlpha = CornerTilesRow(tiles, top ? CORNER_TOP_LEFT : CORNER_BOTTOM_LEFT, tileRow);
+        const uint8_t *rightAlpha = CornerTilesRow(tiles, top ? CORNER_TOP_RIGHT : CORNER_BOTTOM_RIGHT, tileRow);
+
+        if (x0 < leftStop) {
+            PixelCompositeSpanMasked(row + x0, cov + x0, leftAlpha + x0, (size_t)(leftStop - x0), bgRgb);
+        }
+        if (midStart < midEnd) {
+            PixelCompositeSpan(row + midStart, cov + midStart, (size_t)(midEnd - midStart), bgBase);
+        }
+        if (rightFrom < x1) {
+            PixelCompositeSpanMasked(row + rightFrom, cov + rightFrom, rightAlpha + (rightFrom - rightOrigin),
+                                     (size_t)(x1 - rightFrom), bgRgb);
+        }
+    }
+}
+
+// 合成 area 内的文本与背景：已建立逐像素背景时按它合成，否则为默认的纯色背景
+static void CompositeArea(RenderCore *core, RenderSurface *surface, const CornerTiles *tiles, const RenderRect *area) {
+    const StaticLayer *layer = &core->staticLayer;
+    int width = surface->width;
+    int height = surface->height;
+    if (!layer->backgroundReady || layer->backgroundWidth != width || layer->backgroundHeight != height) {
+        uint32_t bgRgb = LAYER_BACKGROUND_RGB;
+        uint32_t bgBase = PixelPremultiply(bgRgb, (uint8_t)WINDOW_ALPHA);
+        CompositeLayer(surface->pixels, surface->coverage, width, height, surface->stride, tiles, bgRgb, bgBase, area);
+        return;
+    }
+
+    int x0 = MaxInt(0, area->left);
+    int x1 = MinInt(width, area->right);
+    int y0 = MaxInt(0, area->top);
+    int y1 = MinInt(height, area->bottom);
+    for (int y = y0; y < y1 && x0 < x1; ++y) {
+        size_t offset = (size_t)y * surface->stride + x0;
+        PixelCompositeSpanOver(surface->pixels + offset, surface->coverage + offset,
+                               layer->background + (size_t)y * width + x0, (size_t)(x1 - x0));
+    }
+}
+
+static uint32_t LerpChannel(uint32_t a, uint32_t b, uint32_t t, uint32_t range) {
+    return range ? (a * (range - t) + b * t + range / 2) / range : a;
+}
+
+static uint32_t LerpRgb(uint32_t a, uint32_t b, uint32_t t, uint32_t range) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        out |= LerpChannel((a >> shift) & 0xFF, (b >> shift) & 0xFF, t, range) << shift;
+    }
+    return out;
+}
+
+// 网格线按 gridAlpha 与已预乘的背景混合，保持该像素的 alpha
+static void BlendGridRect(uint32_t *plane, int width, int height, RenderRect rc, uint32_t gridRgb, uint8_t gridAlpha) {
+    RenderRect bounds = {0, 0, width, height};
+    if (!IntersectRenderRect(&rc, &rc, &bounds)) return;
+    for (int y = rc.top; y < rc.bottom; ++y) {
+        uint32_t *row = plane + (size_t)y * width;
+        for (int x = rc.left; x < rc.right; ++x) {
+            uint32_t grid = PixelPremultiply(gridRgb, (uint8_t)(row[x] >> 24));
+            row[x] = LerpRgb(row[x], grid, gridAlpha, 255);
+        }
+    }
+}
+
+// 逐像素的预乘背景：底色按行做垂直渐变，四角使用圆角贴片，单元格之间叠加网格线
+static void BuildBackgroundPlane(RenderCore *core, uint32_t *plane, int width, int height, const CornerTiles *tiles) {
+    const RenderBackground *bg = &core->background;
+    uint8_t baseAlpha = (uint8_t)WINDOW_ALPHA;
+    // 与 CompositeLayer 相同的圆角范围
+    int corner = tiles->radius;
+    int leftEnd = MinInt(corner, width);
+    int rightStart = MaxInt(leftEnd, width - corner);
+    int topEnd = MinInt(corner, height);
+    int bottomStart = MaxInt(topEnd, height - corner);
+    int rightOrigin = width - corner;
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t rgb = LerpRgb(bg->topRgb & 0xFFFFFF, bg->bottomRgb & 0xFFFFFF, (uint32_t)y, (uint32_t)(height - 1));
+        uint32_t *row = plane + (size_t)y * width;
+        PixelFill(row, (size_t)width, PixelPremultiply(rgb, baseAlpha));
+        if (y >= topEnd && y < bottomStart) continue;
+
+        int top = (y < topEnd);
+        int tileRow = top ? y : (y - (height - corner));
+        const uint8_t *leftAlpha = CornerTilesRow(tiles, top ? CORNER_TOP_LEFT : CORNER_BOTTOM_LEFT, tileRow);
+        const uint8_t *rightAlpha = CornerTilesRow(tiles, top ? CORNER_TOP_RIGHT : CORNER_BOTTOM_RIGHT, tileRow);
+        for (int x = 0; x < leftEnd; ++x) {
+            row[x] = PixelPremultiply(rgb, leftAlpha[x]);
+        }
+        for (int x = rightStart; x < width; ++x) {
+            row[x] = PixelPremultiply(rgb, rightAlpha[x - rightOrigin]);
+        }
+    }
+
+    if (bg->gridAlpha == 0) return;
+    // 每个单元格画左边与上边（窗口边缘除外），交点只混合一次
+    int thickness = MaxInt(1, RenderScaleForDpi(1, core->dpi));
+    const LayoutTree *layout = &core->layout;
+    for (int n = 0; n < layout->nodeCount; ++n) {
+        const LayoutNode *node = &layout->nodes[n];
+        RenderRect rc = node->rect;
+        int hasLeft = rc.left > 0;
+        if (hasLeft) {
+            RenderRect line = {rc.left, rc.top, rc.left + thickness, rc.bottom};
+            BlendGridRect(plane, width, height, line, bg->gridRgb, bg->gridAlpha);
+        }
+        if (node->kind == LAYOUT_NODE_CELL && node->slot > 0) {
+            RenderRect line = {hasLeft ? rc.left + thickness : rc.left, rc.top, rc.right, rc.top + thickness};
+            BlendGridRect(plane, width, height, line, bg->gridRgb, bg->gridAlpha);
+        }
+    }
+}
+
+static void ClearCoverageRect(uint8_t *coverage, int stride, const RenderRect *area) {
+    for (int y = area->top; y < area->bottom; ++y) {
+        memset(coverage + (size_t)y * stride + area->left, 0, (size_t)(area->right - area->left));
+    }
+}
+
+static TextItem *RecordTextItem(RenderCore *core, TextItemKind kind, const RenderRect *cell, const RenderRect *bounds,
+                                const TTCHAR *text, int scrolling) {
+    if (!core->recordTextItems || core->textItemCount >= core->textItemCapacity) return NULL;
+    TextItem *item = &core->textItems[core->textItemCount++];
+    item->kind = kind;
+    item->cell = *cell;
+    item->bounds = *bounds;
+    item->text = text;
+    item->node = -1;
+    item->line = -1;
+    item->scrolling = scrolling;
+    return item;
+}
+
+static const TextRun *LookupTextRun(RenderCore *core, const TTCHAR *text, int len) {
+    return TextCacheLookup(core->textCache, text, len, core->fontHeight, core->dpi);
+}
+
+// clip 为本次绘制额外的裁剪矩形（可为 NULL）
+static void OutputTextRun(RenderCore *core, const TextRun *run, int x, int y, const RenderRect *clip, uint32_t rgb) {
+    RenderRect area = core->clip;
+    if (clip && !IntersectRenderRect(&area, &area, clip)) {
+        return;
+    }
+    RenderSurface *s = core->surface;
+    TextCacheBlit(core->textCache, run, s->pixels, s->coverage, s->width, s->height, s->stride, x, y,
+                  area.left, area.top, area.right, area.bottom, rgb);
+}
+
+static double ClampDouble(double value, double minValue, double maxValue) {
+    if (value < minValue) return minValue;
+    if (value > maxValue) return maxValue;
+    return value;
+}
+
+static int DayHasAnyClass(const RenderCore *core, int dayIndex) {
+    return core->indexValid && ScheduleIndexDayHasClass(&core->index, dayIndex);
+}
+
+// 以固定覆盖度铺满 rc 与当前裁剪的交集，之后绘制的文本叠加其上
+static void DrawHighlight(RenderCore *core, const RenderRect *rc) {
+    // 不在裁剪范围内也要记录，局部重绘后滚动文本仍需在其下方重绘底色
+    RecordTextItem(core, TEXT_ITEM_HIGHLIGHT, rc, rc, NULL, 0);
+
+    RenderRect area;
+    if (!IntersectRenderRect(&area, rc, &core->clip)) return;
+
+    RenderSurface *s = core->surface;
+    RenderRect surfaceRect = {0, 0, s->width, s->height};
+    if (!IntersectRenderRect(&area, &area, &surfaceRect)) return;
+
+    uint8_t row[256];
+    memset(row, HIGHLIGHT_COVERAGE, sizeof(row));
+    for (int y = area.top; y < area.bottom; ++y) {
+        for (int x = area.left; x < area.right; x += (int)sizeof(row)) {
+            size_t count = (size_t)MinInt(area.right - x, (int)sizeof(row));
+            size_t offset = (size_t)y * s->stride + x;
+            PixelBlendCoverage(s->pixels + offset, s->coverage + offset, row, count, HIGHLIGHT_RGB);
+        }
+    }
+}
+
+static void DrawHolidayText(RenderCore *core, const RenderRect *rc) {
+    static const TTCHAR text[] = TT_TEXT("放假");
+    const int len = 2;
+    const int spacing = 6;
+
+    int cellWidth = rc->right - rc->left;
+    int cellHeight = rc->bottom - rc->top;
+    if (cellWidth <= 0 || cellHeight <= 0) return;
+
+    const TextRun *charRun = LookupTextRun(core, text, 1);
+    if (!charRun) return;
+
+    int totalHeight = len * charRun->extentHeight + (len - 1) * spacing;
+    int startY = rc->top + (cellHeight - totalHeight) / 2;
+    int x = rc->left + (cellWidth - charRun->extentWidth) / 2;
+
+    for (int i = 0; i < len; ++i) {
+        int y = startY + i * (charRun->extentHeight + spacing);
+        const TextRun *run = LookupTextRun(core, &text[i], 1);
+        if (run) {
+            OutputTextRun(core, run, x, y, NULL, TEXT_COLOR_HOLIDAY);
+        }
+    }
+
+    RecordTextItem(core, TEXT_ITEM_HOLIDAY, rc, rc, NULL, 0);
+}
+
+// 绘制布局树中的一行：未溢出的文本居中，溢出的文本在单元格内按时间滚动显示
+static void DrawLayoutLine(RenderCore *core, int nodeIndex, int lineIndex) {
+    const LayoutNode *node = &core->layout.nodes[nodeIndex];
+    const LayoutLine *line = &node->lines[lineIndex];
+    // 位图仍从文本段缓存取回（可能已被淘汰后重新光栅化）；尺寸与溢出已在布局时确定
+    const TextRun *run = LookupTextRun(core, line->text, line->length);
+    if (!run) return;
+
+    const RenderRect *rc = &node->rect;
+    int cellWidth = rc->right - rc->left;
+    int y = rc->top + line->yOffset;
+    uint32_t rgb = line->color;
+
+    if (!line->overflow) {
+        int x = rc->left + (cellWidth - run->extentWidth) / 2;
+        OutputTextRun(core, run, x, y, NULL, rgb);
+        // 字形可能略微超出测量宽度，记录范围时留出余量
+        RenderRect bounds = {x - DAMAGE_MARGIN, y, x + run->extentWidth + DAMAGE_MARGIN, y + run->extentHeight};
+        TextItem *item = RecordTextItem(core, TEXT_ITEM_LINE, rc, &bounds, NULL, 0);
+        if (item) {
+            item->node = nodeIndex;
+            item->line = lineIndex;
+        }
+        return;
+    }
+
+    RenderRect clipRect = {rc->left, y, rc->right, y + run->extentHeight};
+    TextItem *item = RecordTextItem(core, TEXT_ITEM_LINE, rc, &clipRect, NULL, 1);
+    if (item) {
+        item->node = nodeIndex;
+        item->line = lineIndex;
+    }
+
+    const double pauseDurationMs = 1000.0;
+    const double pixelsPerMs = RENDER_MARQUEE_PIXELS_PER_SECOND / 1000.0;
+
+    double alignLeft = (double)rc->left;
+    double alignRight = (double)(rc->right - run->extentWidth);
+    double travelPixels = alignLeft - alignRight;
+    if (travelPixels < 0.0) travelPixels = 0.0;
+
+    double travelMs = travelPixels / pixelsPerMs;
+    if (travelMs < 1.0) travelMs = 1.0;
+
+    double cycleMs = 2.0 * (travelMs + pauseDurationMs);
+
+    // 滚动相位以首次绘制滚动文本的时刻为起点
+    if (!core->scrollEpochSet) {
+        core->scrollEpoch = core->timeMs;
+        core->scrollEpochSet = 1;
+    }
+
+    double elapsedMs = (double)(core->timeMs - core->scrollEpoch);
+    double phase = fmod(elapsedMs, cycleMs);
+    double currentX;
+
+    if (phase < travelMs) {
+        currentX = alignLeft - phase * pixelsPerMs;
+    } else if (phase < travelMs + pauseDurationMs) {
+        currentX = alignRight;
+    } else if (phase < travelMs + pauseDurationMs + travelMs) {
+        double t = phase - (travelMs + pauseDurationMs);
+        currentX = alignRight + t * pixelsPerMs;
+    } else {
+        currentX = alignLeft;
+    }
+
+    currentX = ClampDouble(currentX, alignRight, alignLeft);
+
+    int drawX = (int)floor(currentX + 0.5);
+    OutputTextRun(core, run, drawX, y, &clipRect, rgb);
+}
+
+static void DrawOverlayLine(RenderCore *core, const RenderRect *bounds, const TTCHAR *line) {
+    const TextRun *run = LookupTextRun(core, line, TextLength(line));
+    if (run) {
+        OutputTextRun(core, run, bounds->left + 2, bounds->top, NULL, OVERLAY_RGB);
+    }
+}
+
+// 在左上角逐行绘制叠加文本；文本复制到 core->overlay，滚动帧重绘时仍可引用
+static void DrawOverlay(RenderCore *core, const TTCHAR *text) {
+    int length = 0;
+    while (text[length] && length < OVERLAY_MAX_CHARS - 1) {
+        core->overlay[length] = text[length];
+        length++;
+    }
+    core->overlay[length] = 0;
+
+    int margin = RenderScaleForDpi(6, core->dpi);
+    int y = margin;
+    int lines = 0;
+    TTCHAR *line = core->overlay;
+    for (int i = 0; i <= length && lines < OVERLAY_MAX_LINES; ++i) {
+        if (core->overlay[i] != '\n' && core->overlay[i] != 0) continue;
+        core->overlay[i] = 0;
+        int lineLength = (int)(&core->overlay[i] - line);
+        const TextRun *run = (lineLength > 0) ? LookupTextRun(core, line, lineLength) : NULL;
+        if (run) {
+            RenderRect bounds = {margin - 2, y, margin + run->extentWidth + 2, y + run->extentHeight};
+            DrawOverlayLine(core, &bounds, line);
+            RecordTextItem(core, TEXT_ITEM_OVERLAY, &bounds, &bounds, line, 0);
+            y += run->extentHeight;
+        }
+        line = &core->overlay[i + 1];
+        lines++;
+    }
+}
+
+static int LayoutMatches(const LayoutTree *layout, int width, int height, const RenderFrameParams *params,
+                         unsigned int scheduleVersion) {
+    return layout->valid && layout->width == width && layout->height == height &&
+           layout->viewMode == params->viewMode && layout->dpi == params->dpi &&
+           layout->today == params->today && layout->scheduleVersion == scheduleVersion;
+}
+
+static LayoutNode *AddLayoutNode(LayoutTree *layout, LayoutNodeKind kind, int day, int slot, const RenderRect *rect) {
+    if (layout->nodeCount >= layout->nodeCapacity) return NULL;
+    LayoutNode *node = &layout->nodes[layout->nodeCount++];
+    node->kind = kind;
+    node->day = day;
+    node->slot = slot;
+    node->rect = *rect;
+    node->lineCount = 0;
+    return node;
+}
+
+// 按 ID 取得字符串的测量结果，首次使用时经文本段缓存测量；失败返回 0
+static int MeasureString(RenderCore *core, uint16_t id, StringExtent *out) {
+    StringExtent *cached = (id < core->stringExtentCapacity) ? &core->stringExtents[id] : NULL;
+    if (cached && cached->length > 0) {
+        *out = *cached;
+        return 1;
+    }
+
+    const TTCHAR *text = ScheduleString(core->schedule, id);
+    int len = text ? TextLength(text) : 0;
+    if (len <= 0) return 0;
+    const TextRun *run = LookupTextRun(core, text, len);
+    if (!run) return 0;
+
+    out->length = len;
+    out->extentWidth = run->extentWidth;
+    out->extentHeight = run->extentHeight;
+    if (cached) {
+        *cached = *out;
+    }
+    return 1;
+}
+
+// 测量一行文本并挂到单元格下；测量失败或单元格没有宽度的行不绘制
+static void AddLayoutLine(RenderCore *core, LayoutNode *node, LayoutField field, uint16_t id,
+                          int yOffset, uint32_t color) {
+    if (!id || node->lineCount >= LAYOUT_CELL_LINES) return;
+
+    StringExtent extent;
+    if (!MeasureString(core, id, &extent)) return;
+
+    int cellWidth = node->rect.right - node->rect.left;
+    if (cellWidth <= 0) return;
+
+    LayoutLine *line = &node->lines[node->lineCount++];
+    line->text = ScheduleString(core->schedule, id);
+    line->length = extent.length;
+    line->field = field;
+    line->yOffset = yOffset;
+    line->color = color;
+    line->extentWidth = extent.extentWidth;
+    line->extentHeight = extent.extentHeight;
+    line->overflow = extent.extentWidth > cellWidth;
+    if (line->overflow) {
+        core->layout.hasOverflow = 1;
+    }
+}
+
+// 测量单元格的各行文本（建立布局与热重载时使用）
+static void MeasureClassCell(RenderCore *core, LayoutNode *node) {
+    node->lineCount = 0;
+    // 字符串直接指向课程表映射内存
+    uint16_t nameId = ScheduleNameId(core->schedule, node->day, node->slot);
+    if (!nameId) return;
+    // 课程名称与位置信息均居中显示
+    AddLayoutLine(core, node, LAYOUT_FIELD_NAME, nameId, 10, TEXT_COLOR_NAME);
+    AddLayoutLine(core, node, LAYOUT_FIELD_LOCATION, ScheduleLocationId(core->schedule, node->day, node->slot),
+                  35, TEXT_COLOR_LOCATION);
+}
+
+static void AddClassCell(RenderCore *core, const RenderRect *cellRect, int day, int slot) {
+    LayoutTree *layout = &core->layout;
+    LayoutNode *node = AddLayoutNode(layout, LAYOUT_NODE_CELL, day, slot, cellRect);
+    if (!node) return;
+    int cell = day * core->schedule->classes + slot;
+    if (cell < core->cellCapacity) {
+        layout->cellNodes[cell] = (int)(node - layout->nodes);
+    }
+    MeasureClassCell(core, node);
+}
+
+// 按当前尺寸、视图、DPI 与日期建立布局树（需在 BeginDraw 之后，测量依赖字体高度）
+static void BuildLayout(RenderCore *core, RenderRect rc, const RenderFrameParams *params) {
+    LayoutTree *layout = &core->layout;
+    layout->nodeCount = 0;
+    layout->hasOverflow = 0;
+    if (core->extentFontHeight != core->fontHeight || core->extentDpi != core->dpi) {
+        ResetStringExtents(core);
+        core->extentFontHeight = core->fontHeight;
+        core->extentDpi = core->dpi;
+    }
+
+    // 网格尺寸取自课程表
+    const Schedule *schedule = core->schedule;
+    int days = schedule ? schedule->days : 0;
+    int classes = schedule ? schedule->classes : 0;
+    int today = params->today;
+    for (int i = 0; i < days * classes && i < core->cellCapacity; ++i) {
+        layout->cellNodes[i] = -1;
+    }
+
+    if (params->viewMode == 0) {
+        // ==== 日视图 ====
+        if (!DayHasAnyClass(core, today)) {
+            AddLayoutNode(layout, LAYOUT_NODE_HOLIDAY, today, -1, &rc);
+        } else {
+            int cellH = (rc.bottom - rc.top) / classes;
+            for (int i=0; i<classes; i++) {
+                RenderRect cellRect = {rc.left, rc.top + i*cellH, rc.right, rc.top + (i+1)*cellH};
+                AddClassCell(core, &cellRect, today, i);
+            }
+        }
+    } else if (days > 0 && classes > 0) {
+        // ==== 周视图 ====
+        int cellH = (rc.bottom - rc.top) / classes;
+        int cellW = (rc.right - rc.left) / days;
+
+        for (int d=0; d<days; d++) {
+            RenderRect columnRect = {rc.left + d*cellW, rc.top, rc.left + (d+1)*cellW, rc.bottom};
+            if (!DayHasAnyClass(core, d)) {
+                AddLayoutNode(layout, LAYOUT_NODE_HOLIDAY, d, -1, &columnRect);
+                continue;
+            }
+
+            for (int i=0; i<classes; i++) {
+                RenderRect cellRect = {columnRect.left, rc.top + i*cellH, columnRect.right, rc.top + (i+1)*cellH};
+                AddClassCell(core, &cellRect, d, i);
+            }
+        }
+    }
+
+    layout->valid = 1;
+    core->layoutVersion++;
+    layout->width = rc.right - rc.left;
+    layout->height = rc.bottom - rc.top;
+    layout->viewMode = params->viewMode;
+    layout->dpi = params->dpi;
+    layout->today = today;
+    layout->scheduleVersion = core->scheduleVersion;
+}
+
+// 绘制课程表：遍历布局树，只有当前节次底色与滚动相位逐帧变化
+// nodeItems 不为 NULL 时记下每个节点的第一条文本记录的下标
+static void DrawTimetable(RenderCore *core, int today, int currentPeriod, int *nodeItems) {
+    core->textItemCount = 0;
+
+    const LayoutTree *layout = &core->layout;
+    for (int n = 0; n < layout->nodeCount; ++n) {
+        const LayoutNode *node = &layout->nodes[n];
+        if (nodeItems) {
+            nodeItems[n] = core->textItemCount;
+        }
+        if (node->kind == LAYOUT_NODE_HOLIDAY) {
+            DrawHolidayText(core, &node->rect);
+            continue;
+        }
+
+        if (node->day == today && node->slot == currentPeriod) {
+            DrawHighlight(core, &node->rect);
+        }
+        for (int i = 0; i < node->lineCount; ++i) {
+            DrawLayoutLine(core, n, i);
+        }
+    }
+}
+
+static void BeginDraw(RenderCore *core, RenderSurface *surface, const RenderFrameParams *params) {
+    core->surface = surface;
+    core->dpi = params->dpi;
+    core->timeMs = params->timeMs;
+    // 根据 DPI 缩放字体高度（负值表示字符高度，与 LOGFONT 约定一致）
+    core->fontHeight = -RenderScaleForDpi(12, params->dpi);
+    TextCacheBeginFrame(core->textCache);
+}
+
+static void EndDraw(RenderCore *core) {
+    TextCacheEndFrame(core->textCache);
+    core->surface = NULL;
+}
+
+// 今天正在上的课（无则为 SCHEDULE_NO_PERIOD），常数时间查询
+static int CurrentPeriod(const RenderCore *core, const RenderFrameParams *params) {
+    if (!core->indexValid) return SCHEDULE_NO_PERIOD;
+    return ScheduleIndexCurrentClass(&core->index, params->today, params->minuteOfDay);
+}
+
+// 在 region 内重绘与之相交的文本（按原绘制顺序），region 之外的像素不受影响
+static void RedrawTextRegion(RenderCore *core, const RenderRect *region) {
+    core->clip = *region;
+
+    for (int i = 0; i < core->textItemCount; ++i) {
+        const TextItem *item = &core->textItems[i];
+        if (!RectsIntersect(&item->bounds, region)) continue;
+
+        if (item->kind == TEXT_ITEM_HOLIDAY) {
+            DrawHolidayText(core, &item->cell);
+        } else if (item->kind == TEXT_ITEM_HIGHLIGHT) {
+            DrawHighlight(core, &item->cell);
+        } else if (item->kind == TEXT_ITEM_OVERLAY) {
+            DrawOverlayLine(core, &item->cell, item->text);
+        } else {
+            DrawLayoutLine(core, item->node, item->line);
+        }
+    }
+}
+
+static int StaticLayerMatches(const RenderCore *core, int width, int height) {
+    const StaticLayer *layer = &core->staticLayer;
+    return layer->valid && layer->width == width && layer->height == height &&
+           layer->layoutVersion == core->layoutVersion && layer->scheduleVersion == core->scheduleVersion &&
+           layer->backgroundVersion == core->backgroundVersion;
+}
+
+static int GrowBuffer(void **buffer, size_t *capacity, size_t needed, size_t elementSize) {
+    if (needed <= *capacity) return 1;
+    void *grown = realloc(*buffer, needed * elementSize);
+    if (!grown) return 0;
+    *buffer = grown;
+    *capacity = needed;
+    return 1;
+}
+
+size_t RenderCoreTrim(RenderCore *core) {
+    if (!core) return 0;
+    StaticLayer *layer = &core->staticLayer;
+    size_t released = sizeof(uint32_t) * (layer->pixelCapacity + layer->backgroundCapacity) +
+                      sizeof(TextItem) * (size_t)layer->itemCapacity + sizeof(int) * (size_t)layer->nodeCapacity;
+    free(layer->pixels);
+    free(layer->background);
+    free(layer->items);
+    free(layer->nodeItems);
+    // 键与版本一并清零，下一次完整渲染按未建立处理
+    memset(layer, 0, sizeof(*layer));
+    return released;
+}
+
+// 非默认背景的逐像素平面：尺寸、布局（网格线）或背景设置变化时重建；分配失败时退回纯色背景
+static void UpdateBackgroundPlane(RenderCore *core, int width, int height, const CornerTiles *tiles) {
+    StaticLayer *layer = &core->staticLayer;
+    if (!core->hasBackground) {
+        layer->backgroundReady = 0;
+        return;
+    }
+    if (layer->backgroundReady && layer->backgroundWidth == width && layer->backgroundHeight == height &&
+        layer->backgroundLayoutVersion == core->layoutVersion &&
+        layer->backgroundBuiltVersion == core->backgroundVersion) {
+        return;
+    }
+    layer->backgroundReady = 0;
+    if (!GrowBuffer((void**)&layer->background, &layer->backgroundCapacity, (size_t)width * height, sizeof(uint32_t))) {
+        return;
+    }
+    BuildBackgroundPlane(core, layer->background, width, height, tiles);
+    layer->backgroundReady = 1;
+    layer->backgroundWidth = width;
+    layer->backgroundHeight = height;
+    layer->backgroundLayoutVersion = core->layoutVersion;
+    layer->backgroundBuiltVersion = core->backgroundVersion;
+}
+
+// 滚动文本每帧都要逐区域重绘；其面积占窗口的比例过大（小窗口、高 DPI）时直接整帧绘制更快
+static int StaticLayerWorthwhile(const RenderCore *core, int width, int height) {
+    const LayoutTree *layout = &core->layout;
+    long long area = 0;
+    for (int n = 0; n < layout->nodeCount; ++n) {
+        const LayoutNode *node = &layout->nodes[n];
+        for (int i = 0; i < node->lineCount; ++i) {
+            if (node->lines[i].overflow) {
+                area += (long long)(node->rect.right - node->rect.left) * node->lines[i].extentHeight;
+            }
+        }
+    }
+    return area * STATIC_DYNAMIC_SHARE <= (long long)width * height;
+}
+
+// 为重建静态层分配缓冲（需在布局建立之后）；分配失败返回 0，本帧改为直接绘制
+static int PrepareStaticLayer(RenderCore *core, int width, int height) {
+    StaticLayer *layer = &core->staticLayer;
+    layer->valid = 0;
+    layer->width = width;
+    layer->height = height;
+
+    size_t itemCapacity = (size_t)layer->itemCapacity;
+    size_t nodeCapacity = (size_t)layer->nodeCapacity;
+    int ok = GrowBuffer((void**)&layer->pixels, &layer->pixelCapacity, (size_t)width * height, sizeof(uint32_t)) &&
+             GrowBuffer((void**)&layer->items, &itemCapacity, (size_t)core->textItemCapacity, sizeof(TextItem)) &&
+             GrowBuffer((void**)&layer->nodeItems, &nodeCapacity, (size_t)core->layout.nodeCapacity, sizeof(int));
+    layer->itemCapacity = (int)itemCapacity;
+    layer->nodeCapacity = (int)nodeCapacity;
+    return ok;
+}
+
+static void SaveStaticLayer(RenderCore *core, const RenderSurface *surface) {
+    StaticLayer *layer = &core->staticLayer;
+    for (int y = 0; y < surface->height; ++y) {
+        memcpy(layer->pixels + (size_t)y * surface->width, surface->pixels + (size_t)y * surface->stride,
+               sizeof(uint32_t) * (size_t)surface->width);
+    }
+    layer->itemCount = MinInt(core->textItemCount, layer->itemCapacity);
+    memcpy(layer->items, core->textItems, sizeof(TextItem) * (size_t)layer->itemCount);
+    layer->layoutVersion = core->layoutVersion;
+    layer->scheduleVersion = core->scheduleVersion;
+    layer->backgroundVersion = core->backgroundVersion;
+    layer->valid = 1;
+}
+
+// 复制静态层的像素与文本记录；表面的覆盖度层之后只在重新合成的区域内清空使用
+static void RestoreStaticLayer(RenderCore *core, RenderSurface *surface) {
+    const StaticLayer *layer = &core->staticLayer;
+    for (int y = 0; y < surface->height; ++y) {
+        memcpy(surface->pixels + (size_t)y * surface->stride, layer->pixels + (size_t)y * surface->width,
+               sizeof(uint32_t) * (size_t)surface->width);
+    }
+    core->textItemCount = MinInt(layer->itemCount, core->textItemCapacity);
+    memcpy(core->textItems, layer->items, sizeof(TextItem) * (size_t)core->textItemCount);
+}
+
+// 在静态层之上绘制逐帧变化的内容：当前节次底色、滚动文本与叠加文本
+// 各自的区域依次清空覆盖度、按原顺序重绘相交的全部文本并与背景合成，结果与整帧绘制逐像素一致
+static void DrawDynamicContent(RenderCore *core, RenderSurface *surface, const CornerTiles *tiles,
+                               const RenderFrameParams *params, int currentPeriod) {
+    const LayoutTree *layout = &core->layout;
+    const Schedule *schedule = core->schedule;
+    int cell = (schedule && currentPeriod >= 0 && currentPeriod < schedule->classes)
+               ? params->today * schedule->classes + currentPeriod : -1;
+    int node = (cell >= 0 && cell < core->cellCapacity && params->today < schedule->days)
+               ? layout->cellNodes[cell] : -1;
+    if (node >= 0 && core->textItemCount < core->textItemCapacity) {
+        // 底色插在该单元格第一段文本之前，与 DrawTimetable 的绘制顺序一致
+        int at = core->staticLayer.nodeItems[node];
+        memmove(&core->textItems[at + 1], &core->textItems[at], sizeof(TextItem) * (size_t)(core->textItemCount - at));
+        core->textItemCount++;
+        TextItem *item = &core->textItems[at];
+        item->kind = TEXT_ITEM_HIGHLIGHT;
+        item->cell = layout->nodes[node].rect;
+        item->bounds = item->cell;
+        item->text = NULL;
+        item->node = -1;
+        item->line = -1;
+        item->scrolling = 0;
+    }
+    if (params->overlayText) {
+        // 裁剪为空：只记录各行的范围，绘制留给下面的区域重绘
+        RenderRect none = {0, 0, 0, 0};
+        core->clip = none;
+        core->recordTextItems = 1;
+        DrawOverlay(core, params->overlayText);
+        core->recordTextItems = 0;
+    }
+
+    RenderRect surfaceRect = {0, 0, surface->width, surface->height};
+    for (int i = 0; i < core->textItemCount; ++i) {
+        const TextItem *item = &core->textItems[i];
+        int dynamic = item->scrolling || item->kind == TEXT_ITEM_HIGHLIGHT || item->kind == TEXT_ITEM_OVERLAY;
+        RenderRect region;
+        if (!dynamic || !IntersectRenderRect(&region, &item->bounds, &surfaceRect)) continue;
+
+        ClearCoverageRect(surface->coverage, surface->stride, &region);
+        RedrawTextRegion(core, &region);
+        CompositeArea(core, surface, tiles, &region);
+    }
+}
+
+void RenderCoreDrawFrame(RenderCore *core, RenderSurface *surface, const RenderFrameParams *params) {
+    if (!core || !surface || !params) return;
+    int width = surface->width;
+    int height = surface->height;
+    core->frameState.valid = 0;
+    if (!surface->pixels || !surface->coverage || width <= 0 || height <= 0 || surface->stride < width) return;
+
+    // 圆角贴片按 (半径, DPI, alpha) 缓存，半径随 DPI 缩放（最小 4 像素）
+    const CornerTiles *cornerTiles = CornerTilesGet(CORNER_RADIUS, params->dpi, (uint8_t)WINDOW_ALPHA);
+    if (!cornerTiles) {
+        return;
+    }
+
+    RenderRect drawRect = {0, 0, width, height};
+    BeginDraw(core, surface, params);
+    int currentPeriod = CurrentPeriod(core, params);
+    if (!LayoutMatches(&core->layout, width, height, params, core->scheduleVersion)) {
+        BuildLayout(core, drawRect, params);
+    }
+
+    UpdateBackgroundPlane(core, width, height, cornerTiles);
+
+    double stageStart;
+    int layered = StaticLayerMatches(core, width, height);
+    if (layered) {
+        stageStart = FrameTraceBegin();
+        RestoreStaticLayer(core, surface);
+        FrameTraceEnd(FRAME_STAGE_STATIC, stageStart);
+    } else {
+        // 重建静态层：不画当前节次底色与叠加文本，它们与滚动文本一起在之后按区域合成
+        // 滚动文本过多或分配失败时本帧直接绘制全部内容
+        layered = StaticLayerWorthwhile(core, width, height) && PrepareStaticLayer(core, width, height);
+
+        // 清空文本覆盖度层；背景在最后的合成中一次写入，无需预先填充
+        stageStart = FrameTraceBegin();
+        if (surface->stride == width) {
+            memset(surface->coverage, 0, (size_t)width * height);
+        } else {
+            ClearCoverageRect(surface->coverage, surface->stride, &drawRect);
+        }
+        FrameTraceEnd(FRAME_STAGE_CLEAR, stageStart);
+
+        // 文本写入覆盖度层（颜色写入像素的 RGB），同时记录每段文本供滚动帧局部重绘
+        stageStart = FrameTraceBegin();
+        core->clip = drawRect;
+        core->recordTextItems = 1;
+        DrawTimetable(core, params->today, layered ? SCHEDULE_NO_PERIOD : currentPeriod,
+                      layered ? core->staticLayer.nodeItems : NULL);
+        if (!layered && params->overlayText) {
+            DrawOverlay(core, params->overlayText);
+        }
+        core->recordTextItems = 0;
+        FrameTraceEnd(FRAME_STAGE_TEXT, stageStart);
+
+        // 一次遍历合成文本与背景：文本边缘得到正确的部分 alpha
+        // 只有四个角的正方形需要平滑遮罩，其余部分整段使用基准 alpha
+        stageStart = FrameTraceBegin();
+        CompositeArea(core, surface, cornerTiles, &drawRect);
+        if (layered) {
+            SaveStaticLayer(core, surface);
+        }
+        FrameTraceEnd(FRAME_STAGE_COMPOSITE, stageStart);
+    }
+
+    if (layered) {
+        stageStart = FrameTraceBegin();
+        DrawDynamicContent(core, surface, cornerTiles, params, currentPeriod);
+        FrameTraceEnd(FRAME_STAGE_TEXT, stageStart);
+    }
+    EndDraw(core);
+
+    core->frameState.valid = 1;
+    core->frameState.width = width;
+    core->frameState.height = height;
+    core->frameState.viewMode = params->viewMode;
+    core->frameState.dpi = params->dpi;
+    core->frameState.today = params->today;
+    core->frameState.currentPeriod = currentPeriod;
+    core->damagePending = 0;
+}
+
+// 单元格及其文本可能写入的范围（文本可能超出单元格下沿）并入待重绘区域
+static void AddCellDamage(RenderCore *core, const LayoutNode *node) {
+    RenderRect area = {MaxInt(0, node->rect.left - DAMAGE_MARGIN), node->rect.top,
+                       MinInt(core->layout.width, node->rect.right + DAMAGE_MARGIN), node->rect.bottom};
+    for (int i = 0; i < node->lineCount; ++i) {
+        const LayoutLine *line = &node->lines[i];
+        area.bottom = MaxInt(area.bottom, node->rect.top + line->yOffset + line->extentHeight);
+    }
+    area.bottom = MinInt(area.bottom, core->layout.height);
+
+    if (core->damagePending) {
+        UnionRenderRect(&core->damage, &core->damage, &area);
+    } else {
+        core->damage = area;
+        core->damagePending = 1;
+    }
+}
+
+int RenderCoreUpdateSchedule(RenderCore *core, const Schedule *schedule) {
+    if (!core) return -1;
+    LayoutTree *layout = &core->layout;
+    const Schedule *previous = core->schedule;
+    int changed = -1;
+    if (previous && schedule && layout->valid && core->indexValid &&
+        schedule->days * schedule->classes <= core->cellCapacity) {
+        changed = ScheduleDiff(previous, schedule, core->cellChanged);
+    }
+
+    // 某天由有课变为无课（或相反）时整列的布局改变，与网格尺寸变化一样需要重建
+    ScheduleIndex index;
+    int indexValid = (changed >= 0) ? BuildScheduleIndex(&index, schedule) : 0;
+    for (int d = 0; indexValid && d < schedule->days; ++d) {
+        if (!ScheduleIndexDayHasClass(&index, d) != !DayHasAnyClass(core, d)) {
+            ScheduleIndexRelease(&index);
+            indexValid = 0;
+        }
+    }
+    if (!indexValid) {
+        RenderCoreSetSchedule(core, schedule);
+        return -1;
+    }
+
+    ScheduleIndexRelease(&core->index);
+    core->index = index;
+    core->schedule = schedule;
+    core->scheduleVersion++;
+    layout->scheduleVersion = core->scheduleVersion;
+    ResetStringExtents(core);
+
+    // 各行改为指向新课程表的字符串；只有内容变化的单元格重新测量，其新旧文本范围并入待重绘区域
+    int classes = schedule->classes;
+    int visible = 0;
+    layout->hasOverflow = 0;
+    for (int n = 0; n < layout->nodeCount; ++n) {
+        LayoutNode *node = &layout->nodes[n];
+        if (node->kind != LAYOUT_NODE_CELL) continue;
+
+        if (core->cellChanged[node->day * classes + node->slot]) {
+            AddCellDamage(core, node);
+            MeasureClassCell(core, node);
+            AddCellDamage(core, node);
+            visible++;
+            continue;
+        }
+
+        for (int i = 0; i < node->lineCount; ++i) {
+            LayoutLine *line = &node->lines[i];
+            line->text = (line->field == LAYOUT_FIELD_NAME)
+                         ? ScheduleName(schedule, node->day, node->slot)
+                         : ScheduleLocation(schedule, node->day, node->slot);
+            if (line->overflow) {
+                layout->hasOverflow = 1;
+            }
+        }
+    }
+    return visible;
+}
+
+// 热重载后的待重绘区域：重新遍历布局树（裁剪到该区域）并重新记录全部文本，叠加文本保持不变
+static void RedrawDamage(RenderCore *core, RenderSurface *surface, int currentPeriod) {
+    RenderRect surfaceRect = {0, 0, surface->width, surface->height};
+    RenderRect region;
+    int visible = IntersectRenderRect(&region, &core->damage, &surfaceRect);  // 不可见时 region 为空，只重新记录
+
+    TextItem overlay[OVERLAY_MAX_LINES];
+    int overlayCount = 0;
+    for (int i = 0; i < core->textItemCount && overlayCount < OVERLAY_MAX_LINES; ++i) {
+        if (core->textItems[i].kind == TEXT_ITEM_OVERLAY) {
+            overlay[overlayCount++] = core->textItems[i];
+        }
+    }
+
+    if (visible) {
+        ClearCoverageRect(surface->coverage, surface->stride, &region);
+    }
+    core->clip = region;
+    core->recordTextItems = 1;
+    DrawTimetable(core, core->layout.today, currentPeriod, NULL);
+    core->recordTextItems = 0;
+
+    for (int i = 0; i < overlayCount && core->textItemCount < core->textItemCapacity; ++i) {
+        core->textItems[core->textItemCount++] = overlay[i];
+        if (visible && RectsIntersect(&overlay[i].bounds, &region)) {
+            DrawOverlayLine(core, &overlay[i].cell, overlay[i].text);
+        }
+    }
+}
+
+// 滚动帧：只重新光栅化溢出文本所在的裁剪矩形（热重载后另加内容变化的区域）
+int RenderCoreDrawMarquee(RenderCore *core, RenderSurface *surface, const RenderFrameParams *params,
+                          RenderRect *dirty) {
+    if (!core || !surface || !params || !dirty) return 0;
+    memset(dirty, 0, sizeof(*dirty));
+
+    int width = surface->width;
+    int height = surface->height;
+    const FrameState *fs = &core->frameState;
+
+    // 尺寸、视图、DPI 或日期变化时退回完整渲染
+    if (!fs->valid || (!RenderCoreHasOverflow(core) && !core->damagePending) || surface->stride < width ||
+        fs->width != width || fs->height != height ||
+        fs->viewMode != params->viewMode || fs->dpi != params->dpi ||
+        fs->today != params->today || fs->currentPeriod != CurrentPeriod(core, params)) {
+        return 0;
+    }
+
+    const CornerTiles *cornerTiles = CornerTilesGet(CORNER_RADIUS, params->dpi, (uint8_t)WINDOW_ALPHA);
+    if (!cornerTiles) {
+        return 1;
+    }
+
+    RenderRect surfaceRect = {0, 0, width, height};
+
+    double stageStart = FrameTraceBegin();
+    BeginDraw(core, surface, params);
+
+    int hasDirty = 0;
+    if (core->damagePending) {
+        RedrawDamage(core, surface, fs->currentPeriod);
+        RenderRect region;
+        if (IntersectRenderRect(&region, &core->damage, &surfaceRect)) {
+            CompositeArea(core, surface, cornerTiles, &region);
+            *dirty = region;
+            hasDirty = 1;
+        }
+        core->damagePending = 0;
+    }
+    for (int i = 0; i < core->textItemCount; ++i) {
+        if (!core->textItems[i].scrolling) continue;
+
+        RenderRect region;
+        if (!IntersectRenderRect(&region, &core->textItems[i].bounds, &surfaceRect)) continue;
+
+        // 每个区域依次：清空覆盖度、重绘相交文本、与背景合成
+        ClearCoverageRect(surface->coverage, surface->stride, &region);
+        RedrawTextRegion(core, &region);
+        CompositeArea(core, surface, cornerTiles, &region);
+
+        if (hasDirty) {
+            UnionRenderRect(dirty, dirty, &region);
+        } else {
+            *dirty = region;
+            hasDirty = 1;
+        }
+    }
+
+    EndDraw(core);
+    FrameTraceEnd(FRAME_STAGE_MARQUEE, stageStart);
+    return 1;
+}
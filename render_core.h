@@ -0,0 +1,102 @@
+#ifndef RENDER_CORE_H
+#define RENDER_CORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "timetable_data.h"
+#include "text_cache.h"
+#include "schedule.h"
+
+// 与平台无关的渲染核心：布局、文本覆盖度合成与圆角遮罩
+// 表面内存、文本光栅化与提交到窗口由平台后端负责（GDI：renderer.c / render_gdi.c，
+// 无头软件后端：render_soft.c），本模块可直接在 Linux 上用 gcc/clang 编译
+
+#define WINDOW_ALPHA     180
+#define CORNER_RADIUS    16
+
+// 滚动文本的速度；滚动位置按 timeMs 计算，与滚动帧率无关
+#define RENDER_MARQUEE_PIXELS_PER_SECOND 40
+
+// 0x00RRGGBB
+#define RENDER_RGB(r, g, b) (((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b))
+
+typedef struct {
+    int left;
+    int top;
+    int right;
+    int bottom;
+} RenderRect;
+
+// 渲染目标：预乘 BGRA 像素与同尺寸的文本覆盖度层，内存由后端分配
+// 可以是更大缓冲的左上角子矩形：stride 为每行的元素数（≥ width），像素与覆盖度层共用
+typedef struct {
+    uint32_t *pixels;
+    uint8_t *coverage;
+    int width;
+    int height;
+    int stride;
+} RenderSurface;
+
+typedef struct {
+    int viewMode;       // 0=日视图，1=周视图
+    int today;          // 0=周一
+    unsigned int dpi;   // 字体与圆角按此缩放
+    uint64_t timeMs;    // 单调时钟（毫秒），驱动滚动文本
+    int minuteOfDay;    // 本地时间的当天第几分钟，用于突出当前节次；-1 表示不突出
+    const TTCHAR *overlayText;  // 左上角的叠加文本（性能 HUD），'\n' 分行；NULL 表示无，仅完整渲染时读取
+} RenderFrameParams;
+
+// 静态背景：底色的垂直渐变与单元格之间的网格线，随布局预先合成到静态层，不增加逐帧开销
+typedef struct {
+    uint32_t topRgb;        // 0x00RRGGBB，窗口上沿与下沿的底色
+    uint32_t bottomRgb;
+    uint32_t gridRgb;
+    uint8_t gridAlpha;      // 网格线与底色的混合比例，0 表示不画网格线
+} RenderBackground;
+
+typedef struct RenderCore RenderCore;
+
+RenderCore *RenderCoreCreate(const TextBackend *textBackend);
+void RenderCoreDestroy(RenderCore *core);
+
+// 完整渲染一帧：复制预先合成的静态层（背景、圆角与课程文本，布局、课程表或背景变化时重建），
+// 再只在当前节次底色、滚动文本与叠加文本所在的区域重新合成
+void RenderCoreDrawFrame(RenderCore *core, RenderSurface *surface, const RenderFrameParams *params);
+
+// 滚动帧：只重绘溢出滚动文本所在区域（以及热重载后内容变化的单元格），dirty 返回受影响区域的并集
+// 返回 0 表示上一帧参数已失效（尺寸、视图、DPI、日期或当前节次变化），调用方应改为完整渲染
+// 返回 1 且 dirty 为空（left >= right）表示没有需要更新的像素
+int RenderCoreDrawMarquee(RenderCore *core, RenderSurface *surface, const RenderFrameParams *params,
+                          RenderRect *dirty);
+
+// 当前布局是否存在需要滚动显示的文本；由布局树记录，不必重新绘制即可查询
+int RenderCoreHasOverflow(const RenderCore *core);
+
+// 让上一帧参数失效，下一次滚动帧必定退回完整渲染
+void RenderCoreInvalidate(RenderCore *core);
+
+// 设置要绘制的课程表（调用方保证其在使用期间有效）；会让上一帧失效
+void RenderCoreSetSchedule(RenderCore *core, const Schedule *schedule);
+
+// 换用重新加载的课程表：与当前课程表逐格比较，只重新测量内容变化的单元格，
+// 其区域在下一次滚动帧中重绘；返回当前布局中内容变化的单元格数（为 0 时无需重绘）
+// 网格尺寸或某天是否有课发生变化、或尚未完整渲染过时退回 RenderCoreSetSchedule，返回 -1
+// 调用期间旧课程表须仍然有效，返回后即可释放；测量文本，须在绘制所在的线程调用
+int RenderCoreUpdateSchedule(RenderCore *core, const Schedule *schedule);
+
+// 从 minuteOfDay 起到下一次需要完整重绘（节次变化或跨天）的分钟数，至少为 1
+int RenderCoreMinutesUntilChange(const RenderCore *core, int minuteOfDay);
+
+// 设置静态背景；NULL 恢复默认的纯黑底色。下一次完整渲染时重建静态层
+void RenderCoreSetBackground(RenderCore *core, const RenderBackground *background);
+
+// 空闲时释放静态层与背景平面，返回释放的字节数；下一次完整渲染时重建
+// 布局、测量结果与文本段缓存保留，重建只是重新合成，无需再光栅化文本
+size_t RenderCoreTrim(RenderCore *core);
+
+TextCache *RenderCoreTextCache(RenderCore *core);
+
+// 按 DPI 缩放（与 MulDiv(value, dpi, 96) 一致）
+int RenderScaleForDpi(int value, unsigned int dpi);
+
+#endif // RENDER_CORE_H
@@ -0,0 +1,155 @@
+#include "render_gdi.h"
+#include "pixel_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_RUN_PAD_X 2
+
+// 未命中时在此临时表面上光栅化
+static HDC g_scratchDC = NULL;
+static HBITMAP g_scratchBitmap = NULL;
+static uint32_t *g_scratchBits = NULL;
+static int g_scratchWidth = 0;
+static int g_scratchHeight = 0;
+
+// 按高度缓存的字体（DPI 变化时重建）
+static HFONT g_font = NULL;
+static int g_fontHeight = 0;
+
+static BOOL EnsureScratchSurface(int width, int height) {
+    if (!g_scratchDC) {
+        g_scratchDC = CreateCompatibleDC(NULL);
+        if (!g_scratchDC) return FALSE;
+        SetBkMode(g_scratchDC, TRANSPARENT);
+        SetTextColor(g_scratchDC, RGB(255, 255, 255));
+    }
+    if (g_scratchBitmap && width <= g_scratchWidth && height <= g_scratchHeight) {
+        return TRUE;
+    }
+
+    // 按需增大，避免频繁重建
+    width = max(width, g_scratchWidth);
+    height = max(height, g_scratchHeight);
+
+    BITMAPINFO bmi = {0};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height; // top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void *bits = NULL;
+    HBITMAP bitmap = CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!bitmap || !bits) {
+        if (bitmap) DeleteObject(bitmap);
+        return FALSE;
+    }
+
+    SelectObject(g_scratchDC, bitmap);
+    if (g_scratchBitmap) {
+        DeleteObject(g_scratchBitmap);
+    }
+    g_scratchBitmap = bitmap;
+    g_scratchBits = (uint32_t*)bits;
+    g_scratchWidth = width;
+    g_scratchHeight = height;
+    return TRUE;
+}
+
+static HFONT EnsureFont(int fontHeight) {
+    if (g_font && g_fontHeight == fontHeight) {
+        return g_font;
+    }
+
+    LOGFONT lf = {0};
+    lf.lfHeight = fontHeight;
+    lstrcpyW(lf.lfFaceName, L"微软雅黑"); // 中文字体
+    lf.lfQuality = ANTIALIASED_QUALITY;    // 灰度抗锯齿，覆盖度才能与任意背景混合
+    HFONT font = CreateFontIndirect(&lf);
+    if (!font) return NULL;
+
+    if (g_font) {
+        DeleteObject(g_font);
+    }
+    g_font = font;
+    g_fontHeight = fontHeight;
+    return font;
+}
+
+// 测量并光栅化：黑底白字绘制，取各通道最大值作为覆盖度（字体使用灰度抗锯齿）
+static int GdiRasterize(void *user, const TTCHAR *text, int len, int fontHeight, TextRun *run) {
+    (void)user;
+    const WCHAR *wtext = (const WCHAR*)text; // TTCHAR 与 WCHAR 同为 UTF-16
+    HFONT font = EnsureFont(fontHeight);
+    if (!font || !EnsureScratchSurface(1, 1)) return 0;
+
+    HFONT oldFont = (HFONT)SelectObject(g_scratchDC, font);
+    SIZE extent;
+    BOOL measured = GetTextExtentPoint32W(g_scratchDC, wtext, len, &extent);
+    if (!measured || extent.cx <= 0 || extent.cy <= 0) {
+        SelectObject(g_scratchDC, oldFont);
+        return 0;
+    }
+
+    int stripWidth = extent.cx + 2 * TEXT_RUN_PAD_X;
+    int stripHeight = extent.cy;
+    uint8_t *coverage = (uint8_t*)malloc((size_t)stripWidth * stripHeight);
+    if (!coverage || !EnsureScratchSurface(stripWidth, stripHeight)) {
+        free(coverage);
+        SelectObject(g_scratchDC, oldFont);
+        return 0;
+    }
+
+    for (int y = 0; y < stripHeight; ++y) {
+        PixelFill(g_scratchBits + (size_t)y * g_scratchWidth, (size_t)stripWidth, 0);
+    }
+    TextOutW(g_scratchDC, TEXT_RUN_PAD_X, 0, wtext, len);
+    GdiFlush();
+
+    for (int y = 0; y < stripHeight; ++y) {
+        const uint32_t *src = g_scratchBits + (size_t)y * g_scratchWidth;
+        uint8_t *dst = coverage + (size_t)y * stripWidth;
+        for (int x = 0; x < stripWidth; ++x) {
+            uint32_t p = src[x];
+            uint32_t c = p & 0xFF;
+            c = max(c, (p >> 8) & 0xFF);
+            c = max(c, (p >> 16) & 0xFF);
+            dst[x] = (uint8_t)c;
+        }
+    }
+    SelectObject(g_scratchDC, oldFont);
+
+    run->extentWidth = extent.cx;
+    run->extentHeight = extent.cy;
+    run->padX = TEXT_RUN_PAD_X;
+    run->stripWidth = stripWidth;
+    run->stripHeight = stripHeight;
+    run->coverage = coverage;
+    return 1;
+}
+
+void RenderGdiTextBackend(TextBackend *backend) {
+    if (!backend) return;
+    backend->user = NULL;
+    backend->rasterize = GdiRasterize;
+}
+
+void RenderGdiRelease(void) {
+    if (g_scratchDC) {
+        DeleteDC(g_scratchDC);
+        g_scratchDC = NULL;
+    }
+    if (g_scratchBitmap) {
+        DeleteObject(g_scratchBitmap);
+        g_scratchBitmap = NULL;
+    }
+    g_scratchBits = NULL;
+    g_scratchWidth = 0;
+    g_scratchHeight = 0;
+    if (g_font) {
+        DeleteObject(g_font);
+        g_font = NULL;
+    }
+    g_fontHeight = 0;
+}
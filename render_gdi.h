@@ -0,0 +1,16 @@
+#ifndef RENDER_GDI_H
+#define RENDER_GDI_H
+
+#include <windows.h>
+#include "text_cache.h"
+
+// GDI 文本后端：在临时 DIB 上以黑底白字 TextOutW 光栅化，取各通道最大值作为覆盖度
+// 字体为“微软雅黑”灰度抗锯齿，按 fontHeight 缓存 HFONT
+
+// 填写后端回调；后端状态为模块内全局，只能在渲染线程使用
+void RenderGdiTextBackend(TextBackend *backend);
+
+// 释放临时表面与字体
+void RenderGdiRelease(void);
+
+#endif // RENDER_GDI_H
@@ -0,0 +1,115 @@
+#include "render_soft.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SOFT_RUN_PAD_X 2
+
+static int IsWideChar(TTCHAR ch) {
+    return ch >= 0x2E80;
+}
+
+static int GlyphAdvance(TTCHAR ch, int size) {
+    return IsWideChar(ch) ? size : size / 2 + 1;
+}
+
+static uint32_t HashChar(TTCHAR ch) {
+    uint32_t h = (uint32_t)ch * 2654435761u;
+    return h ^ (h >> 15);
+}
+
+// 方块字形：外框加按字符哈希点亮的 3x3 内部格子，边缘一像素为半覆盖以模拟抗锯齿
+static void DrawGlyph(uint8_t *strip, int stripWidth, int x0, int y0, int w, int h, TTCHAR ch) {
+    if (w < 3 || h < 3) return;
+    int right = x0 + w - 1;
+    int bottom = y0 + h - 1;
+
+    for (int x = x0; x <= right; ++x) {
+        strip[(size_t)y0 * stripWidth + x] = 255;
+        strip[(size_t)bottom * stripWidth + x] = 255;
+    }
+    for (int y = y0; y <= bottom; ++y) {
+        strip[(size_t)y * stripWidth + x0] = 255;
+        strip[(size_t)y * stripWidth + right] = 255;
+        if (right + 1 < stripWidth) {
+            strip[(size_t)y * stripWidth + right + 1] = 96;
+        }
+    }
+
+    int innerW = w - 2;
+    int innerH = h - 2;
+    uint32_t bits = HashChar(ch);
+    for (int cell = 0; cell < 9; ++cell) {
+        if (!(bits & (1u << cell))) continue;
+        int cx0 = x0 + 1 + (cell % 3) * innerW / 3;
+        int cx1 = x0 + 1 + (cell % 3 + 1) * innerW / 3;
+        int cy0 = y0 + 1 + (cell / 3) * innerH / 3;
+        int cy1 = y0 + 1 + (cell / 3 + 1) * innerH / 3;
+        for (int y = cy0; y < cy1; ++y) {
+            memset(strip + (size_t)y * stripWidth + cx0, 160, (size_t)(cx1 - cx0));
+        }
+    }
+}
+
+static int SoftRasterize(void *user, const TTCHAR *text, int len, int fontHeight, TextRun *run) {
+    (void)user;
+    int size = fontHeight < 0 ? -fontHeight : fontHeight;
+    if (size <= 0 || len <= 0) return 0;
+
+    int extentWidth = 0;
+    for (int i = 0; i < len; ++i) {
+        extentWidth += GlyphAdvance(text[i], size);
+    }
+    int extentHeight = size * 4 / 3;
+    int stripWidth = extentWidth + 2 * SOFT_RUN_PAD_X;
+    int stripHeight = extentHeight;
+
+    uint8_t *coverage = (uint8_t*)calloc((size_t)stripWidth * stripHeight, 1);
+    if (!coverage) return 0;
+
+    // 字形位于行内基线之上，上方留出与 GDI 内部行距相近的空白
+    int top = (extentHeight - size) / 2;
+    int x = SOFT_RUN_PAD_X;
+    for (int i = 0; i < len; ++i) {
+        int advance = GlyphAdvance(text[i], size);
+        if (text[i] != ' ') {
+            DrawGlyph(coverage, stripWidth, x + 1, top, advance - 2, size, text[i]);
+        }
+        x += advance;
+    }
+
+    run->extentWidth = extentWidth;
+    run->extentHeight = extentHeight;
+    run->padX = SOFT_RUN_PAD_X;
+    run->stripWidth = stripWidth;
+    run->stripHeight = stripHeight;
+    run->coverage = coverage;
+    return 1;
+}
+
+void RenderSoftTextBackend(TextBackend *backend) {
+    if (!backend) return;
+    backend->user = NULL;
+    backend->rasterize = SoftRasterize;
+}
+
+int RenderSoftSurfaceCreate(RenderSurface *surface, int width, int height) {
+    if (!surface || width <= 0 || height <= 0) return 0;
+    memset(surface, 0, sizeof(*surface));
+    surface->pixels = (uint32_t*)calloc((size_t)width * height, sizeof(uint32_t));
+    surface->coverage = (uint8_t*)calloc((size_t)width * height, 1);
+    if (!surface->pixels || !surface->coverage) {
+        RenderSoftSurfaceFree(surface);
+        return 0;
+    }
+    surface->width = width;
+    surface->height = height;
+    surface->stride = width;
+    return 1;
+}
+
+void RenderSoftSurfaceFree(RenderSurface *surface) {
+    if (!surface) return;
+    free(surface->pixels);
+    free(surface->coverage);
+    memset(surface, 0, sizeof(*surface));
+}
@@ -0,0 +1,16 @@
+#ifndef RENDER_SOFT_H
+#define RENDER_SOFT_H
+
+#include "render_core.h"
+
+// 无头软件后端：不依赖任何字体库，按字符编码生成确定性的方块字形
+// 同一输入在任何平台上得到逐字节相同的输出，用于 Linux 上的性能分析与黄金图像比对
+// CJK 字符宽度为字号，其余字符为字号一半加 1，行高为字号的 4/3
+
+void RenderSoftTextBackend(TextBackend *backend);
+
+// 分配 / 释放表面内存（malloc）；失败返回 0
+int RenderSoftSurfaceCreate(RenderSurface *surface, int width, int height);
+void RenderSoftSurfaceFree(RenderSurface *surface);
+
+#endif // RENDER_SOFT_H
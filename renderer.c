@@ -1,401 +1,1012 @@
 #include "renderer.h"
-#include "timetable_data.h"
+#include "render_core.h"
+#include "render_gdi.h"
+#include "schedule.h"
+#include "warm_start.h"
+#include "frame_trace.h"
 #include "sys_utils.h"
 #include <windows.h>
 #include <shellapi.h>
-#include <math.h>
-
-extern ClassInfo timetable[DAYS][CLASSES];
-
-static BOOL g_currentFrameHasOverflow = FALSE;
-static BOOL g_lastFrameHasOverflow = FALSE;
-
+#include <psapi.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+// 平台无关的布局与合成在 render_core.c；本文件负责 DIB 表面池、渲染线程与窗口提交
+// UI 线程只提交渲染请求并在帧完成后调用 UpdateLayeredWindow；光栅化在渲染线程完成
+// 渲染线程写入三块轮换表面之一，完成的帧通过原子交换交给 UI 线程，不加锁
+
+#define RENDER_SURFACE_COUNT 3   // 渲染中、待提交、提交中各一块，渲染线程总能拿到空闲表面
+#define PACING_EMA_WEIGHT    0.1
+#define HUD_TEXT_CHARS       512
+#define HUD_NOTE_CHARS       160
+
+typedef enum {
+    SURFACE_FREE = 0,
+    SURFACE_RENDERING,
+    SURFACE_READY,
+    SURFACE_PRESENTING
+} SurfaceState;
+
+// 表面按容量分配，渲染只使用左上角 width x height 的子矩形；窗口尺寸在容量内变化时不重新分配
 typedef struct {
     HBITMAP bitmap;
     void *bits;
+    uint8_t *coverage;  // 文本覆盖度层，与 bits 同尺寸
     int width;
     int height;
+    int capacityWidth;  // DIB 的实际尺寸，也是每行的像素数
+    int capacityHeight;
+    volatile LONG state;    // SurfaceState
+    BOOL fullFrame;         // FALSE 时只有 dirty 区域相对上一帧有变化
+    RECT dirty;
+    double requestMs;       // 对应请求的提交时刻，用于统计延迟
+    BOOL warm;              // 内容取自预热缓存，而不是渲染核心
 } LayerSurface;
 
-static LayerSurface g_layerSurface = {0};
-static HDC g_layerDC = NULL;
-
-static BOOL EnsureLayerSurface(int width, int height) {
-    if (width <= 0 || height <= 0) return FALSE;
+typedef enum {
+    RENDER_REQUEST_NONE = 0,
+    RENDER_REQUEST_MARQUEE,
+    RENDER_REQUEST_FULL
+} RenderRequestKind;
 
-    if (!g_layerDC) {
-        g_layerDC = CreateCompatibleDC(NULL);
-        if (!g_layerDC) {
-            return FALSE;
-        }
+typedef struct {
+    RenderRequestKind kind;
+    HWND hwnd;
+    int width;
+    int height;
+    RenderFrameParams params;
+    double requestMs;
+    int reserveWidth;   // 提交请求时预留的表面尺寸（动画期间），0 表示没有
+    int reserveHeight;
+} RenderRequest;
+
+typedef enum {
+    SURFACE_FIT_FAILED = 0,
+    SURFACE_FIT_KEPT,       // 尺寸未变
+    SURFACE_FIT_REUSED,     // 尺寸变化但容量足够
+    SURFACE_FIT_ALLOCATED
+} SurfaceFit;
+
+static LayerSurface g_surfaces[RENDER_SURFACE_COUNT];
+static volatile LONG g_readySurface = 0;     // 待提交表面的下标 + 1，0 表示没有
+static HDC g_layerDC = NULL;                 // 仅 UI 线程使用
+static BOOL g_windowStale = FALSE;           // 丢弃过帧，下一次须整窗提交（UI 线程）
+
+// 以下仅渲染线程使用
+static RenderCore *g_renderCore = NULL;
+static Schedule g_schedules[2];              // 热重载时新旧课程表交替使用
+static int g_activeSchedule = 0;
+static ULONGLONG g_scheduleWriteTime = 0;    // 已加载的 schedule.ttb 的修改时间与大小，0 表示使用内置课程表
+static ULONGLONG g_scheduleFileSize = 0;
+static BOOL g_scheduleLoaded = FALSE;
+static WarmStartKey g_warmKey = {0};         // 预热缓存文件中的帧的键与有效时段（已读取或已写入）
+static int g_warmFirstMinute = 0;
+static int g_warmEndMinute = 0;
+static BOOL g_warmStartTried = FALSE;
+static RenderRequest g_lastRequest = {0};    // 最近执行的请求，热重载后据此重绘
+static int g_lastRendered = -1;              // 内容为最新一帧的表面
+static TTCHAR g_hudText[HUD_TEXT_CHARS];
+
+// 渲染线程发布给 UI 线程的帧信息
+static volatile LONG g_frameOverflow = 0;
+static volatile LONG g_frameClock = -1;      // (帧的分钟 << 16) | 下一次内容变化的分钟，-1 表示尚未渲染
+
+static CRITICAL_SECTION g_requestLock;       // 保护 g_pending、表面预留、g_workerStats 与待提交帧的交接
+static RenderRequest g_pending = {0};
+static int g_reserveWidth = 0;
+static int g_reserveHeight = 0;
+static BOOL g_reservePending = FALSE;
+static char g_hudNote[HUD_NOTE_CHARS];       // UI 线程附加到 HUD 末尾的文本
+static BOOL g_trimPending = FALSE;           // UI 线程判定进入空闲，渲染线程在没有待处理请求时释放资源
+static HANDLE g_wakeEvent = NULL;
+static HANDLE g_workerThread = NULL;
+static volatile LONG g_workerQuit = 0;
+static volatile LONG g_hudEnabled = 0;
+static BOOL g_workerInitialized = FALSE;
+
+static RendererPacingStats g_workerStats = {0};   // 渲染线程部分
+static RendererPacingStats g_presentStats = {0};  // UI 线程部分
+static double g_lastPresentMs = 0.0;
+static double g_processStartMs = 0.0;             // RendererMarkProcessStart 的时刻，0 表示未记录
+static volatile LONG g_startupPresentUs = -1;     // 进程入口到首次提交（微秒），供 HUD 读取
+static volatile LONG g_startupWarm = 0;
+
+static double PacingNowMs(void) {
+    static LARGE_INTEGER freq = {0};
+    if (!freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
     }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+}
 
-    if (g_layerSurface.bitmap &&
-        (g_layerSurface.width != width || g_layerSurface.height != height)) {
-        DeleteObject(g_layerSurface.bitmap);
-        g_layerSurface.bitmap = NULL;
-        g_layerSurface.bits = NULL;
-        g_layerSurface.width = 0;
-        g_layerSurface.height = 0;
-    }
-
-    if (!g_layerSurface.bitmap) {
-        BITMAPINFO bmi = {0};
-        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = width;
-        bmi.bmiHeader.biHeight = -height; // top-down
-        bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 32;
-        bmi.bmiHeader.biCompression = BI_RGB;
-
-        void *bits = NULL;
-        HBITMAP bitmap = CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
-        if (!bitmap || !bits) {
-            if (bitmap) {
-                DeleteObject(bitmap);
-            }
-            return FALSE;
-        }
+static void PacingAccumulate(double *average, double sample, unsigned long long count) {
+    *average = (count <= 1) ? sample : *average + (sample - *average) * PACING_EMA_WEIGHT;
+}
 
-        g_layerSurface.bitmap = bitmap;
-        g_layerSurface.bits = bits;
-        g_layerSurface.width = width;
-        g_layerSurface.height = height;
+// 程序目录下名为 name 的文件；directory 非 NULL 时另外返回所在目录
+static BOOL GetProgramFilePath(const WCHAR *name, WCHAR *path, WCHAR *directory) {
+    DWORD len = GetModuleFileNameW(NULL, path, MAX_PATH);
+    if (len == 0 || len >= MAX_PATH) return FALSE;
+    WCHAR *slash = wcsrchr(path, L'\\');
+    if (!slash || (size_t)(slash - path) + wcslen(name) + 2 >= MAX_PATH) return FALSE;
+    if (directory) {
+        lstrcpynW(directory, path, (int)(slash - path) + 1);
     }
-
+    lstrcpyW(slash + 1, name);
     return TRUE;
 }
 
-static void UpdateOverflowFlag(BOOL overflowed) {
-    if (overflowed) {
-        g_currentFrameHasOverflow = TRUE;
-    }
+static BOOL GetSchedulePath(WCHAR *path, WCHAR *directory) {
+    return GetProgramFilePath(L"schedule.ttb", path, directory);
+}
+
+// 预热缓存 warm_start.bin，与 schedule.ttb 同在程序目录（UTF-8 路径）
+static BOOL GetWarmStartPath(char *utf8Path, int size) {
+    WCHAR path[MAX_PATH];
+    return GetProgramFilePath(L"warm_start.bin", path, NULL) &&
+           WideCharToMultiByte(CP_UTF8, 0, path, -1, utf8Path, size, NULL, NULL) != 0;
 }
 
-static double ClampDouble(double value, double minValue, double maxValue) {
-    if (value < minValue) return minValue;
-    if (value > maxValue) return maxValue;
-    return value;
+static BOOL ReadScheduleStamp(const WCHAR *path, ULONGLONG *writeTime, ULONGLONG *fileSize) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(path, GetFileExInfoStandard, &data)) return FALSE;
+    *writeTime = ((ULONGLONG)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    *fileSize = ((ULONGLONG)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    return TRUE;
 }
 
-static BOOL DayHasAnyClass(int dayIndex) {
-    if (dayIndex < 0 || dayIndex >= DAYS) {
+// 映射 path 指向的 .ttb，成功时记录其修改时间与大小
+static BOOL MapScheduleFile(const WCHAR *path, Schedule *schedule) {
+    ULONGLONG writeTime = 0;
+    ULONGLONG fileSize = 0;
+    char utf8Path[MAX_PATH * 3];
+    if (!ReadScheduleStamp(path, &writeTime, &fileSize) ||
+        !WideCharToMultiByte(CP_UTF8, 0, path, -1, utf8Path, sizeof(utf8Path), NULL, NULL) ||
+        !ScheduleMapFile(utf8Path, schedule)) {
         return FALSE;
     }
+    g_scheduleWriteTime = writeTime;
+    g_scheduleFileSize = fileSize;
+    return TRUE;
+}
 
-    for (int i = 0; i < CLASSES; ++i) {
-        if (timetable[dayIndex][i].name) {
-            return TRUE;
-        }
+// 优先映射程序目录下的 schedule.ttb，不存在或无效时使用内置课程表
+static void LoadSchedule(Schedule *schedule) {
+    WCHAR path[MAX_PATH];
+    if (GetSchedulePath(path, NULL) && MapScheduleFile(path, schedule)) {
+        return;
     }
-    return FALSE;
+    g_scheduleWriteTime = 0;
+    g_scheduleFileSize = 0;
+    ScheduleFromBuiltin(schedule);
 }
 
-static void DrawHolidayText(HDC hdc, const RECT *rc) {
-    if (!hdc || !rc) return;
-
-    const WCHAR text[] = L"放假";
-    const int len = 2;
-    const int spacing = 6;
+// 课程表在首次请求时加载；预热缓存按其哈希查找，因此可能先于渲染核心加载
+static const Schedule *EnsureSchedule(void) {
+    if (!g_scheduleLoaded) {
+        LoadSchedule(&g_schedules[g_activeSchedule]);
+        g_scheduleLoaded = TRUE;
+    }
+    return &g_schedules[g_activeSchedule];
+}
 
-    SIZE charSize = {0};
-    if (!GetTextExtentPoint32W(hdc, text, 1, &charSize)) {
-        return;
+static RenderCore *EnsureRenderCore(void) {
+    if (!g_renderCore) {
+        TextBackend backend;
+        RenderGdiTextBackend(&backend);
+        g_renderCore = RenderCoreCreate(&backend);
+        if (g_renderCore) {
+            RenderCoreSetSchedule(g_renderCore, EnsureSchedule());
+        }
     }
+    return g_renderCore;
+}
 
-    int cellWidth = rc->right - rc->left;
-    int cellHeight = rc->bottom - rc->top;
-    if (cellWidth <= 0 || cellHeight <= 0) return;
+static void FreeLayerSurface(LayerSurface *surface) {
+    if (surface->bitmap) {
+        DeleteObject(surface->bitmap);
+    }
+    free(surface->coverage);
+    surface->bitmap = NULL;
+    surface->bits = NULL;
+    surface->coverage = NULL;
+    surface->width = 0;
+    surface->height = 0;
+    surface->capacityWidth = 0;
+    surface->capacityHeight = 0;
+}
 
-    int totalHeight = len * charSize.cy + (len - 1) * spacing;
-    int startY = rc->top + (cellHeight - totalHeight) / 2;
-    int x = rc->left + (cellWidth - charSize.cx) / 2;
+// 按容量重新分配，原内容丢失
+static BOOL AllocateLayerSurface(LayerSurface *surface, int capacityWidth, int capacityHeight) {
+    FreeLayerSurface(surface);
+
+    BITMAPINFO bmi = {0};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = capacityWidth;
+    bmi.bmiHeader.biHeight = -capacityHeight; // top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void *bits = NULL;
+    HBITMAP bitmap = CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    uint8_t *coverage = (uint8_t*)malloc((size_t)capacityWidth * capacityHeight);
+    if (!bitmap || !bits || !coverage) {
+        if (bitmap) {
+            DeleteObject(bitmap);
+        }
+        free(coverage);
+        return FALSE;
+    }
 
-    COLORREF originalColor = GetTextColor(hdc);
-    SetTextColor(hdc, RGB(255, 215, 0));
+    surface->bitmap = bitmap;
+    surface->bits = bits;
+    surface->coverage = coverage;
+    surface->capacityWidth = capacityWidth;
+    surface->capacityHeight = capacityHeight;
+    return TRUE;
+}
 
-    for (int i = 0; i < len; ++i) {
-        WCHAR ch[2] = {text[i], 0};
-        int y = startY + i * (charSize.cy + spacing);
-        TextOutW(hdc, x, y, ch, 1);
+// 使表面可容纳 width x height：容量足够时只改变使用的子矩形，否则按所需与预留尺寸中较大者重新分配
+// 没有预留且容量超过所需两倍时（例如动画结束后换到了小视图）缩回实际尺寸
+static SurfaceFit FitLayerSurface(LayerSurface *surface, int width, int height,
+                                  int reserveWidth, int reserveHeight) {
+    if (width <= 0 || height <= 0) return SURFACE_FIT_FAILED;
+
+    BOOL fits = surface->bitmap && width <= surface->capacityWidth && height <= surface->capacityHeight;
+    BOOL oversized = fits && reserveWidth <= 0 && reserveHeight <= 0 &&
+                     (LONGLONG)surface->capacityWidth * surface->capacityHeight > 2LL * width * height;
+    if (fits && !oversized) {
+        if (surface->width == width && surface->height == height) {
+            return SURFACE_FIT_KEPT;
+        }
+        surface->width = width;
+        surface->height = height;
+        return SURFACE_FIT_REUSED;
     }
 
-    SetTextColor(hdc, originalColor);
-    UpdateOverflowFlag(FALSE);
+    if (!AllocateLayerSurface(surface, max(width, reserveWidth), max(height, reserveHeight))) {
+        return SURFACE_FIT_FAILED;
+    }
+    surface->width = width;
+    surface->height = height;
+    return SURFACE_FIT_ALLOCATED;
 }
 
-static BOOL DrawTextInternal(HDC hdc, const RECT *rc, const WCHAR *text, int yOffset) {
-    if (!hdc || !rc || !text) return FALSE;
-
-    int len = lstrlenW(text);
-    if (len <= 0) return FALSE;
+typedef BOOL (WINAPI *UpdateLayeredWindowIndirect_t)(HWND, const void*);
 
-    SIZE textSize;
-    if (!GetTextExtentPoint32W(hdc, text, len, &textSize)) return FALSE;
+// 与 UPDATELAYEREDWINDOWINFO 布局一致，避免依赖 _WIN32_WINNT >= 0x0600 的头文件
+typedef struct {
+    DWORD cbSize;
+    HDC hdcDst;
+    const POINT *pptDst;
+    const SIZE *psize;
+    HDC hdcSrc;
+    const POINT *pptSrc;
+    COLORREF crKey;
+    const BLENDFUNCTION *pblend;
+    DWORD dwFlags;
+    const RECT *prcDirty;
+} LayeredUpdateInfo;
+
+// 提交图层；dirty 非空时只提交该区域（系统不支持时退回整窗提交）
+static void SubmitLayer(HWND hwnd, int width, int height, const RECT *dirty) {
+    POINT ptSrc = {0,0};
+    SIZE sizeWnd = {width, height};
+    POINT ptDst;
+    RECT wndRect;
+    GetWindowRect(hwnd, &wndRect);
+    ptDst.x = wndRect.left;
+    ptDst.y = wndRect.top;
 
-    int cellWidth = rc->right - rc->left;
-    if (cellWidth <= 0) return FALSE;
+    BLENDFUNCTION bf = {0};
+    bf.BlendOp = AC_SRC_OVER;
+    bf.BlendFlags = 0;
+    bf.SourceConstantAlpha = 255;
+    bf.AlphaFormat = AC_SRC_ALPHA;
 
-    int y = rc->top + yOffset;
+    if (dirty) {
+        static UpdateLayeredWindowIndirect_t pUpdateIndirect = NULL;
+        static BOOL resolved = FALSE;
+        if (!resolved) {
+            HMODULE hUser32 = GetModuleHandleW(L"user32.dll");
+            if (hUser32) {
+                pUpdateIndirect = (UpdateLayeredWindowIndirect_t)GetProcAddress(hUser32, "UpdateLayeredWindowIndirect");
+            }
+            resolved = TRUE;
+        }
 
-    if (textSize.cx <= cellWidth) {
-        int x = rc->left + (cellWidth - textSize.cx) / 2;
-        TextOutW(hdc, x, y, text, len);
-        return FALSE;
+        if (pUpdateIndirect) {
+            LayeredUpdateInfo info = {0};
+            info.cbSize = sizeof(info);
+            info.pptDst = &ptDst;
+            info.psize = &sizeWnd;
+            info.hdcSrc = g_layerDC;
+            info.pptSrc = &ptSrc;
+            info.pblend = &bf;
+            info.dwFlags = ULW_ALPHA;
+            info.prcDirty = dirty;
+            if (pUpdateIndirect(hwnd, &info)) {
+                return;
+            }
+        }
     }
 
-    int saved = SaveDC(hdc);
-    if (saved > 0) {
-        IntersectClipRect(hdc, rc->left, y, rc->right, y + textSize.cy);
-    }
+    UpdateLayeredWindow(hwnd, NULL, &ptDst, &sizeWnd, g_layerDC, &ptSrc, 0, &bf, ULW_ALPHA);
+}
 
-    const double pixelsPerSecond = 40.0;
-    const double pauseDurationMs = 1000.0;
-    const double pixelsPerMs = (pixelsPerSecond > 0.0) ? (pixelsPerSecond / 1000.0) : 0.04;
+static void FillFrameParams(HWND hwnd, int viewMode, RenderFrameParams *params) {
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    params->viewMode = viewMode;
+    params->today = (st.wDayOfWeek + 6) % 7; // 周一=0
+    params->minuteOfDay = st.wHour * 60 + st.wMinute;
+    params->dpi = GetWindowDpi(hwnd);
+    params->timeMs = GetTickCount64();
+    params->overlayText = NULL;
+}
 
-    double alignLeft = (double)rc->left;
-    double alignRight = (double)(rc->right - textSize.cx);
-    double travelPixels = alignLeft - alignRight;
-    if (travelPixels < 0.0) travelPixels = 0.0;
+static RenderSurface LayerRenderSurface(const LayerSurface *layer) {
+    RenderSurface surface;
+    surface.pixels = (uint32_t*)layer->bits;
+    surface.coverage = layer->coverage;
+    surface.width = layer->width;
+    surface.height = layer->height;
+    surface.stride = layer->capacityWidth;
+    return surface;
+}
 
-    double travelMs = travelPixels / pixelsPerMs;
-    if (travelMs < 1.0) travelMs = 1.0;
+// ---- 渲染线程 ----
 
-    double cycleMs = 2.0 * (travelMs + pauseDurationMs);
+// 取一块空闲表面：优先复用内容为最新一帧的表面，滚动帧可直接在其上增量绘制
+static int AcquireSurface(void) {
+    if (g_lastRendered >= 0 &&
+        InterlockedCompareExchange(&g_surfaces[g_lastRendered].state, SURFACE_RENDERING, SURFACE_FREE) == SURFACE_FREE) {
+        return g_lastRendered;
+    }
+    for (int i = 0; i < RENDER_SURFACE_COUNT; ++i) {
+        if (InterlockedCompareExchange(&g_surfaces[i].state, SURFACE_RENDERING, SURFACE_FREE) == SURFACE_FREE) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void UnionDirty(RECT *dst, const RECT *src) {
+    if (src->left < dst->left) dst->left = src->left;
+    if (src->top < dst->top) dst->top = src->top;
+    if (src->right > dst->right) dst->right = src->right;
+    if (src->bottom > dst->bottom) dst->bottom = src->bottom;
+}
 
-    static ULONGLONG scrollEpoch = 0;
-    ULONGLONG tick = GetTickCount64();
-    if (scrollEpoch == 0) {
-        scrollEpoch = tick;
+// 交给 UI 线程；上一帧尚未被取走时由新帧替换，其变化区域并入新帧
+// 合并与交换都在 g_requestLock 内完成：RendererPresentFrame 也在锁内取帧，
+// 因此 UI 线程看到新帧时 fullFrame、dirty 与 requestMs 已包含被替换的帧
+static void PublishSurface(int index, HWND hwnd) {
+    LayerSurface *layer = &g_surfaces[index];
+    EnterCriticalSection(&g_requestLock);
+    LONG previous = g_readySurface;
+    if (previous) {
+        LayerSurface *dropped = &g_surfaces[previous - 1];
+        if (dropped->fullFrame) {
+            layer->fullFrame = TRUE;
+        } else if (!layer->fullFrame) {
+            UnionDirty(&layer->dirty, &dropped->dirty);
+        }
+        if (dropped->requestMs < layer->requestMs) {
+            layer->requestMs = dropped->requestMs;
+        }
+        InterlockedExchange(&dropped->state, SURFACE_FREE);
+        g_workerStats.framesDropped++;
     }
+    InterlockedExchange(&layer->state, SURFACE_READY);
+    InterlockedExchange(&g_readySurface, index + 1);
+    LeaveCriticalSection(&g_requestLock);
+    PostMessageW(hwnd, WM_RENDER_FRAME_READY, 0, 0);
+}
 
-    double elapsedMs = (double)(tick - scrollEpoch);
-    double phase = fmod(elapsedMs, cycleMs);
-    double currentX;
+static void FillWarmStartKey(const RenderRequest *request, WarmStartKey *key) {
+    key->scheduleHash = WarmStartScheduleHash(EnsureSchedule());
+    key->width = request->width;
+    key->height = request->height;
+    key->dpi = request->params.dpi;
+    key->viewMode = request->params.viewMode;
+    key->today = request->params.today;
+}
 
-    if (phase < travelMs) {
-        currentX = alignLeft - phase * pixelsPerMs;
-    } else if (phase < travelMs + pauseDurationMs) {
-        currentX = alignRight;
-    } else if (phase < travelMs + pauseDurationMs + travelMs) {
-        double t = phase - (travelMs + pauseDurationMs);
-        currentX = alignRight + t * pixelsPerMs;
-    } else {
-        currentX = alignLeft;
+// 冷启动的第一个请求：在建立字体、测量文本与布局之前，按课程表哈希、尺寸、DPI、视图与星期读取预热缓存，
+// 命中时把缓存的帧直接交给 UI 线程；真实的首帧随后照常渲染并替换它
+static void PresentWarmStart(const RenderRequest *request) {
+    if (g_warmStartTried) return;
+    g_warmStartTried = TRUE;
+    if (request->kind != RENDER_REQUEST_FULL || g_hudEnabled || request->params.minuteOfDay < 0) return;
+
+    char path[MAX_PATH * 3];
+    if (!GetWarmStartPath(path, sizeof(path))) return;
+    WarmStartKey key;
+    FillWarmStartKey(request, &key);
+
+    int index = AcquireSurface();
+    if (index < 0) return;
+    LayerSurface *layer = &g_surfaces[index];
+    if (FitLayerSurface(layer, request->width, request->height, request->reserveWidth, request->reserveHeight) ==
+            SURFACE_FIT_FAILED ||
+        !WarmStartLoad(path, &key, request->params.minuteOfDay, (uint32_t*)layer->bits, layer->capacityWidth)) {
+        InterlockedExchange(&layer->state, SURFACE_FREE);
+        return;
     }
+    // 记下文件中已有的帧，内容相同的首帧不再写回
+    g_warmKey = key;
+    g_warmFirstMinute = request->params.minuteOfDay;
+    g_warmEndMinute = request->params.minuteOfDay + 1;
+    // 表面内容不是渲染核心画的，滚动帧不能在其上增量绘制
+    if (g_lastRendered == index) g_lastRendered = -1;
+    layer->fullFrame = TRUE;
+    layer->warm = TRUE;
+    layer->requestMs = request->requestMs;
+    PublishSurface(index, request->hwnd);
+}
 
-    currentX = ClampDouble(currentX, alignRight, alignLeft);
+// 完整渲染的帧与缓存中的不同（课程表、尺寸、DPI、视图、星期变化，或已离开其有效时段）时写回缓存
+// 动画中间帧与带 HUD 的帧不写
+static void SaveWarmStart(const RenderRequest *request, const LayerSurface *layer, int firstMinute, int endMinute) {
+    if (request->reserveWidth > 0 || request->reserveHeight > 0 || g_hudEnabled || firstMinute < 0) return;
+    WarmStartKey key;
+    FillWarmStartKey(request, &key);
+    if (memcmp(&key, &g_warmKey, sizeof(key)) == 0 &&
+        firstMinute >= g_warmFirstMinute && firstMinute < g_warmEndMinute) {
+        return;
+    }
+    char path[MAX_PATH * 3];
+    if (!GetWarmStartPath(path, sizeof(path)) ||
+        !WarmStartSave(path, &key, firstMinute, endMinute, (const uint32_t*)layer->bits, layer->capacityWidth)) {
+        return;
+    }
+    g_warmKey = key;
+    g_warmFirstMinute = firstMinute;
+    g_warmEndMinute = endMinute;
+}
 
-    int drawX = (int)floor(currentX + 0.5);
-    TextOutW(hdc, drawX, y, text, len);
+static void ExecuteRequest(const RenderRequest *request) {
+    PresentWarmStart(request);
+    RenderCore *core = EnsureRenderCore();
+    if (!core) return;
+    g_lastRequest = *request;
+
+    double startMs = PacingNowMs();
+    double traceStart = FrameTraceBegin();
+    int index = AcquireSurface();
+    if (index < 0) {
+        RenderCoreInvalidate(core);
+        return;
+    }
+    LayerSurface *layer = &g_surfaces[index];
+    SurfaceFit fit = FitLayerSurface(layer, request->width, request->height,
+                                     request->reserveWidth, request->reserveHeight);
+    if (fit != SURFACE_FIT_KEPT && g_lastRendered == index) {
+        g_lastRendered = -1;
+    }
+    if (fit == SURFACE_FIT_FAILED) {
+        InterlockedExchange(&layer->state, SURFACE_FREE);
+        RenderCoreInvalidate(core);
+        return;
+    }
 
-    if (saved > 0) {
-        RestoreDC(hdc, saved);
+    // 滚动帧在最新一帧的内容上增量绘制；换了表面时先复制最新一帧
+    BOOL full = (request->kind == RENDER_REQUEST_FULL);
+    if (!full && index != g_lastRendered) {
+        const LayerSurface *latest = (g_lastRendered >= 0) ? &g_surfaces[g_lastRendered] : NULL;
+        if (latest && latest->width == layer->width && latest->height == layer->height) {
+            for (int y = 0; y < layer->height; ++y) {
+                memcpy((uint32_t*)layer->bits + (size_t)y * layer->capacityWidth,
+                       (const uint32_t*)latest->bits + (size_t)y * latest->capacityWidth,
+                       (size_t)layer->width * sizeof(uint32_t));
+                memcpy(layer->coverage + (size_t)y * layer->capacityWidth,
+                       latest->coverage + (size_t)y * latest->capacityWidth, (size_t)layer->width);
+            }
+        } else {
+            full = TRUE;
+        }
     }
 
-    return TRUE;
+    RenderSurface surface = LayerRenderSurface(layer);
+    RenderFrameParams params = request->params;
+    RenderRect dirtyArea = {0, 0, 0, 0};
+    if (!full && !RenderCoreDrawMarquee(core, &surface, &params, &dirtyArea)) {
+        full = TRUE;
+    }
+    if (full) {
+        // HUD 显示此前各帧的统计，只在完整渲染时更新
+        if (g_hudEnabled) {
+            FrameTraceSummary summary;
+            FrameTraceSummarize(&summary);
+            int length = FrameTraceFormatHud(&summary, g_hudText, HUD_TEXT_CHARS);
+            // 表面池：分配次数与复用次数（仅渲染线程写入，此处无需加锁）
+            char pool[192 + HUD_NOTE_CHARS];
+            int poolLength = snprintf(pool, sizeof(pool), "\npool alloc %llu reuse %llu",
+                                      g_workerStats.surfaceAllocations, g_workerStats.surfaceReuses);
+            // 空闲释放前后的工作集
+            if (g_workerStats.idleTrims > 0 && poolLength > 0 && poolLength < (int)sizeof(pool)) {
+                poolLength += snprintf(pool + poolLength, sizeof(pool) - poolLength, "\nmem %lu/%lu KB idle",
+                                       (unsigned long)(g_workerStats.activeWorkingSet / 1024),
+                                       (unsigned long)(g_workerStats.idleWorkingSet / 1024));
+            }
+            // 启动：进程入口到首次 UpdateLayeredWindow
+            LONG startupUs = g_startupPresentUs;
+            if (startupUs >= 0 && poolLength > 0 && poolLength < (int)sizeof(pool)) {
+                poolLength += snprintf(pool + poolLength, sizeof(pool) - poolLength, "\nstartup %.1f ms%s",
+                                       startupUs / 1000.0, g_startupWarm ? " warm" : "");
+            }
+            EnterCriticalSection(&g_requestLock);
+            if (g_hudNote[0] && poolLength > 0 && poolLength < (int)sizeof(pool)) {
+                snprintf(pool + poolLength, sizeof(pool) - poolLength, "\n%s", g_hudNote);
+            }
+            LeaveCriticalSection(&g_requestLock);
+            for (const char *p = pool; *p && length < HUD_TEXT_CHARS - 1; ++p) {
+                g_hudText[length++] = (TTCHAR)*p;
+            }
+            g_hudText[length] = 0;
+            params.overlayText = g_hudText;
+        }
+        RenderCoreDrawFrame(core, &surface, &params);
+    }
+    g_lastRendered = index;
+
+    int minute = request->params.minuteOfDay;
+    int nextChange = minute + RenderCoreMinutesUntilChange(core, minute);
+    InterlockedExchange(&g_frameOverflow, RenderCoreHasOverflow(core) ? 1 : 0);
+    InterlockedExchange(&g_frameClock, (minute >= 0) ? (LONG)((minute << 16) | nextChange) : -1);
+
+    FrameTraceEnd(FRAME_STAGE_FRAME, traceStart);
+    double renderMs = PacingNowMs() - startMs;
+    EnterCriticalSection(&g_requestLock);
+    g_workerStats.framesRendered++;
+    if (!full) g_workerStats.marqueeFrames++;
+    if (fit == SURFACE_FIT_ALLOCATED) g_workerStats.surfaceAllocations++;
+    if (fit == SURFACE_FIT_REUSED) g_workerStats.surfaceReuses++;
+    g_workerStats.lastRenderMs = renderMs;
+    PacingAccumulate(&g_workerStats.avgRenderMs, renderMs, g_workerStats.framesRendered);
+    if (renderMs > g_workerStats.maxRenderMs) g_workerStats.maxRenderMs = renderMs;
+    LeaveCriticalSection(&g_requestLock);
+
+    if (!full && (dirtyArea.left >= dirtyArea.right || dirtyArea.top >= dirtyArea.bottom)) {
+        // 没有变化，不必提交
+        InterlockedExchange(&layer->state, SURFACE_FREE);
+        return;
+    }
+    layer->fullFrame = full;
+    layer->warm = FALSE;
+    SetRect(&layer->dirty, dirtyArea.left, dirtyArea.top, dirtyArea.right, dirtyArea.bottom);
+    layer->requestMs = request->requestMs;
+    PublishSurface(index, request->hwnd);
+    if (full) {
+        // 表面已交给 UI 线程，此后只有读取，可与提交同时进行
+        SaveWarmStart(request, layer, minute, nextChange);
+    }
 }
 
-// 文本居中绘制函数
-void DrawTextCentered(HDC hdc, RECT* rc, WCHAR* text, int yOffset) {
-    BOOL overflowed = DrawTextInternal(hdc, rc, text, yOffset);
-    UpdateOverflowFlag(overflowed);
-}
+// 按预留尺寸预先扩大空闲表面，动画期间只改变使用的子矩形，不再分配
+// 此时待提交或提交中的表面在下次使用时扩大
+static void PrepareSurfacePool(void) {
+    EnterCriticalSection(&g_requestLock);
+    BOOL pending = g_reservePending;
+    int reserveWidth = g_reserveWidth;
+    int reserveHeight = g_reserveHeight;
+    g_reservePending = FALSE;
+    LeaveCriticalSection(&g_requestLock);
+    if (!pending || reserveWidth <= 0 || reserveHeight <= 0) return;
+
+    unsigned long long allocations = 0;
+    for (int i = 0; i < RENDER_SURFACE_COUNT; ++i) {
+        LayerSurface *layer = &g_surfaces[i];
+        if (layer->bitmap && layer->capacityWidth >= reserveWidth && layer->capacityHeight >= reserveHeight) {
+            continue;
+        }
+        if (InterlockedCompareExchange(&layer->state, SURFACE_RENDERING, SURFACE_FREE) != SURFACE_FREE) {
+            continue;
+        }
+        if (AllocateLayerSurface(layer, max(reserveWidth, layer->capacityWidth),
+                                 max(reserveHeight, layer->capacityHeight))) {
+            allocations++;
+        }
+        if (g_lastRendered == i) g_lastRendered = -1;
+        InterlockedExchange(&layer->state, SURFACE_FREE);
+    }
 
-BOOL RendererHasOverflowingText(void) {
-    return g_lastFrameHasOverflow;
+    EnterCriticalSection(&g_requestLock);
+    g_workerStats.surfaceAllocations += allocations;
+    LeaveCriticalSection(&g_requestLock);
 }
 
-// 绘制课程表
-void DrawTimetable(HDC hdc, RECT rc, int viewMode) {
-    g_currentFrameHasOverflow = FALSE;
-    SetBkMode(hdc, TRANSPARENT);
-    SetTextColor(hdc, RGB(255,255,255));
+static SIZE_T ReadWorkingSet(void) {
+    PROCESS_MEMORY_COUNTERS counters = {0};
+    counters.cb = sizeof(counters);
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+}
 
-    LOGFONT lf = {0};
-    // 根据当前 DC DPI 缩放字体高度
-    int dpi = GetDeviceCaps(hdc, LOGPIXELSX);
-    lf.lfHeight = -MulDiv(12, dpi, 96);
-    lstrcpyW(lf.lfFaceName, L"微软雅黑"); // 中文字体
-    HFONT hFont = CreateFontIndirect(&lf);
-    HFONT oldFont = (HFONT)SelectObject(hdc, hFont);
+// 空闲（渲染线程）：释放空闲表面、静态层与背景平面、GDI 字体与临时表面，并记录释放前后的工作集
+// 文本段缓存与布局保留，下一次截止时间到来时只需重新分配表面并合成；新的请求或表面预留会取消释放
+static void TrimIdleResources(void) {
+    EnterCriticalSection(&g_requestLock);
+    BOOL trim = g_trimPending && g_pending.kind == RENDER_REQUEST_NONE && !g_reservePending &&
+                g_reserveWidth <= 0 && g_reserveHeight <= 0;
+    g_trimPending = FALSE;
+    LeaveCriticalSection(&g_requestLock);
+    if (!trim) return;
+
+    SIZE_T activeWorkingSet = ReadWorkingSet();
+    unsigned long long released = 0;
+    for (int i = 0; i < RENDER_SURFACE_COUNT; ++i) {
+        LayerSurface *layer = &g_surfaces[i];
+        // 待提交或提交中的表面留给 UI 线程，下次空闲时再释放
+        if (!layer->bitmap ||
+            InterlockedCompareExchange(&layer->state, SURFACE_RENDERING, SURFACE_FREE) != SURFACE_FREE) {
+            continue;
+        }
+        released += (unsigned long long)layer->capacityWidth * layer->capacityHeight * (sizeof(uint32_t) + 1);
+        FreeLayerSurface(layer);
+        if (g_lastRendered == i) g_lastRendered = -1;
+        InterlockedExchange(&layer->state, SURFACE_FREE);
+    }
+    if (g_renderCore) {
+        released += RenderCoreTrim(g_renderCore);
+    }
+    RenderGdiRelease();
+    HeapCompact(GetProcessHeap(), 0);
+    SIZE_T idleWorkingSet = ReadWorkingSet();
+
+    EnterCriticalSection(&g_requestLock);
+    g_workerStats.idleTrims++;
+    g_workerStats.idleReleasedBytes = released;
+    g_workerStats.activeWorkingSet = activeWorkingSet;
+    g_workerStats.idleWorkingSet = idleWorkingSet;
+    LeaveCriticalSection(&g_requestLock);
+}
 
-    SYSTEMTIME st;
-    GetLocalTime(&st);
-    int today = (st.wDayOfWeek + 6) % 7; // 周一=0
+static void ProcessPendingRequest(void) {
+    RenderRequest request;
+    EnterCriticalSection(&g_requestLock);
+    request = g_pending;
+    g_pending.kind = RENDER_REQUEST_NONE;
+    LeaveCriticalSection(&g_requestLock);
+    if (request.kind != RENDER_REQUEST_NONE) {
+        ExecuteRequest(&request);
+    }
+}
 
-    if (viewMode == 0) {
-        // ==== 日视图 ====
-        int cellH = (rc.bottom - rc.top) / CLASSES;
-        BOOL hasAnyClass = DayHasAnyClass(today);
+// 课程表文件有变化（渲染线程）：映射新文件并与当前课程表逐格比较，
+// 只重新测量变化的单元格，并以滚动帧只重绘这些区域
+static void ReloadSchedule(void) {
+    WCHAR path[MAX_PATH];
+    ULONGLONG writeTime = 0;
+    ULONGLONG fileSize = 0;
+    if (!g_renderCore || !GetSchedulePath(path, NULL) || !ReadScheduleStamp(path, &writeTime, &fileSize)) return;
+    // 目录中其他文件的变化，或同一次写入的重复通知
+    if (writeTime == g_scheduleWriteTime && fileSize == g_scheduleFileSize) return;
+
+    // 写入尚未完成时打开失败或校验失败，保留当前课程表，等待下一次通知
+    int next = 1 - g_activeSchedule;
+    if (!MapScheduleFile(path, &g_schedules[next])) return;
+    int changed = RenderCoreUpdateSchedule(g_renderCore, &g_schedules[next]);
+    ScheduleClose(&g_schedules[g_activeSchedule]);
+    g_activeSchedule = next;
+
+    // 与待处理的请求合并；没有时按最近一次请求的窗口重绘
+    BOOL redraw = (changed != 0 && g_lastRequest.kind != RENDER_REQUEST_NONE);
+    RenderRequest request = g_lastRequest;
+    if (redraw) {
+        FillFrameParams(request.hwnd, request.params.viewMode, &request.params);
+        request.kind = RENDER_REQUEST_NONE;
+        request.requestMs = PacingNowMs();
+    }
 
-        if (!hasAnyClass) {
-            DrawHolidayText(hdc, &rc);
-        } else {
-            for (int i=0; i<CLASSES; i++) {
-                RECT cellRect = {rc.left, rc.top + i*cellH, rc.right, rc.top + (i+1)*cellH};
-
-                if (timetable[today][i].name) {
-                    // 绘制课程名称（居中显示）
-                    DrawTextCentered(hdc, &cellRect, timetable[today][i].name, 10);
-
-                    // 绘制位置信息（居中显示）
-                    if (timetable[today][i].location) {
-                        SetTextColor(hdc, RGB(200, 200, 200)); // 稍微淡一点的颜色
-                        DrawTextCentered(hdc, &cellRect, timetable[today][i].location, 35);
-                        SetTextColor(hdc, RGB(255,255,255)); // 恢复白色
-                    }
-                }
-            }
+    EnterCriticalSection(&g_requestLock);
+    g_workerStats.scheduleReloads++;
+    if (redraw) {
+        if (g_pending.kind == RENDER_REQUEST_NONE) {
+            g_pending = request;
+            g_pending.reserveWidth = g_reserveWidth;
+            g_pending.reserveHeight = g_reserveHeight;
         }
-    } else {
-        // ==== 周视图 ====
-        int cellH = (rc.bottom - rc.top) / CLASSES;
-        int cellW = (rc.right - rc.left) / DAYS;
-
-        for (int d=0; d<DAYS; d++) {
-            RECT columnRect = {rc.left + d*cellW, rc.top, rc.left + (d+1)*cellW, rc.bottom};
-            if (!DayHasAnyClass(d)) {
-                DrawHolidayText(hdc, &columnRect);
-                continue;
-            }
+        RenderRequestKind kind = (changed < 0) ? RENDER_REQUEST_FULL : RENDER_REQUEST_MARQUEE;
+        if (kind > g_pending.kind) {
+            g_pending.kind = kind;
+        }
+    }
+    LeaveCriticalSection(&g_requestLock);
+}
 
-            for (int i=0; i<CLASSES; i++) {
-                RECT cellRect = {columnRect.left, rc.top + i*cellH, columnRect.right, rc.top + (i+1)*cellH};
+// 监视程序目录，schedule.ttb 被替换或改写时通知渲染线程
+static HANDLE OpenScheduleWatch(void) {
+    WCHAR path[MAX_PATH];
+    WCHAR directory[MAX_PATH];
+    if (!GetSchedulePath(path, directory)) return INVALID_HANDLE_VALUE;
+    return FindFirstChangeNotificationW(directory, FALSE, FILE_NOTIFY_CHANGE_FILE_NAME |
+                                        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE);
+}
 
-                if (timetable[d][i].name) {
-                    // 绘制课程名称（居中显示）
-                    DrawTextCentered(hdc, &cellRect, timetable[d][i].name, 10);
+static void ReleaseRenderResources(void) {
+    if (g_renderCore) {
+        RenderCoreDestroy(g_renderCore);
+        g_renderCore = NULL;
+    }
+    if (g_scheduleLoaded) {
+        ScheduleClose(&g_schedules[0]);
+        ScheduleClose(&g_schedules[1]);
+        g_scheduleLoaded = FALSE;
+    }
+    RenderGdiRelease();
+}
 
-                    // 绘制位置信息（居中显示）
-                    if (timetable[d][i].location) {
-                        SetTextColor(hdc, RGB(200, 200, 200)); // 稍微淡一点的颜色
-                        DrawTextCentered(hdc, &cellRect, timetable[d][i].location, 35);
-                        SetTextColor(hdc, RGB(255,255,255)); // 恢复白色
-                    }
-                }
-            }
+static DWORD WINAPI RenderWorkerMain(LPVOID param) {
+    (void)param;
+    HANDLE watch = OpenScheduleWatch();
+    HANDLE handles[2] = {g_wakeEvent, watch};
+    DWORD handleCount = (watch != INVALID_HANDLE_VALUE) ? 2 : 1;
+    for (;;) {
+        DWORD wait = WaitForMultipleObjects(handleCount, handles, FALSE, INFINITE);
+        if (g_workerQuit) break;
+        if (wait == WAIT_OBJECT_0 + 1) {
+            FindNextChangeNotification(watch);
+            ReloadSchedule();
         }
+        PrepareSurfacePool();
+        ProcessPendingRequest();
+        TrimIdleResources();
+    }
+    if (watch != INVALID_HANDLE_VALUE) {
+        FindCloseChangeNotification(watch);
     }
+    ReleaseRenderResources();
+    return 0;
+}
 
-    SelectObject(hdc, oldFont);
-    DeleteObject(hFont);
+// ---- UI 线程 ----
 
-    g_lastFrameHasOverflow = g_currentFrameHasOverflow;
+// 首次请求时启动渲染线程；失败时在 UI 线程同步渲染
+static void EnsureRenderWorker(void) {
+    if (g_workerInitialized) return;
+    g_workerInitialized = TRUE;
+    InitializeCriticalSection(&g_requestLock);
+    g_wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (g_wakeEvent) {
+        g_workerThread = CreateThread(NULL, 0, RenderWorkerMain, NULL, 0, NULL);
+    }
 }
 
-// 渲染分层窗口
-void RenderLayered(HWND hwnd, int viewMode) {
+static void SubmitRequest(HWND hwnd, int viewMode, RenderRequestKind kind) {
     RECT rc;
     if (!GetClientRect(hwnd, &rc)) return;
     int width = rc.right - rc.left;
     int height = rc.bottom - rc.top;
     if (width <= 0 || height <= 0) return;
 
-    if (!EnsureLayerSurface(width, height)) {
-        return;
+    EnsureRenderWorker();
+    if (g_processStartMs > 0.0 && g_presentStats.startupFirstRequestMs <= 0.0) {
+        g_presentStats.startupFirstRequestMs = PacingNowMs() - g_processStartMs;
     }
+    RenderFrameParams params;
+    FillFrameParams(hwnd, viewMode, &params);
 
-    // 获取 DPI，并按 DPI 缩放圆角半径
-    UINT dpi = GetWindowDpi(hwnd);
-    int corner = max(4, MulDiv(CORNER_RADIUS, dpi, 96)); // 最小值保护
-
-    // 背景颜色和 alpha（基准 alpha）
-    BYTE bgR = 0, bgG = 0, bgB = 0;  // 改为黑色背景
-    BYTE baseAlpha = (BYTE)WINDOW_ALPHA;
-
-    // 先把缓冲区设置为不透明的背景预乘色（用 baseAlpha），后续会根据圆角蒙版重新赋值
-    UINT pixels = width * height;
-    BYTE *ptr = (BYTE*)g_layerSurface.bits;
-    BYTE bgRp_base = (BYTE)((bgR * baseAlpha) / 255);
-    BYTE bgGp_base = (BYTE)((bgG * baseAlpha) / 255);
-    BYTE bgBp_base = (BYTE)((bgB * baseAlpha) / 255);
-    for (UINT i = 0; i < pixels; ++i) {
-        ptr[0] = bgBp_base; // B
-        ptr[1] = bgGp_base; // G
-        ptr[2] = bgRp_base; // R
-        ptr[3] = baseAlpha; // A
-        ptr += 4;
-    }
-
-    // 在 DIB 的 DC 上绘制文字（GDI 不会修改 alpha 字节）
-    RECT drawRect = {0, 0, width, height};
-    HBITMAP oldBmp = (HBITMAP)SelectObject(g_layerDC, g_layerSurface.bitmap);
-
-    DrawTimetable(g_layerDC, drawRect, viewMode);
-
-    // 遍历像素：为圆角计算平滑遮罩；背景像素按遮罩设为预乘色，文本像素保持不透明
-    // 使用像素中心 (x+0.5, y+0.5) 计算距离平方并在平方域内线性插值（避免 sqrt）
-    ptr = (BYTE*)g_layerSurface.bits;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            BYTE b = ptr[0], g = ptr[1], r = ptr[2];
-            float cx = x + 0.5f;
-            float cy = y + 0.5f;
-            float mask = 1.0f;
-
-            if ((cx < corner && cy < corner) || (cx < corner && cy > height - corner)
-             || (cx > width - corner && cy < corner) || (cx > width - corner && cy > height - corner)) {
-                float centerX = (cx < corner) ? (corner - 0.5f) : (width - corner - 0.5f);
-                float centerY = (cy < corner) ? (corner - 0.5f) : (height - corner - 0.5f);
-                float dx = cx - centerX;
-                float dy = cy - centerY;
-                float dist2 = dx*dx + dy*dy;
-                float rFloat = (float)corner;
-                float rMinus = rFloat - 0.5f;
-                float rPlus = rFloat + 0.5f;
-                float rMinus2 = rMinus * rMinus;
-                float rPlus2 = rPlus * rPlus;
-
-                if (dist2 <= rMinus2) {
-                    mask = 1.0f;
-                } else if (dist2 >= rPlus2) {
-                    mask = 0.0f;
-                } else {
-                    // 在平方域内线性插值（避免调用 sqrt）
-                    mask = (rPlus2 - dist2) / (rPlus2 - rMinus2);
-                    if (mask < 0.0f) mask = 0.0f;
-                    if (mask > 1.0f) mask = 1.0f;
+    // 未处理的请求合并为一个：取最新参数，完整渲染优先于滚动帧，延迟从最早的请求算起
+    EnterCriticalSection(&g_requestLock);
+    if (g_pending.kind == RENDER_REQUEST_NONE) {
+        g_pending.requestMs = PacingNowMs();
+    }
+    if (kind > g_pending.kind) {
+        g_pending.kind = kind;
+    }
+    g_pending.hwnd = hwnd;
+    g_pending.width = width;
+    g_pending.height = height;
+    g_pending.params = params;
+    g_pending.reserveWidth = g_reserveWidth;
+    g_pending.reserveHeight = g_reserveHeight;
+    g_trimPending = FALSE;
+    g_workerStats.framesRequested++;
+    LeaveCriticalSection(&g_requestLock);
+
+    if (g_workerThread) {
+        SetEvent(g_wakeEvent);
+    } else {
+        ProcessPendingRequest();
+    }
+}
+
+LONGLONG RendererMsUntilContentChange(void) {
+    LONG frameClock = g_frameClock;
+    if (frameClock < 0) return -1;
+    int frameMinute = (int)(frameClock >> 16);
+    int nextChange = (int)(frameClock & 0xFFFF);
+
+    SYSTEMTIME st;
+    GetLocalTime(&st);
+    int minute = st.wHour * 60 + st.wMinute;
+    if (minute < frameMinute) return 0; // 已跨天
+    LONGLONG ms = (LONGLONG)(nextChange - minute) * 60000 - (st.wSecond * 1000 + st.wMilliseconds);
+    return ms > 0 ? ms : 0;
+}
+
+BOOL RendererHasOverflowingText(void) {
+    return g_frameOverflow != 0;
+}
+
+// 渲染分层窗口
+void RenderLayered(HWND hwnd, int viewMode) {
+    SubmitRequest(hwnd, viewMode, RENDER_REQUEST_FULL);
+}
+
+// 滚动帧：只重新光栅化溢出文本所在的裁剪矩形，并只提交这些区域
+void RenderLayeredMarquee(HWND hwnd, int viewMode) {
+    SubmitRequest(hwnd, viewMode, RENDER_REQUEST_MARQUEE);
+}
+
+BOOL RendererPresentFrame(HWND hwnd) {
+    // 与 PublishSurface 互斥：取走的帧已并入它替换的帧的变化区域
+    EnterCriticalSection(&g_requestLock);
+    LONG ready = InterlockedExchange(&g_readySurface, 0);
+    if (ready) {
+        InterlockedExchange(&g_surfaces[ready - 1].state, SURFACE_PRESENTING);
+    }
+    LeaveCriticalSection(&g_requestLock);
+    if (!ready) return FALSE;
+    LayerSurface *layer = &g_surfaces[ready - 1];
+
+    // 尺寸已过期（例如动画中窗口又变了）的帧不提交，否则会把窗口改回旧尺寸
+    RECT rc;
+    BOOL presented = FALSE;
+    if (GetClientRect(hwnd, &rc) &&
+        rc.right - rc.left == layer->width && rc.bottom - rc.top == layer->height) {
+        if (!g_layerDC) {
+            g_layerDC = CreateCompatibleDC(NULL);
+        }
+        if (g_layerDC) {
+            double startMs = PacingNowMs();
+            double traceStart = FrameTraceBegin();
+            BOOL partial = !layer->fullFrame && !g_windowStale;
+            // 使用 UpdateLayeredWindow 提交
+            HBITMAP oldBmp = (HBITMAP)SelectObject(g_layerDC, layer->bitmap);
+            SubmitLayer(hwnd, layer->width, layer->height, partial ? &layer->dirty : NULL);
+            // 恢复 DC 原有的位图
+            SelectObject(g_layerDC, oldBmp);
+            FrameTraceEnd(FRAME_STAGE_PRESENT, traceStart);
+            g_windowStale = FALSE;
+            presented = TRUE;
+
+            double endMs = PacingNowMs();
+            double presentMs = endMs - startMs;
+            double latencyMs = endMs - layer->requestMs;
+            RendererPacingStats *stats = &g_presentStats;
+            stats->framesPresented++;
+            stats->lastPresentMs = presentMs;
+            PacingAccumulate(&stats->avgPresentMs, presentMs, stats->framesPresented);
+            PacingAccumulate(&stats->avgLatencyMs, latencyMs, stats->framesPresented);
+            if (latencyMs > stats->maxLatencyMs) stats->maxLatencyMs = latencyMs;
+            if (stats->framesPresented > 1) {
+                PacingAccumulate(&stats->avgPresentIntervalMs, endMs - g_lastPresentMs, stats->framesPresented - 1);
+            }
+            g_lastPresentMs = endMs;
+
+            // 启动计时：首次提交（可能是预热缓存中的帧）与首个实际渲染的帧
+            if (g_processStartMs > 0.0) {
+                if (stats->startupFirstPresentMs <= 0.0) {
+                    stats->startupFirstPresentMs = endMs - g_processStartMs;
+                    stats->startupWarm = layer->warm;
+                    InterlockedExchange(&g_startupWarm, layer->warm ? 1 : 0);
+                    InterlockedExchange(&g_startupPresentUs, (LONG)(stats->startupFirstPresentMs * 1000.0));
+                }
+                if (!layer->warm && stats->startupFirstRenderMs <= 0.0) {
+                    stats->startupFirstRenderMs = endMs - g_processStartMs;
                 }
-            } else {
-                mask = 1.0f;
             }
+        }
+    }
+    if (!presented) {
+        g_windowStale = TRUE;
+        g_presentStats.framesDropped++;
+    }
+    InterlockedExchange(&layer->state, SURFACE_FREE);
+    return presented;
+}
 
-            BYTE maskAlpha = (BYTE)(baseAlpha * mask + 0.5f);
-
-            // 判断是否为背景像素（与基准预乘色比较）
-            if (b == bgBp_base && g == bgGp_base && r == bgRp_base) {
-                // 背景像素：按 maskAlpha 重新计算预乘颜色与 alpha
-                ptr[3] = maskAlpha;
-                ptr[2] = (BYTE)((bgR * (int)maskAlpha) / 255); // R
-                ptr[1] = (BYTE)((bgG * (int)maskAlpha) / 255); // G
-                ptr[0] = (BYTE)((bgB * (int)maskAlpha) / 255); // B
-            } else {
-                // 非背景（认为是文本或其他绘制），保持不透明
-                ptr[3] = 255;
-            }
+void RendererGetPacingStats(RendererPacingStats *stats) {
+    if (!stats) return;
+    *stats = g_presentStats;
+    if (!g_workerInitialized) return;
+    EnterCriticalSection(&g_requestLock);
+    stats->framesRequested = g_workerStats.framesRequested;
+    stats->framesRendered = g_workerStats.framesRendered;
+    stats->marqueeFrames = g_workerStats.marqueeFrames;
+    stats->surfaceAllocations = g_workerStats.surfaceAllocations;
+    stats->surfaceReuses = g_workerStats.surfaceReuses;
+    stats->scheduleReloads = g_workerStats.scheduleReloads;
+    stats->idleTrims = g_workerStats.idleTrims;
+    stats->idleReleasedBytes = g_workerStats.idleReleasedBytes;
+    stats->activeWorkingSet = g_workerStats.activeWorkingSet;
+    stats->idleWorkingSet = g_workerStats.idleWorkingSet;
+    stats->framesDropped += g_workerStats.framesDropped;
+    stats->lastRenderMs = g_workerStats.lastRenderMs;
+    stats->avgRenderMs = g_workerStats.avgRenderMs;
+    stats->maxRenderMs = g_workerStats.maxRenderMs;
+    LeaveCriticalSection(&g_requestLock);
+}
 
-            ptr += 4;
-        }
+void RendererReserveSurfaces(int width, int height) {
+    EnsureRenderWorker();
+    EnterCriticalSection(&g_requestLock);
+    g_reserveWidth = max(0, width);
+    g_reserveHeight = max(0, height);
+    g_reservePending = TRUE;
+    LeaveCriticalSection(&g_requestLock);
+    if (g_workerThread) {
+        SetEvent(g_wakeEvent);
+    } else {
+        PrepareSurfacePool();
     }
+}
 
-    // 使用 UpdateLayeredWindow 提交
-    POINT ptSrc = {0,0};
-    SIZE sizeWnd = {width, height};
-    POINT ptDst;
-    RECT wndRect;
-    GetWindowRect(hwnd, &wndRect);
-    ptDst.x = wndRect.left;
-    ptDst.y = wndRect.top;
+void RendererTrimIdle(void) {
+    if (!g_workerInitialized) return;
+    // 提交用的内存 DC 在下一次提交时重新创建
+    if (g_layerDC) {
+        DeleteDC(g_layerDC);
+        g_layerDC = NULL;
+    }
+    EnterCriticalSection(&g_requestLock);
+    g_trimPending = TRUE;
+    LeaveCriticalSection(&g_requestLock);
+    if (g_workerThread) {
+        SetEvent(g_wakeEvent);
+    } else {
+        TrimIdleResources();
+    }
+}
 
-    BLENDFUNCTION bf = {0};
-    bf.BlendOp = AC_SRC_OVER;
-    bf.BlendFlags = 0;
-    bf.SourceConstantAlpha = 255;
-    bf.AlphaFormat = AC_SRC_ALPHA;
+void RendererSetHudNote(const char *note) {
+    EnsureRenderWorker();
+    EnterCriticalSection(&g_requestLock);
+    snprintf(g_hudNote, sizeof(g_hudNote), "%s", note ? note : "");
+    LeaveCriticalSection(&g_requestLock);
+}
 
-    UpdateLayeredWindow(hwnd, NULL, &ptDst, &sizeWnd, g_layerDC, &ptSrc, 0, &bf, ULW_ALPHA);
+void RendererMarkProcessStart(void) {
+    g_processStartMs = PacingNowMs();
+}
+
+void RendererSetHud(BOOL enabled) {
+    InterlockedExchange(&g_hudEnabled, enabled ? 1 : 0);
+}
 
-    // 恢复 DC 原有的位图
-    SelectObject(g_layerDC, oldBmp);
+void RendererShutdown(void) {
+    if (!g_workerInitialized) return;
+    if (g_workerThread) {
+        InterlockedExchange(&g_workerQuit, 1);
+        SetEvent(g_wakeEvent);
+        WaitForSingleObject(g_workerThread, INFINITE);
+        CloseHandle(g_workerThread);
+        g_workerThread = NULL;
+    } else {
+        ReleaseRenderResources();
+    }
+    if (g_wakeEvent) {
+        CloseHandle(g_wakeEvent);
+        g_wakeEvent = NULL;
+    }
+    InterlockedExchange(&g_readySurface, 0);
+    for (int i = 0; i < RENDER_SURFACE_COUNT; ++i) {
+        FreeLayerSurface(&g_surfaces[i]);
+        g_surfaces[i].state = SURFACE_FREE;
+    }
+    g_lastRendered = -1;
+    if (g_layerDC) {
+        DeleteDC(g_layerDC);
+        g_layerDC = NULL;
+    }
+    DeleteCriticalSection(&g_requestLock);
+    g_workerInitialized = FALSE;
 }
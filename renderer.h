@@ -2,20 +2,79 @@
 #define RENDERER_H
 
 #include <windows.h>
+#include "render_core.h"
 
-#define WINDOW_ALPHA     180
-#define CORNER_RADIUS    16
+// 渲染线程完成一帧后投递给窗口；收到后调用 RendererPresentFrame
+#define WM_RENDER_FRAME_READY (WM_APP + 1)
 
-// 绘制课程表
-void DrawTimetable(HDC hdc, RECT rc, int viewMode);
+// 帧节奏统计；渲染线程与 UI 线程各自记录，RendererGetPacingStats 汇总
+typedef struct {
+    // 渲染线程
+    unsigned long long framesRequested;  // 含被合并的请求
+    unsigned long long framesRendered;
+    unsigned long long marqueeFrames;    // 其中的增量滚动帧
+    double lastRenderMs;
+    double avgRenderMs;                  // 指数滑动平均
+    double maxRenderMs;
+    unsigned long long surfaceAllocations; // 表面（DIB）分配次数
+    unsigned long long surfaceReuses;      // 尺寸变化但容量足够、未重新分配的次数
+    unsigned long long scheduleReloads;    // schedule.ttb 变化后重新加载的次数
+    unsigned long long idleTrims;          // 空闲时释放表面与缓存的次数
+    unsigned long long idleReleasedBytes;  // 最近一次释放的表面、静态层与背景平面的字节数
+    SIZE_T activeWorkingSet;               // 最近一次释放前后的进程工作集（驻留内存，字节）
+    SIZE_T idleWorkingSet;
+    // UI 线程
+    unsigned long long framesPresented;
+    unsigned long long framesDropped;    // 未被取走即被新帧替换，或尺寸过期未提交
+    double lastPresentMs;                // UpdateLayeredWindow 耗时
+    double avgPresentMs;
+    double avgPresentIntervalMs;
+    double avgLatencyMs;                 // 请求到提交完成
+    double maxLatencyMs;
+    // 启动（UI 线程）：自 RendererMarkProcessStart 起的毫秒数，尚未发生为 0
+    double startupFirstRequestMs;        // 首次渲染请求
+    double startupFirstPresentMs;        // 首次 UpdateLayeredWindow
+    double startupFirstRenderMs;         // 首个实际渲染的帧提交完成；未命中预热缓存时与上一项相同
+    BOOL startupWarm;                    // 首次提交的是预热缓存中的帧
+} RendererPacingStats;
 
-// 渲染分层窗口
+// 在进程入口调用，作为启动计时的起点（见 RendererPacingStats 的 startup 各项与 HUD）
+void RendererMarkProcessStart(void);
+
+// 请求完整渲染一帧；光栅化在渲染线程进行，完成后投递 WM_RENDER_FRAME_READY
+// 冷启动的第一个请求先查找程序目录下的预热缓存 warm_start.bin（键为课程表内容哈希、尺寸、DPI、视图与星期），
+// 命中则在建立字体与布局之前先投递缓存的帧；完整渲染的帧与缓存不同时写回
 void RenderLayered(HWND hwnd, int viewMode);
 
-// 文本居中绘制函数
-void DrawTextCentered(HDC hdc, RECT* rc, WCHAR* text, int yOffset);
+// 请求滚动帧：只重绘并提交溢出滚动文本所在区域；条件不满足时退回完整渲染
+void RenderLayeredMarquee(HWND hwnd, int viewMode);
+
+// 提交已完成的帧（UI 线程）；有帧被提交返回 TRUE
+BOOL RendererPresentFrame(HWND hwnd);
+
+void RendererGetPacingStats(RendererPacingStats *stats);
+
+// 预留表面容量（动画开始前传入起止尺寸中较大者），动画期间窗口尺寸变化不再重新分配表面
+// 传 0 取消预留
+void RendererReserveSurfaces(int width, int height);
+
+// 进入空闲（没有动画与滚动文本，下一次截止时间还很远）时调用：释放内存 DC、空闲的表面、静态层与 GDI 字体，
+// 下一次渲染请求时按需重建；释放前后的工作集见 RendererPacingStats
+void RendererTrimIdle(void);
 
-// 当前渲染是否存在需要滚动显示的文本
+// 在窗口左上角叠加各阶段耗时（数据来自 frame_trace，需先 FrameTraceEnable），下一次完整渲染生效
+void RendererSetHud(BOOL enabled);
+
+// HUD 末尾附加的文本（ASCII，'\n' 分行，例如各原因的重绘请求数与帧率档位），下一次完整渲染生效；NULL 或空串表示不附加
+void RendererSetHudNote(const char *note);
+
+// 停止渲染线程并释放表面（窗口销毁时调用）
+void RendererShutdown(void);
+
+// 最近一帧是否存在需要滚动显示的文本
 BOOL RendererHasOverflowingText(void);
 
+// 距下一次内容变化（节次切换或跨天）的毫秒数，届时需要完整重绘；尚未渲染过返回 -1
+LONGLONG RendererMsUntilContentChange(void);
+
 #endif // RENDERER_H
@@ -0,0 +1,487 @@
+#include "schedule.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static size_t AlignUp4(size_t value) {
+    return (value + 3) & ~(size_t)3;
+}
+
+static int RangeInside(uint32_t offset, size_t length, size_t total) {
+    return offset <= total && length <= total - offset;
+}
+
+static int OccupancyWords(int classes) {
+    return (classes + 31) / 32;
+}
+
+int ScheduleOpenMemory(const void *data, size_t size, Schedule *schedule) {
+    if (!data || !schedule || size < sizeof(ScheduleFileHeader)) return 0;
+    if (((uintptr_t)data & 3) != 0) return 0;
+
+    const ScheduleFileHeader *h = (const ScheduleFileHeader*)data;
+    if (h->magic != SCHEDULE_MAGIC || h->version != SCHEDULE_VERSION ||
+        h->headerSize < sizeof(ScheduleFileHeader) || h->fileSize > size) {
+        return 0;
+    }
+    if (h->stringCount > SCHEDULE_MAX_STRINGS ||
+        (h->nameIdsOffset & 1) || (h->locationIdsOffset & 1) || (h->occupancyOffset & 3) ||
+        (h->stringIndexOffset & 3) || (h->stringDataOffset & 3)) {
+        return 0;
+    }
+
+    size_t total = h->fileSize;
+    size_t cellCount = (size_t)h->days * h->classes;
+    int occupancyWords = OccupancyWords(h->classes);
+    if (!RangeInside(h->nameIdsOffset, cellCount * sizeof(uint16_t), total) ||
+        !RangeInside(h->locationIdsOffset, cellCount * sizeof(uint16_t), total) ||
+        !RangeInside(h->occupancyOffset, (size_t)h->days * occupancyWords * sizeof(uint32_t), total) ||
+        !RangeInside(h->stringIndexOffset, (size_t)h->stringCount * sizeof(uint32_t), total) ||
+        !RangeInside(h->stringDataOffset, (size_t)h->stringDataLength * sizeof(TTCHAR), total)) {
+        return 0;
+    }
+
+    const uint8_t *base = (const uint8_t*)data;
+    const uint16_t *nameIds = (const uint16_t*)(base + h->nameIdsOffset);
+    const uint16_t *locationIds = (const uint16_t*)(base + h->locationIdsOffset);
+    const uint32_t *occupancy = (const uint32_t*)(base + h->occupancyOffset);
+    const uint32_t *stringIndex = (const uint32_t*)(base + h->stringIndexOffset);
+    const TTCHAR *strings = (const TTCHAR*)(base + h->stringDataOffset);
+
+    // 一次性校验，之后的访问无需检查：ID 不越界，每个字符串都在数据区内以 0 结尾，占用位与名称 ID 一致
+    if (h->stringCount > 0 && (h->stringDataLength == 0 || strings[h->stringDataLength - 1] != 0)) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < h->stringCount; ++i) {
+        if (stringIndex[i] >= h->stringDataLength) return 0;
+    }
+    for (size_t i = 0; i < cellCount; ++i) {
+        if (nameIds[i] > h->stringCount || locationIds[i] > h->stringCount) return 0;
+    }
+    for (int d = 0; d < h->days; ++d) {
+        const uint32_t *bits = occupancy + (size_t)d * occupancyWords;
+        for (int p = 0; p < h->classes; ++p) {
+            int occupied = (int)((bits[p >> 5] >> (p & 31)) & 1);
+            if (occupied != (nameIds[(size_t)d * h->classes + p] != 0)) return 0;
+        }
+    }
+
+    memset(schedule, 0, sizeof(*schedule));
+    schedule->header = h;
+    schedule->nameIds = nameIds;
+    schedule->locationIds = locationIds;
+    schedule->occupancy = occupancy;
+    schedule->stringIndex = stringIndex;
+    schedule->strings = strings;
+    schedule->days = h->days;
+    schedule->classes = h->classes;
+    schedule->occupancyWords = occupancyWords;
+    schedule->stringCount = (int)h->stringCount;
+    return 1;
+}
+
+// 版本 1 的文件头：槽位表为每节课交错存放的 (名称, 位置) ID
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint16_t days;
+    uint16_t classes;
+    uint32_t stringCount;
+    uint32_t slotsOffset;
+    uint32_t stringIndexOffset;
+    uint32_t stringDataOffset;
+    uint32_t stringDataLength;
+    uint32_t fileSize;
+} ScheduleFileHeaderV1;
+
+// 校验版本 1 的镜像并重新生成为当前格式（字符串复制到 schedule->storage，之后可释放 data）
+static int OpenLegacyImage(const void *data, size_t size, Schedule *schedule) {
+    if (size < sizeof(ScheduleFileHeaderV1) || ((uintptr_t)data & 3) != 0) return 0;
+    const ScheduleFileHeaderV1 *h = (const ScheduleFileHeaderV1*)data;
+    if (h->magic != SCHEDULE_MAGIC || h->version != 1 ||
+        h->headerSize < sizeof(ScheduleFileHeaderV1) || h->fileSize > size ||
+        h->stringCount > SCHEDULE_MAX_STRINGS || h->days == 0 || h->classes == 0 ||
+        (h->slotsOffset & 3) || (h->stringIndexOffset & 3) || (h->stringDataOffset & 3)) {
+        return 0;
+    }
+
+    size_t total = h->fileSize;
+    size_t slotCount = (size_t)h->days * h->classes * 2;
+    if (!RangeInside(h->slotsOffset, slotCount * sizeof(uint16_t), total) ||
+        !RangeInside(h->stringIndexOffset, (size_t)h->stringCount * sizeof(uint32_t), total) ||
+        !RangeInside(h->stringDataOffset, (size_t)h->stringDataLength * sizeof(TTCHAR), total)) {
+        return 0;
+    }
+
+    const uint8_t *base = (const uint8_t*)data;
+    const uint16_t *slots = (const uint16_t*)(base + h->slotsOffset);
+    const uint32_t *stringIndex = (const uint32_t*)(base + h->stringIndexOffset);
+    const TTCHAR *strings = (const TTCHAR*)(base + h->stringDataOffset);
+    if (h->stringCount > 0 && (h->stringDataLength == 0 || strings[h->stringDataLength - 1] != 0)) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < h->stringCount; ++i) {
+        if (stringIndex[i] >= h->stringDataLength) return 0;
+    }
+
+    ScheduleEntry *entries = (ScheduleEntry*)malloc(sizeof(ScheduleEntry) * (slotCount / 2));
+    if (!entries) return 0;
+    int count = 0;
+    int ok = 1;
+    for (size_t cell = 0; cell < slotCount / 2 && ok; ++cell) {
+        uint16_t nameId = slots[cell * 2];
+        uint16_t locationId = slots[cell * 2 + 1];
+        if (nameId > h->stringCount || locationId > h->stringCount) {
+            ok = 0;
+        } else if (nameId) {
+            ScheduleEntry *e = &entries[count++];
+            e->day = (int)(cell / h->classes);
+            e->slot = (int)(cell % h->classes);
+            e->name = strings + stringIndex[nameId - 1];
+            e->location = locationId ? strings + stringIndex[locationId - 1] : NULL;
+        }
+    }
+
+    Arena storage;
+    size_t imageSize = 0;
+    ok = ok && ScheduleBuildImage(h->days, h->classes, entries, count, &storage, &imageSize);
+    free(entries);
+    if (!ok) return 0;
+    if (!ScheduleOpenMemory(storage.base, imageSize, schedule)) {
+        ArenaRelease(&storage);
+        return 0;
+    }
+    schedule->storage = storage;
+    return 1;
+}
+
+#ifdef _WIN32
+
+int ScheduleMapFile(const char *path, Schedule *schedule) {
+    if (!path || !schedule) return 0;
+
+    WCHAR widePath[MAX_PATH];
+    if (!MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH)) return 0;
+
+    // 允许其他进程在映射期间改名替换该文件（热重载）
+    HANDLE file = CreateFileW(widePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 || fileSize.QuadPart > 0x7FFFFFFF) {
+        CloseHandle(file);
+        return 0;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // 映射对象持有文件引用
+    if (!mapping) return 0;
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view || !ScheduleOpenMemory(view, (size_t)fileSize.QuadPart, schedule)) {
+        int upgraded = view && OpenLegacyImage(view, (size_t)fileSize.QuadPart, schedule);
+        if (view) UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return upgraded;
+    }
+
+    schedule->view = view;
+    schedule->viewSize = (size_t)fileSize.QuadPart;
+    schedule->mapping = mapping;
+    return 1;
+}
+
+static void UnmapView(Schedule *schedule) {
+    UnmapViewOfFile(schedule->view);
+    if (schedule->mapping) {
+        CloseHandle((HANDLE)schedule->mapping);
+    }
+}
+
+#else
+
+int ScheduleMapFile(const char *path, Schedule *schedule) {
+    if (!path || !schedule) return 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > 0x7FFFFFFF) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return 0;
+
+    if (!ScheduleOpenMemory(view, size, schedule)) {
+        int upgraded = OpenLegacyImage(view, size, schedule);
+        munmap(view, size);
+        return upgraded;
+    }
+
+    schedule->view = view;
+    schedule->viewSize = size;
+    return 1;
+}
+
+static void UnmapView(Schedule *schedule) {
+    munmap(schedule->view, schedule->viewSize);
+}
+
+#endif
+
+void ScheduleClose(Schedule *schedule) {
+    if (!schedule) return;
+    if (schedule->view) {
+        UnmapView(schedule);
+    }
+    ArenaRelease(&schedule->storage);
+    memset(schedule, 0, sizeof(*schedule));
+}
+
+static size_t TextLength(const TTCHAR *text) {
+    size_t len = 0;
+    while (text[len]) ++len;
+    return len;
+}
+
+static uint32_t HashText(const TTCHAR *text, size_t len) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        h = (h ^ (uint32_t)text[i]) * 16777619u;
+    }
+    return h;
+}
+
+typedef struct {
+    const TTCHAR **texts;   // 按 ID 顺序（ID = 下标 + 1）
+    size_t *lengths;
+    int count;
+    int *buckets;           // 开放寻址，值为 ID，0 为空
+    int bucketMask;
+    size_t totalLength;     // 含结尾 0
+} StringInterner;
+
+// 返回字符串 ID；空字符串视为无内容（ID 0），失败返回 -1
+static int InternString(StringInterner *interner, const TTCHAR *text) {
+    if (!text || !text[0]) return 0;
+
+    size_t len = TextLength(text);
+    int slot = (int)(HashText(text, len) & (uint32_t)interner->bucketMask);
+    while (interner->buckets[slot]) {
+        int id = interner->buckets[slot];
+        if (interner->lengths[id - 1] == len &&
+            memcmp(interner->texts[id - 1], text, len * sizeof(TTCHAR)) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & interner->bucketMask;
+    }
+
+    if (interner->count >= SCHEDULE_MAX_STRINGS) return -1;
+    interner->texts[interner->count] = text;
+    interner->lengths[interner->count] = len;
+    interner->count++;
+    interner->totalLength += len + 1;
+    interner->buckets[slot] = interner->count;
+    return interner->count;
+}
+
+int ScheduleBuildImage(int days, int classes, const ScheduleEntry *entries, int count,
+                       Arena *storage, size_t *size) {
+    if (!storage || !size || days <= 0 || classes <= 0 || days > 0xFFFF || classes > 0xFFFF || count < 0) {
+        return 0;
+    }
+    memset(storage, 0, sizeof(*storage));
+    *size = 0;
+
+    size_t cellCount = (size_t)days * classes;
+    int occupancyWords = OccupancyWords(classes);
+    size_t occupancyCount = (size_t)days * occupancyWords;
+    int maxStrings = count * 2;
+    int buckets = 16;
+    while (buckets < maxStrings * 2) buckets <<= 1;
+
+    // 临时数据（去重表、两组 ID 与占用位）使用一块临时内存
+    Arena scratch;
+    size_t scratchSize = ArenaAlignSize(sizeof(TTCHAR*) * (size_t)(maxStrings + 1)) +
+                         ArenaAlignSize(sizeof(size_t) * (size_t)(maxStrings + 1)) +
+                         ArenaAlignSize(sizeof(int) * (size_t)buckets) +
+                         ArenaAlignSize(sizeof(uint16_t) * cellCount) * 2 +
+                         ArenaAlignSize(sizeof(uint32_t) * occupancyCount);
+    if (!ArenaInit(&scratch, scratchSize)) return 0;
+
+    StringInterner interner = {0};
+    interner.texts = (const TTCHAR**)ArenaAlloc(&scratch, sizeof(TTCHAR*) * (size_t)(maxStrings + 1));
+    interner.lengths = (size_t*)ArenaAlloc(&scratch, sizeof(size_t) * (size_t)(maxStrings + 1));
+    interner.buckets = (int*)ArenaAlloc(&scratch, sizeof(int) * (size_t)buckets);
+    interner.bucketMask = buckets - 1;
+    uint16_t *nameIds = (uint16_t*)ArenaAlloc(&scratch, sizeof(uint16_t) * cellCount);
+    uint16_t *locationIds = (uint16_t*)ArenaAlloc(&scratch, sizeof(uint16_t) * cellCount);
+    uint32_t *occupancy = (uint32_t*)ArenaAlloc(&scratch, sizeof(uint32_t) * occupancyCount);
+    int ok = 1;
+
+    for (int i = 0; i < count; ++i) {
+        const ScheduleEntry *e = &entries[i];
+        if (e->day < 0 || e->day >= days || e->slot < 0 || e->slot >= classes) {
+            ok = 0;
+            break;
+        }
+        int nameId = InternString(&interner, e->name);
+        int locationId = InternString(&interner, e->location);
+        if (nameId < 0 || locationId < 0) {
+            ok = 0;
+            break;
+        }
+        size_t cell = (size_t)e->day * classes + e->slot;
+        nameIds[cell] = (uint16_t)nameId;
+        locationIds[cell] = (uint16_t)locationId;
+    }
+    // 占用位由名称 ID 得出（没有名称的节次视为空课，位置一并清除）
+    for (size_t cell = 0; ok && cell < cellCount; ++cell) {
+        if (!nameIds[cell]) {
+            locationIds[cell] = 0;
+            continue;
+        }
+        int day = (int)(cell / classes);
+        int slot = (int)(cell % classes);
+        occupancy[(size_t)day * occupancyWords + (slot >> 5)] |= (uint32_t)1 << (slot & 31);
+    }
+
+    size_t total = 0;
+    if (ok) {
+        size_t nameIdsOffset = AlignUp4(sizeof(ScheduleFileHeader));
+        size_t locationIdsOffset = nameIdsOffset + cellCount * sizeof(uint16_t);
+        size_t occupancyOffset = AlignUp4(locationIdsOffset + cellCount * sizeof(uint16_t));
+        size_t indexOffset = occupancyOffset + occupancyCount * sizeof(uint32_t);
+        size_t dataOffset = AlignUp4(indexOffset + (size_t)interner.count * sizeof(uint32_t));
+        total = AlignUp4(dataOffset + interner.totalLength * sizeof(TTCHAR));
+        uint8_t *buffer = NULL;
+        if (total <= 0x7FFFFFFF && ArenaInit(storage, total)) {
+            buffer = (uint8_t*)ArenaAlloc(storage, total);
+        }
+        ok = (buffer != NULL);
+
+        if (ok) {
+            ScheduleFileHeader *h = (ScheduleFileHeader*)buffer;
+            h->magic = SCHEDULE_MAGIC;
+            h->version = SCHEDULE_VERSION;
+            h->headerSize = (uint16_t)sizeof(ScheduleFileHeader);
+            h->days = (uint16_t)days;
+            h->classes = (uint16_t)classes;
+            h->stringCount = (uint32_t)interner.count;
+            h->nameIdsOffset = (uint32_t)nameIdsOffset;
+            h->locationIdsOffset = (uint32_t)locationIdsOffset;
+            h->occupancyOffset = (uint32_t)occupancyOffset;
+            h->stringIndexOffset = (uint32_t)indexOffset;
+            h->stringDataOffset = (uint32_t)dataOffset;
+            h->stringDataLength = (uint32_t)interner.totalLength;
+            h->fileSize = (uint32_t)total;
+
+            memcpy(buffer + nameIdsOffset, nameIds, cellCount * sizeof(uint16_t));
+            memcpy(buffer + locationIdsOffset, locationIds, cellCount * sizeof(uint16_t));
+            memcpy(buffer + occupancyOffset, occupancy, occupancyCount * sizeof(uint32_t));
+            uint32_t *index = (uint32_t*)(buffer + indexOffset);
+            TTCHAR *data = (TTCHAR*)(buffer + dataOffset);
+            uint32_t cursor = 0;
+            for (int i = 0; i < interner.count; ++i) {
+                index[i] = cursor;
+                memcpy(data + cursor, interner.texts[i], interner.lengths[i] * sizeof(TTCHAR));
+                cursor += (uint32_t)interner.lengths[i];
+                data[cursor++] = 0;
+            }
+        } else {
+            ArenaRelease(storage);
+        }
+    }
+
+    ArenaRelease(&scratch);
+    if (!ok) return 0;
+
+    *size = total;
+    return 1;
+}
+
+int ScheduleFromBuiltin(Schedule *schedule) {
+    if (!schedule) return 0;
+
+    ScheduleEntry entries[DAYS * CLASSES];
+    int count = 0;
+    for (int d = 0; d < DAYS; ++d) {
+        for (int i = 0; i < CLASSES; ++i) {
+            if (!timetable[d][i].name) continue;
+            ScheduleEntry *e = &entries[count++];
+            e->day = d;
+            e->slot = i;
+            e->name = timetable[d][i].name;
+            e->location = timetable[d][i].location;
+        }
+    }
+
+    Arena storage;
+    size_t size = 0;
+    if (!ScheduleBuildImage(DAYS, CLASSES, entries, count, &storage, &size)) return 0;
+    if (!ScheduleOpenMemory(storage.base, size, schedule)) {
+        ArenaRelease(&storage);
+        return 0;
+    }
+    schedule->storage = storage;
+    return 1;
+}
+
+// 两个可能为 NULL 的字符串按内容比较
+static int SameText(const TTCHAR *a, const TTCHAR *b) {
+    if (a == b) return 1;
+    if (!a || !b) return 0;
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+int ScheduleDiff(const Schedule *previous, const Schedule *next, uint8_t *changed) {
+    if (!previous || !next || !changed ||
+        previous->days != next->days || previous->classes != next->classes) return -1;
+
+    // 字符串表逐字节相同时 ID 含义相同，只需比较两组 ID
+    size_t stringBytes = (size_t)next->header->stringDataLength * sizeof(TTCHAR);
+    int sameStrings = previous->header->stringCount == next->header->stringCount &&
+                      previous->header->stringDataLength == next->header->stringDataLength &&
+                      memcmp(previous->stringIndex, next->stringIndex,
+                             (size_t)next->header->stringCount * sizeof(uint32_t)) == 0 &&
+                      memcmp(previous->strings, next->strings, stringBytes) == 0;
+
+    int count = 0;
+    int cells = next->days * next->classes;
+    for (int cell = 0; cell < cells; ++cell) {
+        uint16_t nameA = previous->nameIds[cell];
+        uint16_t nameB = next->nameIds[cell];
+        uint16_t locationA = previous->locationIds[cell];
+        uint16_t locationB = next->locationIds[cell];
+        int differs;
+        if (sameStrings) {
+            differs = nameA != nameB || locationA != locationB;
+        } else {
+            differs = !SameText(ScheduleString(previous, nameA), ScheduleString(next, nameB)) ||
+                      !SameText(ScheduleString(previous, locationA), ScheduleString(next, locationB));
+        }
+        changed[cell] = (uint8_t)differs;
+        count += differs;
+    }
+    return count;
+}
@@ -0,0 +1,125 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "timetable_data.h"
+#include "arena.h"
+
+// 二进制课程表（.ttb）：启动时内存映射，渲染直接读取映射内存，无需解析与堆分配
+// 文件布局（小端，各段 4 字节对齐），按列存放：
+//   ScheduleFileHeader
+//   名称 ID  uint16_t[days][classes]      每节课名称的字符串 ID，0 表示空课
+//   位置 ID  uint16_t[days][classes]      0 表示没有位置
+//   占用位   uint32_t[days][occupancyWords] 第 p 节有课（名称 ID 非 0）则置位
+//   字符串索引 uint32_t[stringCount]       ID 为 i+1 的字符串在数据区中的起点（TTCHAR 单位）
+//   字符串数据 TTCHAR[stringDataLength]     去重后的 UTF-16 字符串，均以 0 结尾
+// 默认 7x8 的一周：两组 ID 共 224 字节、占用位 28 字节，遍历一周只触及几条缓存行；
+// 同一门课在各处共用一个 ID，按 ID 缓存的测量结果对所有出现处通用
+// 版本 1（每节课 (名称, 位置) 交错存放）的文件仍可读取，映射时转换为当前格式
+
+#define SCHEDULE_MAGIC       0x43535454u   // "TTSC"
+#define SCHEDULE_VERSION     2
+#define SCHEDULE_MAX_STRINGS 0xFFFF        // 字符串 ID 为 16 位，0 保留
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint16_t days;
+    uint16_t classes;
+    uint32_t stringCount;
+    uint32_t nameIdsOffset;      // 以下偏移均为相对文件起点的字节数
+    uint32_t locationIdsOffset;
+    uint32_t occupancyOffset;
+    uint32_t stringIndexOffset;
+    uint32_t stringDataOffset;
+    uint32_t stringDataLength;   // TTCHAR 个数
+    uint32_t fileSize;
+} ScheduleFileHeader;
+
+// 只读视图；各指针指向映射内存（或内置数据生成的镜像）
+// 网格尺寸来自文件头，运行时决定
+typedef struct {
+    const ScheduleFileHeader *header;
+    const uint16_t *nameIds;        // [day * classes + slot]
+    const uint16_t *locationIds;
+    const uint32_t *occupancy;      // [day * occupancyWords + slot / 32]
+    const uint32_t *stringIndex;
+    const TTCHAR *strings;
+    int days;
+    int classes;
+    int occupancyWords;             // 每天的占用位字数
+    int stringCount;
+    // 释放时使用
+    Arena storage;      // 内置数据生成的镜像（槽位与字符串同在一块内存），映射文件时为空
+    void *view;         // 映射起点
+    size_t viewSize;
+    void *mapping;      // Windows 文件映射句柄
+} Schedule;
+
+// 构建镜像时的一条输入（day/slot 从 0 开始）
+typedef struct {
+    int day;
+    int slot;
+    const TTCHAR *name;
+    const TTCHAR *location;
+} ScheduleEntry;
+
+// 校验一块内存中的镜像并建立视图（不复制数据）；成功返回 1
+int ScheduleOpenMemory(const void *data, size_t size, Schedule *schedule);
+
+// 内存映射 .ttb 文件（path 为 UTF-8）；版本 1 的文件转换到堆上的镜像后关闭映射；成功返回 1
+int ScheduleMapFile(const char *path, Schedule *schedule);
+
+// 由内置 timetable 数组生成镜像（未找到 .ttb 时使用）
+int ScheduleFromBuiltin(Schedule *schedule);
+
+// 释放映射或镜像（一次释放全部槽位与字符串）
+void ScheduleClose(Schedule *schedule);
+
+// 生成镜像：字符串去重并分配 ID；镜像占满 storage 的一次分配（即 storage->base），
+// 用 ArenaRelease 释放
+int ScheduleBuildImage(int days, int classes, const ScheduleEntry *entries, int count,
+                       Arena *storage, size_t *size);
+
+// 逐格比较两份课程表的内容（字符串按内容比较，与各自的字符串 ID 无关）
+// changed 至少容纳 days * classes 个标记，按 day * classes + slot 排列，变化的单元格置 1
+// 返回变化的单元格数；网格尺寸不同时返回 -1
+int ScheduleDiff(const Schedule *previous, const Schedule *next, uint8_t *changed);
+
+static inline const TTCHAR *ScheduleString(const Schedule *schedule, uint16_t id) {
+    return id ? schedule->strings + schedule->stringIndex[id - 1] : NULL;
+}
+
+static inline int ScheduleCellIndex(const Schedule *schedule, int day, int slot) {
+    if (day < 0 || day >= schedule->days || slot < 0 || slot >= schedule->classes) return -1;
+    return day * schedule->classes + slot;
+}
+
+// 课程名称 / 位置的字符串 ID，空课或越界返回 0
+static inline uint16_t ScheduleNameId(const Schedule *schedule, int day, int slot) {
+    int cell = ScheduleCellIndex(schedule, day, slot);
+    return cell >= 0 ? schedule->nameIds[cell] : 0;
+}
+
+static inline uint16_t ScheduleLocationId(const Schedule *schedule, int day, int slot) {
+    int cell = ScheduleCellIndex(schedule, day, slot);
+    return cell >= 0 ? schedule->locationIds[cell] : 0;
+}
+
+static inline int ScheduleIsOccupied(const Schedule *schedule, int day, int slot) {
+    if (ScheduleCellIndex(schedule, day, slot) < 0) return 0;
+    return (int)((schedule->occupancy[(size_t)day * schedule->occupancyWords + (slot >> 5)] >> (slot & 31)) & 1);
+}
+
+// 课程名称 / 位置，空课或越界返回 NULL
+static inline const TTCHAR *ScheduleName(const Schedule *schedule, int day, int slot) {
+    return ScheduleString(schedule, ScheduleNameId(schedule, day, slot));
+}
+
+static inline const TTCHAR *ScheduleLocation(const Schedule *schedule, int day, int slot) {
+    return ScheduleString(schedule, ScheduleLocationId(schedule, day, slot));
+}
+
+#endif // SCHEDULE_H
@@ -0,0 +1,464 @@
+// 课程表转换工具：把 CSV 文本源或 iCalendar 日历导出转换为可内存映射的二进制课程表（.ttb）
+// gcc -O2 schedule_convert.c schedule.c schedule_index.c ics_import.c arena.c timetable_data.c -o schedule_convert
+//
+// 用法: schedule_convert [--days N] [--classes N] input.csv output.ttb
+//       schedule_convert [--days N] [--classes N] [--periods LIST] [--week YYYY-MM-DD] [--utc-offset MINUTES]
+//                        input.ics output.ttb
+//       schedule_convert --builtin output.ttb      导出内置课程表
+//
+// CSV 为 UTF-8，每行一节课：星期,节次,课程名称,位置
+// 星期与节次均从 1 开始（周一为 1）；字段可用双引号包围，"" 表示引号本身；# 开头的行为注释
+// 网格尺寸默认为 7 天、最大节次，可用 --days / --classes 指定（例如 5 天、12 节）
+//
+// .ics 按扩展名识别：展开重复规则后，每次上课按节次时间表（--periods，如 08:00-08:45,08:55-09:40，
+// 默认为程序内置的作息）映射到 (星期, 节次)；--week 只取给定日期所在的一周（周一开始），
+// 否则合并整个学期；同一格先出现的课程优先，冲突数随结果打印。以 Z 结尾的 UTC 时间按 --utc-offset 换算
+
+#include "schedule.h"
+#include "ics_import.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CSV_MAX_FIELDS 4
+#define MAX_PERIODS    64
+
+typedef struct {
+    ScheduleEntry *entries;
+    int count;
+    int capacity;
+    TTCHAR **strings;       // 解析出的字符串，统一释放
+    int stringCount;
+    int stringCapacity;
+} ConvertState;
+
+// UTF-8 -> UTF-16，非法序列返回 NULL
+static TTCHAR *Utf8ToUtf16(const char *text, size_t len) {
+    TTCHAR *out = (TTCHAR*)malloc((len + 1) * sizeof(TTCHAR));
+    if (!out) return NULL;
+
+    size_t n = 0;
+    const unsigned char *s = (const unsigned char*)text;
+    for (size_t i = 0; i < len;) {
+        uint32_t cp;
+        int extra;
+        unsigned char c = s[i];
+        if (c < 0x80) { cp = c; extra = 0; }
+        else if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; extra = 3; }
+        else { free(out); return NULL; }
+
+        if (i + (size_t)extra >= len && extra > 0) { free(out); return NULL; }
+        for (int k = 1; k <= extra; ++k) {
+            if ((s[i + k] & 0xC0) != 0x80) { free(out); return NULL; }
+            cp = (cp << 6) | (s[i + k] & 0x3F);
+        }
+        i += (size_t)extra + 1;
+
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out[n++] = (TTCHAR)(0xD800 + (cp >> 10));
+            out[n++] = (TTCHAR)(0xDC00 + (cp & 0x3FF));
+        } else {
+            out[n++] = (TTCHAR)cp;
+        }
+    }
+    out[n] = 0;
+    return out;
+}
+
+static int KeepString(ConvertState *state, TTCHAR *text) {
+    if (state->stringCount == state->stringCapacity) {
+        int capacity = state->stringCapacity ? state->stringCapacity * 2 : 64;
+        TTCHAR **grown = (TTCHAR**)realloc(state->strings, sizeof(TTCHAR*) * (size_t)capacity);
+        if (!grown) return 0;
+        state->strings = grown;
+        state->stringCapacity = capacity;
+    }
+    state->strings[state->stringCount++] = text;
+    return 1;
+}
+
+static int AddEntry(ConvertState *state, int day, int slot, TTCHAR *name, TTCHAR *location) {
+    if (!KeepString(state, name)) {
+        free(name);
+        free(location);
+        return 0;
+    }
+    if (location && !KeepString(state, location)) {
+        free(location);
+        return 0;
+    }
+    if (state->count == state->capacity) {
+        int capacity = state->capacity ? state->capacity * 2 : 64;
+        ScheduleEntry *grown = (ScheduleEntry*)realloc(state->entries, sizeof(ScheduleEntry) * (size_t)capacity);
+        if (!grown) return 0;
+        state->entries = grown;
+        state->capacity = capacity;
+    }
+    ScheduleEntry *e = &state->entries[state->count++];
+    e->day = day;
+    e->slot = slot;
+    e->name = name;
+    e->location = location;
+    return 1;
+}
+
+// 拆分一行 CSV；字段内容原地改写（去掉引号），返回字段数，格式错误返回 -1
+static int SplitCsvLine(char *line, char **fields, size_t *lengths, int maxFields) {
+    int count = 0;
+    char *p = line;
+    for (;;) {
+        if (count == maxFields) return -1;
+        char *start = p;
+        char *w = p;
+        if (*p == '"') {
+            ++p;
+            for (;;) {
+                if (*p == '\0') return -1;
+                if (*p == '"') {
+                    if (p[1] == '"') { *w++ = '"'; p += 2; continue; }
+                    ++p;
+                    break;
+                }
+                *w++ = *p++;
+            }
+            if (*p != ',' && *p != '\0') return -1;
+        } else {
+            while (*p != ',' && *p != '\0') *w++ = *p++;
+            // 未加引号的字段去掉首尾空白
+            while (w > start && (w[-1] == ' ' || w[-1] == '\t')) --w;
+            while (start < w && (*start == ' ' || *start == '\t')) ++start;
+        }
+        fields[count] = start;
+        lengths[count] = (size_t)(w - start);
+        ++count;
+        if (*p == '\0') break;
+        ++p;
+    }
+    return count;
+}
+
+static int ParseCsv(FILE *f, const char *path, ConvertState *state, int *maxDay, int *maxSlot) {
+    char line[4096];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        ++lineNo;
+        size_t len = strlen(line);
+        if (len == sizeof(line) - 1 && line[len - 1] != '\n') {
+            fprintf(stderr, "%s:%d: line too long\n", path, lineNo);
+            return 0;
+        }
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        char *text = line;
+        if (lineNo == 1 && (unsigned char)text[0] == 0xEF && (unsigned char)text[1] == 0xBB &&
+            (unsigned char)text[2] == 0xBF) {
+            text += 3; // UTF-8 BOM
+        }
+        if (text[0] == '\0' || text[0] == '#') continue;
+
+        char *fields[CSV_MAX_FIELDS];
+        size_t lengths[CSV_MAX_FIELDS];
+        int n = SplitCsvLine(text, fields, lengths, CSV_MAX_FIELDS);
+        if (n < 3) {
+            fprintf(stderr, "%s:%d: expected day,slot,name[,location]\n", path, lineNo);
+            return 0;
+        }
+
+        fields[0][lengths[0]] = '\0';
+        fields[1][lengths[1]] = '\0';
+        char *end0, *end1;
+        long day = strtol(fields[0], &end0, 10);
+        long slot = strtol(fields[1], &end1, 10);
+        if (*end0 || *end1 || day < 1 || day > 0xFFFF || slot < 1 || slot > 0xFFFF) {
+            fprintf(stderr, "%s:%d: day and slot must be positive numbers\n", path, lineNo);
+            return 0;
+        }
+
+        TTCHAR *name = Utf8ToUtf16(fields[2], lengths[2]);
+        TTCHAR *location = (n > 3) ? Utf8ToUtf16(fields[3], lengths[3]) : NULL;
+        if (!name || (n > 3 && !location)) {
+            fprintf(stderr, "%s:%d: invalid UTF-8\n", path, lineNo);
+            free(name);
+            free(location);
+            return 0;
+        }
+        if (!AddEntry(state, (int)day - 1, (int)slot - 1, name, location)) return 0;
+        if ((int)day > *maxDay) *maxDay = (int)day;
+        if ((int)slot > *maxSlot) *maxSlot = (int)slot;
+    }
+    return 1;
+}
+
+// .ics 导入时每个单元格的首个课程（UTF-8 原文用于判断冲突）；内存只与网格大小有关
+typedef struct {
+    char *summary;
+    size_t summaryLength;
+} IcsCell;
+
+typedef struct {
+    ConvertState *state;
+    IcsCell *cells;         // [day * MAX_PERIODS + slot]
+    int maxDay;
+    int maxSlot;
+    long conflicts;
+    int failed;
+} IcsGrid;
+
+static int CollectOccurrence(void *user, const IcsOccurrence *occurrence) {
+    IcsGrid *grid = (IcsGrid*)user;
+    if (occurrence->summaryLength == 0) return 1;
+    for (int slot = occurrence->firstSlot; slot <= occurrence->lastSlot; ++slot) {
+        IcsCell *cell = &grid->cells[occurrence->day * MAX_PERIODS + slot];
+        if (cell->summary) {
+            if (cell->summaryLength != occurrence->summaryLength ||
+                memcmp(cell->summary, occurrence->summary, occurrence->summaryLength) != 0) {
+                grid->conflicts++;
+            }
+            continue;
+        }
+
+        TTCHAR *name = Utf8ToUtf16(occurrence->summary, occurrence->summaryLength);
+        TTCHAR *location = occurrence->locationLength
+                           ? Utf8ToUtf16(occurrence->location, occurrence->locationLength) : NULL;
+        cell->summary = (char*)malloc(occurrence->summaryLength);
+        if (!name || (occurrence->locationLength && !location) || !cell->summary) {
+            fprintf(stderr, "invalid UTF-8 or out of memory in event on day %d\n", occurrence->day + 1);
+            free(name);
+            free(location);
+            grid->failed = 1;
+            return 0;
+        }
+        memcpy(cell->summary, occurrence->summary, occurrence->summaryLength);
+        cell->summaryLength = occurrence->summaryLength;
+        if (!AddEntry(grid->state, occurrence->day, slot, name, location)) {
+            grid->failed = 1;
+            return 0;
+        }
+        if (occurrence->day + 1 > grid->maxDay) grid->maxDay = occurrence->day + 1;
+        if (slot + 1 > grid->maxSlot) grid->maxSlot = slot + 1;
+    }
+    return 1;
+}
+
+static int ParseIcs(FILE *f, const char *path, const IcsImportOptions *options, ConvertState *state,
+                    int *maxDay, int *maxSlot) {
+    IcsGrid grid = {0};
+    grid.state = state;
+    grid.cells = (IcsCell*)calloc((size_t)7 * MAX_PERIODS, sizeof(IcsCell));
+    if (!grid.cells) return 0;
+
+    IcsImportStats stats;
+    int ok = IcsImportFile(f, options, CollectOccurrence, &grid, &stats) && !grid.failed;
+    if (!ok && !grid.failed) {
+        fprintf(stderr, "%s: malformed calendar near logical line %ld\n", path, stats.errorLine);
+    }
+    if (ok) {
+        printf("%s: %ld events, %ld classes, %ld outside the period table, %ld skipped, %ld conflicts\n",
+               path, stats.events, stats.occurrences, stats.unmapped, stats.skipped, grid.conflicts);
+        if (stats.truncated) {
+            printf("%s: %ld over-long lines, texts or EXDATE lists were truncated\n", path, stats.truncated);
+        }
+    }
+
+    for (int i = 0; i < 7 * MAX_PERIODS; ++i) free(grid.cells[i].summary);
+    free(grid.cells);
+    *maxDay = grid.maxDay;
+    *maxSlot = grid.maxSlot;
+    return ok;
+}
+
+// "08:00-08:45,08:55-09:40"：开始时间递增、互不重叠
+static int ParsePeriods(const char *text, PeriodTime *periods, int *count) {
+    int n = 0;
+    const char *p = text;
+    while (*p) {
+        int h1, m1, h2, m2, used = 0;
+        if (n == MAX_PERIODS || sscanf(p, "%d:%d-%d:%d%n", &h1, &m1, &h2, &m2, &used) != 4 ||
+            h1 < 0 || m1 < 0 || m1 > 59 || h2 < 0 || m2 < 0 || m2 > 59) {
+            return 0;
+        }
+        int start = h1 * 60 + m1;
+        int end = h2 * 60 + m2;
+        if (start >= end || end > MINUTES_PER_DAY || (n > 0 && start < periods[n - 1].endMinute)) return 0;
+        periods[n].startMinute = (uint16_t)start;
+        periods[n].endMinute = (uint16_t)end;
+        n++;
+        p += used;
+        if (*p == ',') ++p;
+        else if (*p) return 0;
+    }
+    *count = n;
+    return n > 0;
+}
+
+static int HasExtension(const char *path, const char *extension) {
+    size_t length = strlen(path);
+    size_t extLength = strlen(extension);
+    if (length < extLength) return 0;
+    for (size_t i = 0; i < extLength; ++i) {
+        char c = path[length - extLength + i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != extension[i]) return 0;
+    }
+    return 1;
+}
+
+static int BuiltinEntries(ConvertState *state) {
+    state->entries = (ScheduleEntry*)malloc(sizeof(ScheduleEntry) * DAYS * CLASSES);
+    if (!state->entries) return 0;
+    for (int d = 0; d < DAYS; ++d) {
+        for (int i = 0; i < CLASSES; ++i) {
+            if (!timetable[d][i].name) continue;
+            ScheduleEntry *e = &state->entries[state->count++];
+            e->day = d;
+            e->slot = i;
+            e->name = timetable[d][i].name;
+            e->location = timetable[d][i].location;
+        }
+    }
+    return 1;
+}
+
+static void PrintUsage(const char *prog) {
+    fprintf(stderr, "usage: %s [--days N] [--classes N] input.csv output.ttb\n"
+                    "       %s [--days N] [--classes N] [--periods LIST] [--week YYYY-MM-DD] [--utc-offset MINUTES]\n"
+                    "          input.ics output.ttb\n"
+                    "       %s --builtin output.ttb\n", prog, prog, prog);
+}
+
+// 先写入临时文件再替换目标：运行中的窗口程序映射着旧文件，会随之热重载
+// Windows 下被映射的文件不能原地覆盖或删除，但可以改名，因此先把旧文件改名让开
+static int WriteReplacing(const char *path, const void *data, size_t size) {
+    char tempPath[1024];
+    char oldPath[1024];
+    if (snprintf(tempPath, sizeof(tempPath), "%s.tmp", path) >= (int)sizeof(tempPath) ||
+        snprintf(oldPath, sizeof(oldPath), "%s.old", path) >= (int)sizeof(oldPath)) {
+        return 0;
+    }
+
+    FILE *out = fopen(tempPath, "wb");
+    if (!out) return 0;
+    int ok = fwrite(data, 1, size, out) == size;
+    if (fclose(out) != 0) ok = 0;
+    if (!ok) {
+        remove(tempPath);
+        return 0;
+    }
+
+#ifdef _WIN32
+    remove(oldPath);
+    int movedAside = rename(path, oldPath) == 0;
+    if (rename(tempPath, path) != 0) {
+        if (movedAside) rename(oldPath, path);
+        remove(tempPath);
+        return 0;
+    }
+    remove(oldPath);  // 仍被映射时删除失败，下次转换时再删
+#else
+    (void)oldPath;
+    if (rename(tempPath, path) != 0) {
+        remove(tempPath);
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    int days = 0;
+    int classes = 0;
+    PeriodTime periods[MAX_PERIODS];
+    IcsImportOptions icsOptions = {0};
+    icsOptions.periods = ScheduleDefaultPeriods(&icsOptions.periodCount);
+    int argi = 1;
+    while (argi + 1 < argc && strncmp(argv[argi], "--", 2) == 0 && strcmp(argv[argi], "--builtin") != 0) {
+        const char *option = argv[argi];
+        const char *value = argv[argi + 1];
+        int valid = 1;
+        if (strcmp(option, "--days") == 0 || strcmp(option, "--classes") == 0) {
+            int number = atoi(value);
+            valid = number > 0 && number <= 0xFFFF;
+            if (option[2] == 'd') days = number;
+            else classes = number;
+        } else if (strcmp(option, "--periods") == 0) {
+            valid = ParsePeriods(value, periods, &icsOptions.periodCount);
+            icsOptions.periods = periods;
+        } else if (strcmp(option, "--week") == 0) {
+            int32_t date = 0;
+            valid = IcsParseDate(value, &date);
+            icsOptions.firstDate = date - IcsWeekday(date);
+            icsOptions.lastDate = icsOptions.firstDate + 7;
+        } else if (strcmp(option, "--utc-offset") == 0) {
+            icsOptions.utcOffsetMinutes = atoi(value);
+            valid = icsOptions.utcOffsetMinutes > -MINUTES_PER_DAY && icsOptions.utcOffsetMinutes < MINUTES_PER_DAY;
+        } else {
+            valid = 0;
+        }
+        if (!valid) {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        argi += 2;
+    }
+    if (argc - argi != 2) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    const char *inPath = argv[argi];
+    const char *outPath = argv[argi + 1];
+
+    ConvertState state = {0};
+    int maxDay = 0;
+    int maxSlot = 0;
+    int ok;
+    if (strcmp(inPath, "--builtin") == 0) {
+        ok = BuiltinEntries(&state);
+        maxDay = DAYS;
+        maxSlot = CLASSES;
+    } else {
+        FILE *in = fopen(inPath, "r");
+        if (!in) {
+            fprintf(stderr, "cannot open %s\n", inPath);
+            return 1;
+        }
+        if (HasExtension(inPath, ".ics")) {
+            ok = ParseIcs(in, inPath, &icsOptions, &state, &maxDay, &maxSlot);
+        } else {
+            ok = ParseCsv(in, inPath, &state, &maxDay, &maxSlot);
+        }
+        fclose(in);
+    }
+
+    if (!days) days = maxDay > DAYS ? maxDay : DAYS;
+    if (!classes) classes = maxSlot > 0 ? maxSlot : 1;
+    if (ok && (maxDay > days || maxSlot > classes)) {
+        fprintf(stderr, "entries exceed the %dx%d grid (day %d, slot %d)\n", days, classes, maxDay, maxSlot);
+        ok = 0;
+    }
+
+    Arena image = {0};
+    size_t size = 0;
+    if (ok && !ScheduleBuildImage(days, classes, state.entries, state.count, &image, &size)) {
+        fprintf(stderr, "cannot build schedule (more than %d distinct strings?)\n", SCHEDULE_MAX_STRINGS);
+        ok = 0;
+    }
+
+    if (ok && !WriteReplacing(outPath, image.base, size)) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        ok = 0;
+    }
+
+    if (ok) {
+        const ScheduleFileHeader *h = (const ScheduleFileHeader*)image.base;
+        printf("%s: %d entries, %ux%u slots, %u strings, %zu bytes\n",
+               outPath, state.count, h->days, h->classes, h->stringCount, size);
+    }
+
+    ArenaRelease(&image);
+    for (int i = 0; i < state.stringCount; ++i) free(state.strings[i]);
+    free(state.strings);
+    free(state.entries);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "schedule_index.h"
+#include <string.h>
+
+// 默认作息：每节 45 分钟，课间 10 分钟，上午第二、三节之间大课间 20 分钟
+static const PeriodTime g_defaultPeriods[] = {
+    { 8 * 60,       8 * 60 + 45 },
+    { 8 * 60 + 55,  9 * 60 + 40 },
+    {10 * 60,      10 * 60 + 45 },
+    {10 * 60 + 55, 11 * 60 + 40 },
+    {14 * 60,      14 * 60 + 45 },
+    {14 * 60 + 55, 15 * 60 + 40 },
+    {16 * 60,      16 * 60 + 45 },
+    {16 * 60 + 55, 17 * 60 + 40 },
+    {19 * 60,      19 * 60 + 45 },
+    {19 * 60 + 55, 20 * 60 + 40 },
+    {20 * 60 + 50, 21 * 60 + 35 },
+    {21 * 60 + 45, 22 * 60 + 30 },
+};
+
+const PeriodTime *ScheduleDefaultPeriods(int *count) {
+    if (count) *count = (int)(sizeof(g_defaultPeriods) / sizeof(g_defaultPeriods[0]));
+    return g_defaultPeriods;
+}
+
+int ScheduleIndexBuild(ScheduleIndex *index, const Schedule *schedule, const PeriodTime *periods, int periodCount) {
+    if (!index || !schedule || periodCount < 0 || (periodCount > 0 && !periods)) return 0;
+    memset(index, 0, sizeof(*index));
+
+    int days = schedule->days;
+    int classes = schedule->classes;
+    if (periodCount > classes) periodCount = classes;
+    for (int p = 0; p < periodCount; ++p) {
+        if (periods[p].startMinute >= periods[p].endMinute || periods[p].endMinute > MINUTES_PER_DAY ||
+            (p > 0 && periods[p].startMinute < periods[p - 1].endMinute)) {
+            return 0;
+        }
+    }
+
+    int wordsPerDay = (classes + 63) / 64;
+    size_t occupancyBytes = sizeof(uint64_t) * (size_t)days * wordsPerDay;
+    size_t nextBytes = sizeof(int32_t) * (size_t)days * (classes + 1);
+    size_t periodBytes = sizeof(PeriodTime) * (size_t)periodCount;
+    if (!ArenaInit(&index->storage, ArenaAlignSize(occupancyBytes) + ArenaAlignSize(nextBytes) +
+                                    ArenaAlignSize(periodBytes))) {
+        return 0;
+    }
+    index->occupancy = (uint64_t*)ArenaAlloc(&index->storage, occupancyBytes);
+    index->nextOccupied = (int32_t*)ArenaAlloc(&index->storage, nextBytes);
+    index->periods = (PeriodTime*)ArenaAlloc(&index->storage, periodBytes);
+    index->days = days;
+    index->classes = classes;
+    index->wordsPerDay = wordsPerDay;
+    index->periodCount = periodCount;
+    if (periodCount > 0) {
+        memcpy(index->periods, periods, periodBytes);
+    }
+
+    // 占用位图与“从第 p 节起第一节有课”表（自后向前一次扫描）
+    for (int d = 0; d < days; ++d) {
+        uint64_t *bits = index->occupancy + (size_t)d * wordsPerDay;
+        int32_t *next = index->nextOccupied + (size_t)d * (classes + 1);
+        next[classes] = classes;
+        for (int p = classes - 1; p >= 0; --p) {
+            if (ScheduleIsOccupied(schedule, d, p)) {
+                bits[p >> 6] |= (uint64_t)1 << (p & 63);
+                next[p] = p;
+            } else {
+                next[p] = next[p + 1];
+            }
+        }
+    }
+
+    // 按分钟展开节次时间
+    int p = 0;
+    for (int m = 0; m < MINUTES_PER_DAY; ++m) {
+        while (p < periodCount && periods[p].endMinute <= m) ++p;
+        index->minuteToPeriod[m] = (p < periodCount && periods[p].startMinute <= m) ? p : SCHEDULE_NO_PERIOD;
+        // 当前分钟之后开始的第一节
+        int nextStart = (p < periodCount && periods[p].startMinute <= m) ? p + 1 : p;
+        index->minuteToNextStart[m] = (nextStart < periodCount) ? nextStart : classes;
+    }
+
+    // 自后向前：所在节次与后一分钟不同处即为边界
+    int boundary = MINUTES_PER_DAY;
+    for (int m = MINUTES_PER_DAY - 1; m >= 0; --m) {
+        index->minuteToNextBoundary[m] = (int16_t)boundary;
+        if (m > 0 && index->minuteToPeriod[m] != index->minuteToPeriod[m - 1]) {
+            boundary = m;
+        }
+    }
+    return 1;
+}
+
+void ScheduleIndexRelease(ScheduleIndex *index) {
+    if (!index) return;
+    ArenaRelease(&index->storage);
+    memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,72 @@
+#ifndef SCHEDULE_INDEX_H
+#define SCHEDULE_INDEX_H
+
+#include <stdint.h>
+#include "schedule.h"
+#include "arena.h"
+
+// 课程表索引：每次载入课程表时构建一次，之后的查询均为常数时间
+//   - 每天一组占用位图，判断某天是否有课、某节是否有课
+//   - 节次时间表展开为按分钟的查找表，回答“现在是第几节”“下一节课是哪节”“何时换节”
+
+#define SCHEDULE_NO_PERIOD   (-1)
+#define MINUTES_PER_DAY      1440
+
+typedef struct {
+    uint16_t startMinute;   // 当天的第几分钟，含
+    uint16_t endMinute;     // 不含
+} PeriodTime;
+
+typedef struct {
+    int days;
+    int classes;
+    int wordsPerDay;
+    uint64_t *occupancy;       // days * wordsPerDay，第 p 节有课则置位
+    int32_t *nextOccupied;     // days * (classes + 1)：从第 p 节起第一个有课的节次，没有则为 classes
+    PeriodTime *periods;       // 节次时间，前 periodCount 节有时间，其余节次不参与按时间查询
+    int periodCount;
+    int32_t minuteToPeriod[MINUTES_PER_DAY];     // 该分钟所在节次，课间为 SCHEDULE_NO_PERIOD
+    int32_t minuteToNextStart[MINUTES_PER_DAY];  // 该分钟之后第一个开始的节次，没有则为 classes
+    int16_t minuteToNextBoundary[MINUTES_PER_DAY]; // 该分钟之后第一次上课或下课的分钟，没有则为 MINUTES_PER_DAY
+    Arena storage;             // 以上数组共用一次分配
+} ScheduleIndex;
+
+// 默认节次时间（上午四节、下午四节、晚上四节）
+const PeriodTime *ScheduleDefaultPeriods(int *count);
+
+// periods 须按开始时间递增且互不重叠；成功返回 1
+int ScheduleIndexBuild(ScheduleIndex *index, const Schedule *schedule, const PeriodTime *periods, int periodCount);
+void ScheduleIndexRelease(ScheduleIndex *index);
+
+static inline int ScheduleIndexIsOccupied(const ScheduleIndex *index, int day, int period) {
+    if (day < 0 || day >= index->days || period < 0 || period >= index->classes) return 0;
+    return (int)((index->occupancy[(size_t)day * index->wordsPerDay + (period >> 6)] >> (period & 63)) & 1);
+}
+
+static inline int ScheduleIndexDayHasClass(const ScheduleIndex *index, int day) {
+    if (day < 0 || day >= index->days) return 0;
+    return index->nextOccupied[(size_t)day * (index->classes + 1)] < index->classes;
+}
+
+// 某天 minute 时正在上的课；不在上课时间或该节无课返回 SCHEDULE_NO_PERIOD
+static inline int ScheduleIndexCurrentClass(const ScheduleIndex *index, int day, int minute) {
+    if (minute < 0 || minute >= MINUTES_PER_DAY) return SCHEDULE_NO_PERIOD;
+    int period = index->minuteToPeriod[minute];
+    return ScheduleIndexIsOccupied(index, day, period) ? period : SCHEDULE_NO_PERIOD;
+}
+
+// 某天 minute 之后开始的第一节有课的节次；当天没有则返回 SCHEDULE_NO_PERIOD
+// 开始时间为 index->periods[返回值].startMinute
+static inline int ScheduleIndexNextClass(const ScheduleIndex *index, int day, int minute) {
+    if (day < 0 || day >= index->days || minute < 0 || minute >= MINUTES_PER_DAY) return SCHEDULE_NO_PERIOD;
+    int next = index->nextOccupied[(size_t)day * (index->classes + 1) + index->minuteToNextStart[minute]];
+    return (next < index->periodCount) ? next : SCHEDULE_NO_PERIOD;
+}
+
+// minute 之后下一次节次变化（上课、下课或跨天）的分钟
+static inline int ScheduleIndexNextBoundary(const ScheduleIndex *index, int minute) {
+    if (minute < 0 || minute >= MINUTES_PER_DAY) return MINUTES_PER_DAY;
+    return index->minuteToNextBoundary[minute];
+}
+
+#endif // SCHEDULE_INDEX_H
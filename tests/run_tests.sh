@@ -0,0 +1,95 @@
+#!/bin/sh
+# 在 Linux 上构建并运行全部测试：sh tests/run_tests.sh
+# 测试与被测模块用 gcc 直接编译（与无头驱动、转换工具相同的编译方式），任一失败时返回 1
+cd "$(dirname "$0")/.." || exit 1
+CC=${CC:-gcc}
+OUT=${TEST_BUILD_DIR:-$(mktemp -d)}
+mkdir -p "$OUT"
+failed=0
+
+# run_test <名称> <源文件...>：编译并运行一个测试程序
+run_test() {
+    name=$1
+    shift
+    if ! $CC -O2 -Wall "$@" -o "$OUT/$name" -lm; then
+        echo "FAILED: $name (build)"
+        failed=1
+    elif ! "$OUT/$name"; then
+        echo "FAILED: $name"
+        failed=1
+    fi
+}
+
+# expect_status <名称> <退出码> <命令...>：命令的退出码必须等于给定值
+expect_status() {
+    name=$1
+    status=$2
+    shift 2
+    "$@" > /dev/null 2>&1
+    actual=$?
+    if [ $actual -ne $status ]; then
+        echo "FAILED: $name (exit $actual, expected $status)"
+        failed=1
+    fi
+}
+
+RENDER_SOURCES="render_core.c render_soft.c schedule.c schedule_index.c arena.c text_cache.c corner_tiles.c pixel_kernels.c frame_trace.c timetable_data.c"
+
+run_test test_pixel_kernels tests/test_pixel_kernels.c pixel_kernels.c corner_tiles.c
+run_test test_frame_scheduler tests/test_frame_scheduler.c frame_scheduler.c
+run_test test_schedule tests/test_schedule.c schedule.c arena.c timetable_data.c
+run_test test_ics_import tests/test_ics_import.c ics_import.c
+run_test test_widget_controller tests/test_widget_controller.c widget_controller.c frame_scheduler.c frame_governor.c $RENDER_SOURCES
+
+# 黄金图像：tests/golden.txt 的每一行在各指令集下都必须得到记录的校验和
+if ! $CC -O2 headless.c $RENDER_SOURCES -o "$OUT/timetable_headless" -lm; then
+    echo "FAILED: timetable_headless (build)"
+    failed=1
+else
+    goldenCases=0
+    goldenFailed=0
+    while read -r expected args; do
+        case "$expected" in ''|'#'*) continue ;; esac
+        for isa in scalar sse2 avx2; do
+            goldenCases=$((goldenCases + 1))
+            if ! "$OUT/timetable_headless" $args --isa $isa --expect "$expected" > /dev/null; then
+                echo "golden mismatch: $args --isa $isa (expected $expected)"
+                goldenFailed=$((goldenFailed + 1))
+            fi
+        done
+    done < tests/golden.txt
+    echo "golden: $goldenCases cases, $goldenFailed failed"
+    [ $goldenFailed -eq 0 ] || failed=1
+fi
+
+# 命令行：--today 按课程表自身的天数检查（5 天的课程表上第 6 天被拒绝）
+if $CC -O2 schedule_convert.c schedule.c schedule_index.c ics_import.c arena.c timetable_data.c -o "$OUT/schedule_convert" &&
+   printf '1,1,A,101\n5,3,B,205\n' > "$OUT/five_days.csv" &&
+   "$OUT/schedule_convert" --days 5 --classes 6 "$OUT/five_days.csv" "$OUT/five_days.ttb" > /dev/null; then
+    expect_status "headless --today 4 on 5 days" 0 "$OUT/timetable_headless" --schedule "$OUT/five_days.ttb" --today 4
+    expect_status "headless --today 5 on 5 days" 2 "$OUT/timetable_headless" --schedule "$OUT/five_days.ttb" --today 5
+    FIVE_DAYS="$OUT/five_days.ttb"
+else
+    echo "FAILED: schedule_convert (build or convert)"
+    failed=1
+fi
+
+# 批量渲染：--out-dir 不存在时自动创建（含上级目录），无法创建时在渲染前报错退出
+if $CC -O2 -pthread batch_render.c image_encode.c $RENDER_SOURCES -o "$OUT/timetable_batch" -lm; then
+    rm -rf "$OUT/batch"
+    expect_status "batch into new nested --out-dir" 0 "$OUT/timetable_batch" --builtin --format qoi --out-dir "$OUT/batch/a/b"
+    if [ ! -f "$OUT/batch/a/b/builtin_week_420x360_96.qoi" ]; then
+        echo "FAILED: batch did not write into the new --out-dir"
+        failed=1
+    fi
+    : > "$OUT/batch/file"
+    expect_status "batch --out-dir under a file" 1 "$OUT/timetable_batch" --builtin --out-dir "$OUT/batch/file/x"
+    if [ -n "$FIVE_DAYS" ]; then
+        expect_status "batch --today 5 on 5 days" 1 "$OUT/timetable_batch" --no-write --today 5 "$FIVE_DAYS"
+    fi
+else
+    echo "FAILED: timetable_batch (build)"
+    failed=1
+fi
+
+exit $failed
@@ -0,0 +1,35 @@
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <stdio.h>
+
+// 单元测试的最小断言：失败时打印位置并计数，main 以 TestExitCode() 返回
+// 测试与被测模块一样不依赖 Win32，由 tests/run_tests.sh 用 gcc 构建并运行
+
+static int g_testFailures = 0;
+static int g_testChecks = 0;
+
+#define CHECK(cond) do { \
+    ++g_testChecks; \
+    if (!(cond)) { \
+        ++g_testFailures; \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+    long long actual_ = (long long)(actual); \
+    long long expected_ = (long long)(expected); \
+    ++g_testChecks; \
+    if (actual_ != expected_) { \
+        ++g_testFailures; \
+        fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, actual_, expected_); \
+    } \
+} while (0)
+
+static int TestExitCode(const char *name) {
+    printf("%s: %d checks, %d failed\n", name, g_testChecks, g_testFailures);
+    return g_testFailures ? 1 : 0;
+}
+
+#endif // TEST_COMMON_H
@@ -0,0 +1,131 @@
+#include "test_common.h"
+#include "../frame_scheduler.h"
+
+// 帧调度器在手动推进的虚拟时钟上运行：定时器恰好在 NextDelay 给出的截止时间触发，
+// 统计各场景的唤醒次数，确认空闲时只按内容变化唤醒、滚动按帧间隔唤醒、只在动画期间需要高精度定时器
+
+static uint64_t g_nowMs = 0;
+
+static uint64_t VirtualNow(void *user) {
+    (void)user;
+    return g_nowMs;
+}
+
+static void InitScheduler(FrameScheduler *scheduler, uint32_t animationIntervalMs, uint32_t marqueeIntervalMs) {
+    FrameClock clock = {VirtualNow, NULL};
+    g_nowMs = 1000;
+    FrameSchedulerInit(scheduler, &clock, animationIntervalMs, marqueeIntervalMs);
+}
+
+// 推进到 endMs，途中每个截止时间唤醒一次；内容截止到期后按 contentPeriodMs 重新设置（模拟重绘后的下一次节次切换）
+// 返回唤醒次数
+static unsigned int RunUntil(FrameScheduler *scheduler, uint64_t endMs, int64_t contentPeriodMs) {
+    unsigned int wakes = 0;
+    for (;;) {
+        int64_t delay = FrameSchedulerNextDelay(scheduler);
+        if (delay == FRAME_SCHEDULER_NO_DEADLINE || g_nowMs + (uint64_t)delay > endMs) {
+            g_nowMs = endMs;
+            return wakes;
+        }
+        g_nowMs += (uint64_t)delay;
+        unsigned int due = FrameSchedulerDispatch(scheduler);
+        ++wakes;
+        if ((due & FRAME_WAKE_CONTENT) && contentPeriodMs >= 0) {
+            FrameSchedulerSetContentDelay(scheduler, contentPeriodMs);
+        }
+    }
+}
+
+// 空闲：没有动画与滚动文本时十分钟内只在每分钟的内容变化时唤醒，而不是每 16 ms 一次
+static void TestIdleWakesOncePerContentChange(void) {
+    FrameScheduler scheduler;
+    InitScheduler(&scheduler, 16, 40);
+    CHECK_EQ(FrameSchedulerNextDelay(&scheduler), FRAME_SCHEDULER_NO_DEADLINE);
+    CHECK(!FrameSchedulerWantsHighResolution(&scheduler));
+
+    FrameSchedulerSetContentDelay(&scheduler, 60000);
+    unsigned int wakes = RunUntil(&scheduler, g_nowMs + 10 * 60000, 60000);
+    CHECK_EQ(wakes, 10);
+    CHECK_EQ(scheduler.stats.contentFrames, 10);
+    CHECK_EQ(scheduler.stats.idleWakeups, 0);
+    CHECK_EQ(scheduler.stats.marqueeFrames, 0);
+    CHECK_EQ(scheduler.stats.animationFrames, 0);
+
+    // 没有下一次内容变化时不再唤醒
+    FrameSchedulerSetContentDelay(&scheduler, -1);
+    CHECK_EQ(FrameSchedulerNextDelay(&scheduler), FRAME_SCHEDULER_NO_DEADLINE);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 3600000, -1), 0);
+}
+
+// 滚动：按帧间隔唤醒；改变帧间隔（帧率档位）后按新的间隔唤醒，内容截止仍单独唤醒
+static void TestMarqueeWakesAtTierInterval(void) {
+    FrameScheduler scheduler;
+    InitScheduler(&scheduler, 16, 25);
+    FrameSchedulerSetMarquee(&scheduler, 1);
+    CHECK_EQ(FrameSchedulerNextDelay(&scheduler), 25);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 1000, -1), 40);
+    CHECK_EQ(scheduler.stats.marqueeFrames, 40);
+    CHECK(!FrameSchedulerWantsHighResolution(&scheduler));
+
+    FrameSchedulerSetIntervals(&scheduler, 33, 33);
+    CHECK(FrameSchedulerNextDelay(&scheduler) <= 33);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 990, -1), 30);
+
+    FrameSchedulerSetIntervals(&scheduler, 100, 100);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 1000, -1), 10);
+
+    // 内容截止夹在滚动帧之间时单独唤醒一次
+    scheduler.stats.contentFrames = 0;
+    FrameSchedulerSetContentDelay(&scheduler, 550);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 1000, -1), 11);
+    CHECK_EQ(scheduler.stats.contentFrames, 1);
+    CHECK_EQ(scheduler.stats.idleWakeups, 0);
+
+    FrameSchedulerSetMarquee(&scheduler, 0);
+    CHECK_EQ(FrameSchedulerNextDelay(&scheduler), FRAME_SCHEDULER_NO_DEADLINE);
+}
+
+// 动画：开始时立即到期并需要高精度定时器，每 16 ms 一帧，期间暂停滚动帧；结束后释放高精度定时器并恢复滚动
+static void TestAnimationHoldsHighResolutionOnlyWhileAnimating(void) {
+    FrameScheduler scheduler;
+    InitScheduler(&scheduler, 16, 40);
+    FrameSchedulerSetMarquee(&scheduler, 1);
+    CHECK(!FrameSchedulerWantsHighResolution(&scheduler));
+
+    FrameSchedulerStartAnimation(&scheduler);
+    CHECK(FrameSchedulerWantsHighResolution(&scheduler));
+    CHECK_EQ(FrameSchedulerNextDelay(&scheduler), 0);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 300, -1), 19);   // 0, 16, ..., 288
+    CHECK_EQ(scheduler.stats.animationFrames, 19);
+    CHECK_EQ(scheduler.stats.marqueeFrames, 0);
+    CHECK(FrameSchedulerWantsHighResolution(&scheduler));
+
+    FrameSchedulerStopAnimation(&scheduler);
+    CHECK(!FrameSchedulerWantsHighResolution(&scheduler));
+    CHECK_EQ(FrameSchedulerNextDelay(&scheduler), 40);
+    CHECK_EQ(RunUntil(&scheduler, g_nowMs + 400, -1), 10);
+    CHECK_EQ(scheduler.stats.marqueeFrames, 10);
+    CHECK_EQ(scheduler.stats.animationFrames, 19);
+}
+
+// 合并：同一帧截止时间之前的多次请求只取出一次
+static void TestInvalidationsCoalesce(void) {
+    FrameScheduler scheduler;
+    InitScheduler(&scheduler, 16, 40);
+    CHECK_EQ(FrameSchedulerInvalidate(&scheduler, FRAME_INVALIDATE_CREATE), 1);
+    CHECK_EQ(FrameSchedulerInvalidate(&scheduler, FRAME_INVALIDATE_SIZE), 0);
+    CHECK_EQ(FrameSchedulerInvalidate(&scheduler, FRAME_INVALIDATE_PAINT), 0);
+    CHECK_EQ(FrameSchedulerTakeInvalidations(&scheduler),
+             (1u << FRAME_INVALIDATE_CREATE) | (1u << FRAME_INVALIDATE_SIZE) | (1u << FRAME_INVALIDATE_PAINT));
+    CHECK_EQ(FrameSchedulerTakeInvalidations(&scheduler), 0);
+    CHECK_EQ(scheduler.stats.invalidatedFrames, 1);
+    CHECK_EQ(FrameSchedulerInvalidate(&scheduler, FRAME_INVALIDATE_REASON_COUNT), 0);
+}
+
+int main(void) {
+    TestIdleWakesOncePerContentChange();
+    TestMarqueeWakesAtTierInterval();
+    TestAnimationHoldsHighResolutionOnlyWhileAnimating();
+    TestInvalidationsCoalesce();
+    return TestExitCode("test_frame_scheduler");
+}
@@ -0,0 +1,239 @@
+#include "test_common.h"
+#include "../ics_import.h"
+#include <string.h>
+
+// iCalendar 导入：每周/每天重复的展开、EXDATE、COUNT/UNTIL、UTC 换算与节次映射，
+// 以及折行与转义在任意读块边界上都得到相同的结果
+
+// 四节课：08:00-08:45、08:55-09:40、10:00-10:45、10:55-11:40
+static const PeriodTime g_periods[] = {
+    {480, 525}, {535, 580}, {600, 645}, {655, 700},
+};
+
+#define MAX_RECORDED 64
+
+typedef struct {
+    int count;
+    IcsOccurrence items[MAX_RECORDED];
+    char summaries[MAX_RECORDED][64];
+    char locations[MAX_RECORDED][64];
+} Recorder;
+
+static int Record(void *user, const IcsOccurrence *occurrence) {
+    Recorder *recorder = (Recorder*)user;
+    if (recorder->count >= MAX_RECORDED) return 0;
+    int i = recorder->count++;
+    recorder->items[i] = *occurrence;
+    snprintf(recorder->summaries[i], sizeof(recorder->summaries[i]), "%.*s",
+             (int)occurrence->summaryLength, occurrence->summary);
+    snprintf(recorder->locations[i], sizeof(recorder->locations[i]), "%.*s",
+             (int)occurrence->locationLength, occurrence->location);
+    return 1;
+}
+
+static IcsImportOptions DefaultOptions(void) {
+    IcsImportOptions options;
+    memset(&options, 0, sizeof(options));
+    options.periods = g_periods;
+    options.periodCount = (int)(sizeof(g_periods) / sizeof(g_periods[0]));
+    return options;
+}
+
+static int Import(const char *text, const IcsImportOptions *options, Recorder *recorder, IcsImportStats *stats) {
+    memset(recorder, 0, sizeof(*recorder));
+    return IcsImportMemory(text, strlen(text), options, Record, recorder, stats);
+}
+
+static int32_t Date(const char *text) {
+    int32_t days = 0;
+    CHECK(IcsParseDate(text, &days));
+    return days;
+}
+
+static void TestDates(void) {
+    CHECK_EQ(Date("1970-01-01"), 0);
+    CHECK_EQ(IcsWeekday(0), 3);                      // 1970-01-01 为周四
+    CHECK_EQ(Date("20240902"), Date("2024-09-02"));
+    CHECK_EQ(IcsWeekday(Date("2024-09-02")), 0);     // 周一
+    CHECK_EQ(Date("2024-03-01") - Date("2024-02-28"), 2);   // 闰年
+    int32_t days = 0;
+    CHECK(!IcsParseDate("2024-13-01", &days));
+    CHECK(!IcsParseDate("hello", &days));
+}
+
+// 每周一、三，COUNT=6：EXDATE 去掉的一次仍计入 COUNT，跨两节的课映射为节次范围
+static void TestWeeklyCountAndExdate(void) {
+    const char *ics =
+        "BEGIN:VCALENDAR\r\n"
+        "BEGIN:VEVENT\r\n"
+        "DTSTART:20240902T080000\r\n"
+        "DTEND:20240902T094000\r\n"
+        "RRULE:FREQ=WEEKLY;BYDAY=MO,WE;COUNT=6\r\n"
+        "EXDATE:20240904T080000\r\n"
+        "SUMMARY:Math\\, Advanced\r\n"
+        "LOCATION:Room 1\r\n"
+        " 01\r\n"
+        "END:VEVENT\r\n"
+        "END:VCALENDAR\r\n";
+    IcsImportOptions options = DefaultOptions();
+    Recorder recorder;
+    IcsImportStats stats;
+    CHECK(Import(ics, &options, &recorder, &stats));
+    CHECK_EQ(stats.events, 1);
+    CHECK_EQ(stats.occurrences, 5);
+    CHECK_EQ(stats.unmapped, 0);
+    CHECK_EQ(stats.errorLine, 0);
+    CHECK_EQ(recorder.count, 5);
+
+    static const char *expected[] = {"2024-09-02", "2024-09-09", "2024-09-11", "2024-09-16", "2024-09-18"};
+    static const int expectedDays[] = {0, 0, 2, 0, 2};
+    for (int i = 0; i < recorder.count && i < 5; ++i) {
+        CHECK_EQ(recorder.items[i].date, Date(expected[i]));
+        CHECK_EQ(recorder.items[i].day, expectedDays[i]);
+        CHECK_EQ(recorder.items[i].firstSlot, 0);
+        CHECK_EQ(recorder.items[i].lastSlot, 1);
+        CHECK(strcmp(recorder.summaries[i], "Math, Advanced") == 0);
+        CHECK(strcmp(recorder.locations[i], "Room 101") == 0);
+    }
+}
+
+// 隔周周二，只有日期的 UNTIL 包含当天；另一事件每天重复、UTC 时间按偏移换算
+static void TestUntilIntervalAndUtc(void) {
+    const char *ics =
+        "BEGIN:VEVENT\n"
+        "DTSTART;TZID=Asia/Shanghai:20240903T100000\n"
+        "DURATION:PT45M\n"
+        "RRULE:FREQ=WEEKLY;INTERVAL=2;UNTIL=20241001\n"
+        "SUMMARY:Art\n"
+        "END:VEVENT\n"
+        "BEGIN:VEVENT\n"
+        "DTSTART:20240905T005500Z\n"
+        "DTEND:20240905T014000Z\n"
+        "RRULE:FREQ=DAILY;COUNT=3\n"
+        "SUMMARY:PE\n"
+        "END:VEVENT\n";
+    IcsImportOptions options = DefaultOptions();
+    options.utcOffsetMinutes = 480;
+    Recorder recorder;
+    IcsImportStats stats;
+    CHECK(Import(ics, &options, &recorder, &stats));
+    CHECK_EQ(stats.events, 2);
+    CHECK_EQ(recorder.count, 6);
+    if (recorder.count != 6) return;
+
+    static const char *artDates[] = {"2024-09-03", "2024-09-17", "2024-10-01"};
+    for (int i = 0; i < 3; ++i) {
+        CHECK_EQ(recorder.items[i].date, Date(artDates[i]));
+        CHECK_EQ(recorder.items[i].day, 1);
+        CHECK_EQ(recorder.items[i].firstSlot, 2);
+        CHECK_EQ(recorder.items[i].lastSlot, 2);
+    }
+    for (int i = 3; i < 6; ++i) {
+        CHECK_EQ(recorder.items[i].date, Date("2024-09-05") + (i - 3));
+        CHECK_EQ(recorder.items[i].day, 3 + (i - 3));
+        CHECK_EQ(recorder.items[i].firstSlot, 1);    // 00:55Z = 08:55 本地
+        CHECK_EQ(recorder.items[i].lastSlot, 1);
+        CHECK(strcmp(recorder.summaries[i], "PE") == 0);
+    }
+
+    // 日期范围只保留 [9 月 10 日, 9 月 20 日) 内的上课
+    options.firstDate = Date("2024-09-10");
+    options.lastDate = Date("2024-09-20");
+    CHECK(Import(ics, &options, &recorder, &stats));
+    CHECK_EQ(recorder.count, 1);
+    CHECK_EQ(recorder.items[0].date, Date("2024-09-17"));
+}
+
+// 全天、取消与缺少 DTSTART 的事件跳过，不与任何节次重叠的计入 unmapped
+static void TestSkippedAndUnmapped(void) {
+    const char *ics =
+        "BEGIN:VEVENT\r\nDTSTART;VALUE=DATE:20240902\r\nSUMMARY:Holiday\r\nEND:VEVENT\r\n"
+        "BEGIN:VEVENT\r\nDTSTART:20240902T080000\r\nSTATUS:CANCELLED\r\nEND:VEVENT\r\n"
+        "BEGIN:VEVENT\r\nSUMMARY:No start\r\nEND:VEVENT\r\n"
+        "BEGIN:VEVENT\r\nDTSTART:20240902T123000\r\nDTEND:20240902T133000\r\nEND:VEVENT\r\n"
+        "BEGIN:VEVENT\r\nDTSTART:20240902T104000\r\nDTEND:20240902T110000\r\nEND:VEVENT\r\n";
+    IcsImportOptions options = DefaultOptions();
+    Recorder recorder;
+    IcsImportStats stats;
+    CHECK(Import(ics, &options, &recorder, &stats));
+    CHECK_EQ(stats.events, 5);
+    CHECK_EQ(stats.skipped, 3);
+    CHECK_EQ(stats.occurrences, 2);
+    CHECK_EQ(stats.unmapped, 1);
+    CHECK_EQ(recorder.count, 1);
+    CHECK_EQ(recorder.items[0].firstSlot, 2);        // 10:40-11:00 与第 3、4 节重叠
+    CHECK_EQ(recorder.items[0].lastSlot, 3);
+}
+
+static int StopAfterFirst(void *user, const IcsOccurrence *occurrence) {
+    (void)occurrence;
+    ++*(int*)user;
+    return 0;
+}
+
+// 嵌套的 VEVENT 与回调返回 0 都使导入失败并指出逻辑行
+static void TestErrors(void) {
+    IcsImportOptions options = DefaultOptions();
+    Recorder recorder;
+    IcsImportStats stats;
+    CHECK(!Import("BEGIN:VEVENT\nBEGIN:VEVENT\nEND:VEVENT\n", &options, &recorder, &stats));
+    CHECK_EQ(stats.errorLine, 2);
+
+    int calls = 0;
+    const char *ics = "BEGIN:VEVENT\nDTSTART:20240902T080000\nRRULE:FREQ=DAILY;COUNT=5\nEND:VEVENT\n";
+    CHECK(!IcsImportMemory(ics, strlen(ics), &options, StopAfterFirst, &calls, &stats));
+    CHECK_EQ(calls, 1);
+    CHECK_EQ(stats.errorLine, 4);
+}
+
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t offset;
+    size_t chunk;
+} ChunkReader;
+
+static size_t ReadChunk(void *user, char *buffer, size_t capacity) {
+    ChunkReader *reader = (ChunkReader*)user;
+    size_t n = reader->size - reader->offset;
+    if (n > reader->chunk) n = reader->chunk;
+    if (n > capacity) n = capacity;
+    memcpy(buffer, reader->data + reader->offset, n);
+    reader->offset += n;
+    return n;
+}
+
+// 每次只读几个字节：折行、CRLF 与转义跨读块边界时结果与一次读入相同
+static void TestChunkBoundaries(void) {
+    const char *ics =
+        "BEGIN:VEVENT\r\n"
+        "DTSTART:2024090\r\n"
+        " 2T080000\r\n"
+        "DTEND:20240902T084500\r\n"
+        "RRULE:FREQ=WEEKLY;COUNT=3\r\n"
+        "SUMMARY:Chem\\;\r\n"
+        "\tistry\\nLab\r\n"
+        "END:VEVENT\r\n";
+    IcsImportOptions options = DefaultOptions();
+    for (size_t chunk = 1; chunk <= 9; ++chunk) {
+        ChunkReader reader = {ics, strlen(ics), 0, chunk};
+        Recorder recorder;
+        IcsImportStats stats;
+        memset(&recorder, 0, sizeof(recorder));
+        CHECK(IcsImport(ReadChunk, &reader, &options, Record, &recorder, &stats));
+        CHECK_EQ(recorder.count, 3);
+        CHECK_EQ(recorder.items[0].date, Date("2024-09-02"));
+        CHECK_EQ(recorder.items[2].date, Date("2024-09-16"));
+        CHECK(strcmp(recorder.summaries[0], "Chem;istry Lab") == 0);   // 文本中的换行显示为空格
+    }
+}
+
+int main(void) {
+    TestDates();
+    TestWeeklyCountAndExdate();
+    TestUntilIntervalAndUtc();
+    TestSkippedAndUnmapped();
+    TestErrors();
+    TestChunkBoundaries();
+    return TestExitCode("test_ics_import");
+}
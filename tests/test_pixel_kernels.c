@@ -0,0 +1,311 @@
+#include "test_common.h"
+#include "../pixel_kernels.h"
+#include "../corner_tiles.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 像素内核与原逐像素浮点公式（填充背景预乘色、与背景比较、圆角遮罩后按 alpha 预乘并除 255）逐字节对比，
+// 每个指令集分别运行；表面宽度为奇数、stride 大于宽度时行尾的填充字节必须保持不变
+
+#define PAD_SENTINEL 0xDEADBEEFu
+#define BASE_ALPHA   180
+#define BASE_RADIUS  16
+
+static const PixelIsa g_isas[] = {PIXEL_ISA_SCALAR, PIXEL_ISA_SSE2, PIXEL_ISA_AVX2};
+
+static uint32_t g_rng = 12345;
+
+static uint32_t NextRandom(void) {
+    g_rng = g_rng * 1103515245u + 12345u;
+    return g_rng >> 8;
+}
+
+// 原 RenderLayered 中的逐像素公式：text 非 0 的像素视为 GDI 写入的文本颜色
+static void ReferenceFrame(uint8_t *bytes, int width, int height, int stride, int corner,
+                           uint32_t bgRgb, const uint8_t *text, uint32_t textRgb) {
+    uint8_t bgR = (uint8_t)(bgRgb >> 16), bgG = (uint8_t)(bgRgb >> 8), bgB = (uint8_t)bgRgb;
+    uint8_t baseAlpha = BASE_ALPHA;
+    uint8_t bgRp = (uint8_t)((bgR * baseAlpha) / 255);
+    uint8_t bgGp = (uint8_t)((bgG * baseAlpha) / 255);
+    uint8_t bgBp = (uint8_t)((bgB * baseAlpha) / 255);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t *ptr = bytes + ((size_t)y * stride + x) * 4;
+            ptr[0] = bgBp;
+            ptr[1] = bgGp;
+            ptr[2] = bgRp;
+            ptr[3] = baseAlpha;
+            if (text[(size_t)y * width + x]) {
+                ptr[0] = (uint8_t)textRgb;
+                ptr[1] = (uint8_t)(textRgb >> 8);
+                ptr[2] = (uint8_t)(textRgb >> 16);
+            }
+        }
+    }
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t *ptr = bytes + ((size_t)y * stride + x) * 4;
+            uint8_t b = ptr[0], g = ptr[1], r = ptr[2];
+            float cx = x + 0.5f;
+            float cy = y + 0.5f;
+            float mask = 1.0f;
+
+            if ((cx < corner && cy < corner) || (cx < corner && cy > height - corner)
+             || (cx > width - corner && cy < corner) || (cx > width - corner && cy > height - corner)) {
+                float centerX = (cx < corner) ? (corner - 0.5f) : (width - corner - 0.5f);
+                float centerY = (cy < corner) ? (corner - 0.5f) : (height - corner - 0.5f);
+                float dx = cx - centerX;
+                float dy = cy - centerY;
+                float dist2 = dx * dx + dy * dy;
+                float rFloat = (float)corner;
+                float rMinus = rFloat - 0.5f;
+                float rPlus = rFloat + 0.5f;
+                float rMinus2 = rMinus * rMinus;
+                float rPlus2 = rPlus * rPlus;
+
+                if (dist2 <= rMinus2) {
+                    mask = 1.0f;
+                } else if (dist2 >= rPlus2) {
+                    mask = 0.0f;
+                } else {
+                    mask = (rPlus2 - dist2) / (rPlus2 - rMinus2);
+                    if (mask < 0.0f) mask = 0.0f;
+                    if (mask > 1.0f) mask = 1.0f;
+                }
+            }
+
+            uint8_t maskAlpha = (uint8_t)(baseAlpha * mask + 0.5f);
+            if (b == bgBp && g == bgGp && r == bgRp) {
+                ptr[3] = maskAlpha;
+                ptr[2] = (uint8_t)((bgR * (int)maskAlpha) / 255);
+                ptr[1] = (uint8_t)((bgG * (int)maskAlpha) / 255);
+                ptr[0] = (uint8_t)((bgB * (int)maskAlpha) / 255);
+            } else {
+                ptr[3] = 255;
+            }
+        }
+    }
+}
+
+static int MinInt(int a, int b) { return a < b ? a : b; }
+static int MaxInt(int a, int b) { return a > b ? a : b; }
+
+// 与 render_core.c 的 CompositeLayer 相同的分段：四角用圆角贴片，其余整段交给内核
+static void KernelFrame(uint32_t *pixels, uint8_t *coverage, int width, int height, int stride,
+                        const CornerTiles *tiles, uint32_t bgRgb) {
+    uint32_t bgBase = PixelPremultiply(bgRgb, BASE_ALPHA);
+    int corner = tiles->radius;
+    int leftEnd = MinInt(corner, width);
+    int rightStart = MaxInt(leftEnd, width - corner);
+    int topEnd = MinInt(corner, height);
+    int bottomStart = MaxInt(topEnd, height - corner);
+    int rightOrigin = width - corner;
+
+    for (int y = 0; y < height; ++y) {
+        uint32_t *row = pixels + (size_t)y * stride;
+        const uint8_t *cov = coverage + (size_t)y * stride;
+        if (y >= topEnd && y < bottomStart) {
+            PixelCompositeSpan(row, cov, (size_t)width, bgBase);
+            continue;
+        }
+        int top = (y < topEnd);
+        int tileRow = top ? y : (y - (height - corner));
+        const uint8_t *leftAlpha = CornerTilesRow(tiles, top ? CORNER_TOP_LEFT : CORNER_BOTTOM_LEFT, tileRow);
+        const uint8_t *rightAlpha = CornerTilesRow(tiles, top ? CORNER_TOP_RIGHT : CORNER_BOTTOM_RIGHT, tileRow);
+        PixelCompositeSpanMasked(row, cov, leftAlpha, (size_t)leftEnd, bgRgb);
+        if (leftEnd < rightStart) {
+            PixelCompositeSpan(row + leftEnd, cov + leftEnd, (size_t)(rightStart - leftEnd), bgBase);
+        }
+        if (rightStart < width) {
+            PixelCompositeSpanMasked(row + rightStart, cov + rightStart, rightAlpha + (rightStart - rightOrigin),
+                                     (size_t)(width - rightStart), bgRgb);
+        }
+    }
+}
+
+// 一个尺寸与 stride 的完整帧：返回不一致的字节数（含被改写的行尾填充）
+static size_t CompareFrame(int width, int height, int pad, unsigned int dpi, uint32_t bgRgb, uint32_t textRgb) {
+    int stride = width + pad;
+    size_t cells = (size_t)stride * height;
+    uint32_t *expected = (uint32_t*)malloc(cells * sizeof(uint32_t));
+    uint32_t *pixels = (uint32_t*)malloc(cells * sizeof(uint32_t));
+    uint8_t *coverage = (uint8_t*)calloc(cells, 1);
+    uint8_t *text = (uint8_t*)calloc((size_t)width * height, 1);
+    const CornerTiles *tiles = CornerTilesGet(BASE_RADIUS, dpi, BASE_ALPHA);
+    if (!expected || !pixels || !coverage || !text || !tiles) {
+        free(expected); free(pixels); free(coverage); free(text);
+        return (size_t)-1;
+    }
+
+    // 文本：随机的横条，含落在圆角里的像素
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            text[(size_t)y * width + x] = (NextRandom() % 7) == 0;
+        }
+    }
+    for (size_t i = 0; i < cells; ++i) {
+        expected[i] = PAD_SENTINEL;
+        pixels[i] = PAD_SENTINEL;
+    }
+
+    ReferenceFrame((uint8_t*)expected, width, height, stride, tiles->radius, bgRgb, text, textRgb);
+
+    // 内核路径：文本层写入文本颜色与满覆盖度，其余像素保留上一帧的任意内容
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = (size_t)y * stride + x;
+            int isText = text[(size_t)y * width + x];
+            pixels[i] = isText ? textRgb : NextRandom();
+            coverage[i] = isText ? 255 : 0;
+        }
+    }
+    KernelFrame(pixels, coverage, width, height, stride, tiles, bgRgb);
+
+    size_t mismatches = 0;
+    const uint8_t *a = (const uint8_t*)expected;
+    const uint8_t *b = (const uint8_t*)pixels;
+    for (size_t i = 0; i < cells * 4; ++i) {
+        mismatches += a[i] != b[i];
+    }
+    free(expected); free(pixels); free(coverage); free(text);
+    return mismatches;
+}
+
+static void TestPremultiply(void) {
+    size_t mismatches = 0;
+    for (uint32_t c = 0; c < 256; ++c) {
+        for (uint32_t a = 0; a < 256; ++a) {
+            uint32_t rgb = (c << 16) | ((255 - c) << 8) | (c ^ 0x5A);
+            uint32_t out = PixelPremultiply(rgb, (uint8_t)a);
+            uint32_t expected = (a << 24) | (((c * a) / 255) << 16) | ((((255 - c) * a) / 255) << 8) | (((c ^ 0x5A) * a) / 255);
+            mismatches += out != expected;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void TestCornerAlpha(void) {
+    // 与原公式在像素中心的距离平方上逐一比较
+    size_t mismatches = 0;
+    for (int radius = 4; radius <= 48; ++radius) {
+        for (int dy = -radius - 1; dy <= radius + 1; ++dy) {
+            for (int dx = -radius - 1; dx <= radius + 1; ++dx) {
+                float dist2 = (float)dx * dx + (float)dy * dy;
+                float rMinus = radius - 0.5f, rPlus = radius + 0.5f;
+                float rMinus2 = rMinus * rMinus, rPlus2 = rPlus * rPlus;
+                float mask;
+                if (dist2 <= rMinus2) {
+                    mask = 1.0f;
+                } else if (dist2 >= rPlus2) {
+                    mask = 0.0f;
+                } else {
+                    mask = (rPlus2 - dist2) / (rPlus2 - rMinus2);
+                    if (mask < 0.0f) mask = 0.0f;
+                    if (mask > 1.0f) mask = 1.0f;
+                }
+                uint8_t expected = (uint8_t)(BASE_ALPHA * mask + 0.5f);
+                mismatches += PixelCornerAlpha(dx, dy, radius, BASE_ALPHA) != expected;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void TestFill(void) {
+    uint32_t buffer[80];
+    size_t mismatches = 0;
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t count = 0; count + offset + 1 < sizeof(buffer) / sizeof(buffer[0]); ++count) {
+            for (size_t i = 0; i < sizeof(buffer) / sizeof(buffer[0]); ++i) buffer[i] = PAD_SENTINEL;
+            PixelFill(buffer + offset, count, 0xB4123456u);
+            for (size_t i = 0; i < sizeof(buffer) / sizeof(buffer[0]); ++i) {
+                uint32_t expected = (i >= offset && i < offset + count) ? 0xB4123456u : PAD_SENTINEL;
+                mismatches += buffer[i] != expected;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+// 部分覆盖度：与整数公式 (文本 * c + 背景 * (255 - c)) / 255 比较，起点与长度覆盖各种对齐
+static void TestCompositePartial(void) {
+    enum { SPAN = 67 };
+    uint32_t dst[SPAN], over[SPAN], background[SPAN], src[SPAN];
+    uint8_t coverage[SPAN];
+    size_t mismatches = 0;
+    for (int round = 0; round < 200; ++round) {
+        uint32_t bgValue = PixelPremultiply(NextRandom() & 0xFFFFFF, (uint8_t)NextRandom());
+        for (int i = 0; i < SPAN; ++i) {
+            src[i] = NextRandom();
+            background[i] = PixelPremultiply(NextRandom() & 0xFFFFFF, (uint8_t)NextRandom());
+            uint32_t r = NextRandom() % 4;
+            coverage[i] = (uint8_t)(r == 0 ? 0 : r == 1 ? 255 : NextRandom());
+        }
+        size_t start = (size_t)round % 9;
+        size_t count = SPAN - start - (size_t)(round % 5);
+        memcpy(dst, src, sizeof(dst));
+        memcpy(over, src, sizeof(over));
+        PixelCompositeSpan(dst + start, coverage + start, count, bgValue);
+        PixelCompositeSpanOver(over + start, coverage + start, background + start, count);
+
+        for (size_t i = 0; i < SPAN; ++i) {
+            uint32_t expected = src[i], expectedOver = src[i];
+            if (i >= start && i < start + count) {
+                uint32_t c = coverage[i], text = src[i] | 0xFF000000u;
+                expected = expectedOver = 0;
+                for (int shift = 0; shift < 32; shift += 8) {
+                    uint32_t t = (text >> shift) & 0xFF;
+                    expected |= ((t * c + ((bgValue >> shift) & 0xFF) * (255 - c)) / 255) << shift;
+                    expectedOver |= ((t * c + ((background[i] >> shift) & 0xFF) * (255 - c)) / 255) << shift;
+                }
+            }
+            mismatches += (dst[i] != expected) + (over[i] != expectedOver);
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void TestFrames(void) {
+    static const int widths[] = {1, 3, 5, 17, 31, 33, 63, 101, 421};
+    static const int heights[] = {1, 7, 24, 65, 361};
+    static const int pads[] = {0, 1, 3, 8};
+    static const unsigned int dpis[] = {96, 120, 144, 192};
+    static const uint32_t backgrounds[] = {0x000000, 0x336699, 0xFFFFFF};
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+        for (size_t h = 0; h < sizeof(heights) / sizeof(heights[0]); ++h) {
+            for (size_t p = 0; p < sizeof(pads) / sizeof(pads[0]); ++p) {
+                size_t variant = w + h + p;
+                unsigned int dpi = dpis[variant % 4];
+                uint32_t bg = backgrounds[variant % 3];
+                uint32_t textRgb = (bg == 0xFFFFFF) ? 0x102030 : 0xFFFFFF;
+                size_t mismatches = CompareFrame(widths[w], heights[h], pads[p], dpi, bg, textRgb);
+                if (mismatches) {
+                    fprintf(stderr, "frame %dx%d pad %d dpi %u bg %06X: %zu bytes differ\n",
+                            widths[w], heights[h], pads[p], dpi, (unsigned)bg, mismatches);
+                }
+                CHECK_EQ(mismatches, 0);
+            }
+        }
+    }
+}
+
+int main(void) {
+    TestCornerAlpha();
+    for (size_t i = 0; i < sizeof(g_isas) / sizeof(g_isas[0]); ++i) {
+        PixelKernelsForceIsa(g_isas[i]);
+        if (PixelKernelsIsa() != g_isas[i]) {
+            printf("isa %s not supported, skipped\n", PixelKernelsIsaName(g_isas[i]));
+            continue;
+        }
+        printf("isa %s\n", PixelKernelsIsaName(g_isas[i]));
+        TestPremultiply();
+        TestFill();
+        TestCompositePartial();
+        TestFrames();
+    }
+    CornerTilesClear();
+    return TestExitCode("test_pixel_kernels");
+}
@@ -0,0 +1,212 @@
+#include "test_common.h"
+#include "../schedule.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// 课程表镜像：字符串去重后同名课程共用 ID，占用位与名称 ID 一致（跨 32 节的第二个字也要正确），
+// 打开时拒绝占用位不一致的镜像，版本 1 的文件映射时转换为当前格式且内容不变
+
+#define TEST_DAYS    5
+#define TEST_CLASSES 40   // 每天两个占用位字
+
+static TTCHAR g_math[] = {'M', 'a', 't', 'h', 0};
+static TTCHAR g_mathCopy[] = {'M', 'a', 't', 'h', 0};   // 内容相同、地址不同
+static TTCHAR g_art[] = {'A', 'r', 't', 0};
+static TTCHAR g_room101[] = {'1', '0', '1', 0};
+static TTCHAR g_room202[] = {'2', '0', '2', 0};
+
+static const ScheduleEntry g_entries[] = {
+    {0, 0, g_math, g_room101},
+    {0, 1, g_art, NULL},
+    {1, 3, g_mathCopy, g_room101},
+    {2, 31, g_art, g_room202},
+    {2, 32, g_math, g_room202},
+    {4, 39, g_mathCopy, g_room101},
+};
+#define ENTRY_COUNT ((int)(sizeof(g_entries) / sizeof(g_entries[0])))
+
+static int SameText(const TTCHAR *a, const TTCHAR *b) {
+    if (!a || !b) return a == b;
+    while (*a && *a == *b) ++a, ++b;
+    return *a == *b;
+}
+
+static int BuildTestSchedule(Schedule *schedule) {
+    Arena storage;
+    size_t size = 0;
+    if (!ScheduleBuildImage(TEST_DAYS, TEST_CLASSES, g_entries, ENTRY_COUNT, &storage, &size)) return 0;
+    if (!ScheduleOpenMemory(storage.base, size, schedule)) {
+        ArenaRelease(&storage);
+        return 0;
+    }
+    schedule->storage = storage;
+    return 1;
+}
+
+// 检查课程表内容与 g_entries 一致，其余单元格为空
+static void CheckContents(const Schedule *schedule) {
+    CHECK_EQ(schedule->days, TEST_DAYS);
+    CHECK_EQ(schedule->classes, TEST_CLASSES);
+    CHECK_EQ(schedule->occupancyWords, 2);
+    int occupied = 0;
+    for (int d = 0; d < TEST_DAYS; ++d) {
+        for (int p = 0; p < TEST_CLASSES; ++p) {
+            const ScheduleEntry *entry = NULL;
+            for (int i = 0; i < ENTRY_COUNT; ++i) {
+                if (g_entries[i].day == d && g_entries[i].slot == p) entry = &g_entries[i];
+            }
+            occupied += ScheduleIsOccupied(schedule, d, p);
+            CHECK_EQ(ScheduleIsOccupied(schedule, d, p), entry != NULL);
+            CHECK(SameText(ScheduleName(schedule, d, p), entry ? entry->name : NULL));
+            CHECK(SameText(ScheduleLocation(schedule, d, p), entry ? entry->location : NULL));
+        }
+    }
+    CHECK_EQ(occupied, ENTRY_COUNT);
+}
+
+static void TestInterningSharesIds(void) {
+    Schedule schedule;
+    CHECK(BuildTestSchedule(&schedule));
+    CheckContents(&schedule);
+
+    // Math、Art、101、202 四个字符串；不同地址的同名课程共用一个 ID
+    CHECK_EQ(schedule.stringCount, 4);
+    uint16_t math = ScheduleNameId(&schedule, 0, 0);
+    CHECK(math != 0);
+    CHECK_EQ(ScheduleNameId(&schedule, 1, 3), math);
+    CHECK_EQ(ScheduleNameId(&schedule, 2, 32), math);
+    CHECK_EQ(ScheduleNameId(&schedule, 4, 39), math);
+    CHECK(ScheduleNameId(&schedule, 0, 1) != math);
+    CHECK_EQ(ScheduleNameId(&schedule, 2, 31), ScheduleNameId(&schedule, 0, 1));
+    CHECK_EQ(ScheduleLocationId(&schedule, 1, 3), ScheduleLocationId(&schedule, 0, 0));
+    CHECK_EQ(ScheduleLocationId(&schedule, 0, 1), 0);
+
+    // 第 31、32 节分别落在两个占用位字的最高位与最低位
+    CHECK_EQ(schedule.occupancy[2 * 2 + 0], 1u << 31);
+    CHECK_EQ(schedule.occupancy[2 * 2 + 1], 1u);
+    CHECK_EQ(schedule.occupancy[4 * 2 + 1], 1u << 7);
+
+    // 越界访问返回空
+    CHECK_EQ(ScheduleNameId(&schedule, TEST_DAYS, 0), 0);
+    CHECK_EQ(ScheduleNameId(&schedule, 0, TEST_CLASSES), 0);
+    CHECK_EQ(ScheduleIsOccupied(&schedule, -1, 0), 0);
+    CHECK(ScheduleName(&schedule, 0, -1) == NULL);
+    ScheduleClose(&schedule);
+}
+
+// 占用位与名称 ID 不一致或文件被截断时拒绝打开
+static void TestOpenRejectsInconsistentImage(void) {
+    Arena storage;
+    size_t size = 0;
+    CHECK(ScheduleBuildImage(TEST_DAYS, TEST_CLASSES, g_entries, ENTRY_COUNT, &storage, &size));
+    Schedule schedule;
+    CHECK(ScheduleOpenMemory(storage.base, size, &schedule));
+    CHECK(!ScheduleOpenMemory(storage.base, size - 4, &schedule));
+
+    ScheduleFileHeader *header = (ScheduleFileHeader*)storage.base;
+    uint32_t *occupancy = (uint32_t*)((uint8_t*)storage.base + header->occupancyOffset);
+    occupancy[1] ^= 1u << 5;   // 第 0 天第 37 节为空课却置位
+    CHECK(!ScheduleOpenMemory(storage.base, size, &schedule));
+    occupancy[1] ^= 1u << 5;
+    occupancy[0] ^= 1u;        // 第 0 天第 0 节有课却未置位
+    CHECK(!ScheduleOpenMemory(storage.base, size, &schedule));
+    occupancy[0] ^= 1u;
+    CHECK(ScheduleOpenMemory(storage.base, size, &schedule));
+    ArenaRelease(&storage);
+}
+
+// 按版本 1 的布局（每节课交错存放 (名称, 位置) ID）写出文件，映射后应得到相同内容的当前格式
+static void TestLegacyFileUpgrades(void) {
+    Schedule current;
+    CHECK(BuildTestSchedule(&current));
+
+    uint32_t header[9];
+    size_t slotCount = (size_t)TEST_DAYS * TEST_CLASSES * 2;
+    uint32_t slotsOffset = sizeof(header);
+    uint32_t stringIndexOffset = slotsOffset + (uint32_t)((slotCount * sizeof(uint16_t) + 3) & ~(size_t)3);
+    uint32_t stringDataOffset = stringIndexOffset + (uint32_t)current.stringCount * sizeof(uint32_t);
+    uint32_t stringDataLength = current.header->stringDataLength;
+    uint32_t fileSize = stringDataOffset + stringDataLength * sizeof(TTCHAR);
+    header[0] = SCHEDULE_MAGIC;
+    header[1] = 1u | ((uint32_t)sizeof(header) << 16);                 // version, headerSize
+    header[2] = TEST_DAYS | ((uint32_t)TEST_CLASSES << 16);             // days, classes
+    header[3] = (uint32_t)current.stringCount;
+    header[4] = slotsOffset;
+    header[5] = stringIndexOffset;
+    header[6] = stringDataOffset;
+    header[7] = stringDataLength;
+    header[8] = fileSize;
+
+    uint8_t *file = (uint8_t*)calloc(1, fileSize);
+    CHECK(file != NULL);
+    if (!file) return;
+    memcpy(file, header, sizeof(header));
+    uint16_t *slots = (uint16_t*)(file + slotsOffset);
+    for (size_t cell = 0; cell < slotCount / 2; ++cell) {
+        slots[cell * 2] = current.nameIds[cell];
+        slots[cell * 2 + 1] = current.locationIds[cell];
+    }
+    memcpy(file + stringIndexOffset, current.stringIndex, (size_t)current.stringCount * sizeof(uint32_t));
+    memcpy(file + stringDataOffset, current.strings, stringDataLength * sizeof(TTCHAR));
+
+    char path[] = "/tmp/test_schedule_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    if (fd >= 0) {
+        CHECK_EQ(write(fd, file, fileSize), fileSize);
+        close(fd);
+        Schedule legacy;
+        CHECK(ScheduleMapFile(path, &legacy));
+        CHECK_EQ(legacy.header->version, SCHEDULE_VERSION);
+        CheckContents(&legacy);
+        uint8_t changed[TEST_DAYS * TEST_CLASSES];
+        CHECK_EQ(ScheduleDiff(&current, &legacy, changed), 0);
+        ScheduleClose(&legacy);
+        unlink(path);
+    }
+    free(file);
+    ScheduleClose(&current);
+}
+
+// 逐格比较按内容进行：只有改动的单元格被标记
+static void TestDiffMarksChangedCells(void) {
+    Schedule previous;
+    CHECK(BuildTestSchedule(&previous));
+
+    ScheduleEntry entries[ENTRY_COUNT];
+    memcpy(entries, g_entries, sizeof(entries));
+    entries[2].location = g_room202;   // 第 1 天第 3 节换教室
+    entries[5].slot = 38;              // 第 4 天的课从第 39 节移到第 38 节
+    Arena storage;
+    size_t size = 0;
+    Schedule next;
+    CHECK(ScheduleBuildImage(TEST_DAYS, TEST_CLASSES, entries, ENTRY_COUNT, &storage, &size));
+    CHECK(ScheduleOpenMemory(storage.base, size, &next));
+    next.storage = storage;
+
+    uint8_t changed[TEST_DAYS * TEST_CLASSES];
+    CHECK_EQ(ScheduleDiff(&previous, &next, changed), 3);
+    CHECK_EQ(changed[1 * TEST_CLASSES + 3], 1);
+    CHECK_EQ(changed[4 * TEST_CLASSES + 38], 1);
+    CHECK_EQ(changed[4 * TEST_CLASSES + 39], 1);
+    CHECK_EQ(changed[0], 0);
+    ScheduleClose(&next);
+
+    Arena smallStorage;
+    Schedule small;
+    CHECK(ScheduleBuildImage(TEST_DAYS, 8, g_entries, 2, &smallStorage, &size));
+    CHECK(ScheduleOpenMemory(smallStorage.base, size, &small));
+    small.storage = smallStorage;
+    CHECK_EQ(ScheduleDiff(&previous, &small, changed), -1);
+    ScheduleClose(&small);
+    ScheduleClose(&previous);
+}
+
+int main(void) {
+    TestInterningSharesIds();
+    TestOpenRejectsInconsistentImage();
+    TestLegacyFileUpgrades();
+    TestDiffMarksChangedCells();
+    return TestExitCode("test_schedule");
+}
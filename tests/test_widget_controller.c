@@ -0,0 +1,422 @@
+#include "test_common.h"
+#include "../widget_controller.h"
+#include "../render_core.h"
+#include <string.h>
+
+// 窗口状态机按脚本驱动：假后端记录每个回调的次数，虚拟时钟只在等待定时器时推进
+// 消息循环的顺序与 timetable.c 相同——投递的服务消息与“帧已提交”在当前回调返回后处理，
+// 定时器一次只设置一个（不短于 USER_TIMER_MINIMUM），改变窗口尺寸时产生一次 size 重绘请求
+
+#define FAKE_TIMER_MINIMUM_MS 10
+
+typedef struct {
+    WidgetController controller;
+    WidgetMetrics metrics;
+    uint64_t nowMs;
+
+    // 后端的输入
+    int overflow;                 // 最近一帧是否有滚动文本
+    int64_t contentPeriodMs;      // 内容每隔这么久变化一次（对齐到 0），-1 为不变化
+    double frameCostMs;
+    int occluded;                 // 窗口是否被完全遮挡
+
+    // 后端的状态与计数
+    WidgetRect windowRect;
+    int servicePending;
+    int presentPending;
+    int timerArmed;
+    uint64_t timerAtMs;
+    int highResolution;
+    unsigned int renders;         // 完整渲染
+    unsigned int marqueeRenders;  // 只画滚动帧
+    unsigned int posts;
+    unsigned int timerArms;
+    unsigned int timerKills;
+    unsigned int reserves;        // 预留表面（不含释放）
+    unsigned int reserveReleases;
+    int reserveWidth;
+    int reserveHeight;
+    unsigned int highResolutionAcquires;
+    unsigned int highResolutionReleases;
+    unsigned int moves;
+    unsigned int redrawMoves;
+    unsigned int trims;
+    unsigned int hudNotes;
+    unsigned int occlusionChecks;
+    char hudNote[160];
+} Fake;
+
+static uint64_t FakeNow(void *user) {
+    return ((Fake*)user)->nowMs;
+}
+
+static void FakeSetWindowRect(void *user, const WidgetRect *rect, int redraw) {
+    Fake *fake = (Fake*)user;
+    int resized = rect->right - rect->left != fake->windowRect.right - fake->windowRect.left ||
+                  rect->bottom - rect->top != fake->windowRect.bottom - fake->windowRect.top;
+    fake->windowRect = *rect;
+    fake->moves++;
+    if (redraw) fake->redrawMoves++;
+    if (resized) {
+        WidgetControllerInvalidate(&fake->controller, FRAME_INVALIDATE_SIZE);   // 同步的 WM_SIZE
+    }
+}
+
+static void FakeRender(void *user, int viewMode, int marquee) {
+    Fake *fake = (Fake*)user;
+    (void)viewMode;
+    if (marquee) {
+        fake->marqueeRenders++;
+    } else {
+        fake->renders++;
+    }
+    fake->presentPending = 1;
+}
+
+static void FakePostService(void *user) {
+    Fake *fake = (Fake*)user;
+    fake->posts++;
+    fake->servicePending = 1;
+}
+
+static void FakeArmTimer(void *user, int64_t delayMs) {
+    Fake *fake = (Fake*)user;
+    if (delayMs == FRAME_SCHEDULER_NO_DEADLINE) {
+        fake->timerKills++;
+        fake->timerArmed = 0;
+        return;
+    }
+    if (delayMs < FAKE_TIMER_MINIMUM_MS) delayMs = FAKE_TIMER_MINIMUM_MS;
+    fake->timerArms++;
+    fake->timerArmed = 1;
+    fake->timerAtMs = fake->nowMs + (uint64_t)delayMs;
+}
+
+static int FakeSetHighResolution(void *user, int enable) {
+    Fake *fake = (Fake*)user;
+    if (enable) {
+        fake->highResolutionAcquires++;
+    } else {
+        fake->highResolutionReleases++;
+    }
+    fake->highResolution = enable;
+    return enable;
+}
+
+static void FakeReserveSurfaces(void *user, int width, int height) {
+    Fake *fake = (Fake*)user;
+    if (width == 0 && height == 0) {
+        fake->reserveReleases++;
+    } else {
+        fake->reserves++;
+    }
+    fake->reserveWidth = width;
+    fake->reserveHeight = height;
+}
+
+static void FakeTrimIdle(void *user) {
+    ((Fake*)user)->trims++;
+}
+
+static void FakeSetHudNote(void *user, const char *note) {
+    Fake *fake = (Fake*)user;
+    fake->hudNotes++;
+    snprintf(fake->hudNote, sizeof(fake->hudNote), "%s", note);
+}
+
+static int FakeHasOverflow(void *user) {
+    return ((Fake*)user)->overflow;
+}
+
+static int64_t FakeMsUntilContentChange(void *user) {
+    Fake *fake = (Fake*)user;
+    if (fake->contentPeriodMs < 0) return -1;
+    return fake->contentPeriodMs - (int64_t)(fake->nowMs % (uint64_t)fake->contentPeriodMs);
+}
+
+static double FakeLastFrameCostMs(void *user) {
+    return ((Fake*)user)->frameCostMs;
+}
+
+static int FakeIsOccluded(void *user) {
+    Fake *fake = (Fake*)user;
+    fake->occlusionChecks++;
+    return fake->occluded;
+}
+
+// 周视图 420x360，贴在 1920x1080 屏幕的右边缘
+static void FakeInit(Fake *fake, unsigned int dpi, int64_t contentPeriodMs) {
+    memset(fake, 0, sizeof(*fake));
+    fake->nowMs = 1000;
+    fake->contentPeriodMs = contentPeriodMs;
+    fake->frameCostMs = 0.5;
+    fake->metrics.screenWidth = 1920;
+    fake->metrics.screenHeight = 1080;
+    fake->metrics.dpi = dpi;
+    int margin = RenderScaleForDpi(WIDGET_SNAP_MARGIN, dpi);
+    WidgetRect rect = {1920 - margin - 420, 40, 1920 - margin, 400};
+    fake->windowRect = rect;
+
+    WidgetBackend backend = {
+        fake, FakeSetWindowRect, FakeRender, FakePostService, FakeArmTimer,
+        FakeSetHighResolution, FakeReserveSurfaces, FakeTrimIdle, FakeSetHudNote,
+        FakeHasOverflow, FakeMsUntilContentChange, FakeLastFrameCostMs, FakeIsOccluded
+    };
+    FrameClock clock = {FakeNow, fake};
+    WidgetControllerInit(&fake->controller, &backend, &clock, 1, &rect, &fake->metrics);
+}
+
+// 处理排队的消息；定时器只在没有其他消息时触发，触发前把时钟推进到截止时间
+static void RunUntil(Fake *fake, uint64_t endMs) {
+    for (;;) {
+        if (fake->servicePending) {
+            fake->servicePending = 0;
+            WidgetControllerService(&fake->controller);
+        } else if (fake->presentPending) {
+            fake->presentPending = 0;
+            WidgetControllerOnFramePresented(&fake->controller);
+        } else if (fake->timerArmed && fake->timerAtMs <= endMs) {
+            fake->nowMs = fake->timerAtMs;
+            fake->timerArmed = 0;
+            WidgetControllerOnTimer(&fake->controller, &fake->metrics);
+        } else {
+            fake->nowMs = endMs;
+            return;
+        }
+    }
+}
+
+static void ResetCounts(Fake *fake) {
+    fake->renders = fake->marqueeRenders = fake->posts = 0;
+    fake->timerArms = fake->timerKills = 0;
+    fake->reserves = fake->reserveReleases = 0;
+    fake->highResolutionAcquires = fake->highResolutionReleases = 0;
+    fake->moves = fake->redrawMoves = fake->trims = fake->hudNotes = 0;
+    fake->occlusionChecks = 0;
+}
+
+// 启动：创建、WM_SIZE 与 WM_PAINT 合并为一次渲染；之后空闲十分钟只在每分钟的内容变化时渲染，
+// 每次都释放渲染资源，从不提高定时器精度
+static void TestIdleMinuteTick(void) {
+    Fake fake;
+    FakeInit(&fake, 96, 60000);
+    WidgetControllerInvalidate(&fake.controller, FRAME_INVALIDATE_SIZE);
+    WidgetControllerInvalidate(&fake.controller, FRAME_INVALIDATE_PAINT);
+    RunUntil(&fake, fake.nowMs);
+    CHECK_EQ(fake.posts, 1);
+    CHECK_EQ(fake.renders, 1);
+    CHECK_EQ(fake.marqueeRenders, 0);
+    CHECK_EQ(fake.timerArms, 1);
+    CHECK_EQ(fake.timerAtMs, 60000);
+    CHECK_EQ(fake.trims, 1);
+
+    ResetCounts(&fake);
+    RunUntil(&fake, 10 * 60000 + 1);
+    CHECK_EQ(fake.renders, 10);
+    CHECK_EQ(fake.marqueeRenders, 0);
+    CHECK_EQ(fake.posts, 0);             // 定时器内直接渲染，不再投递服务消息
+    CHECK_EQ(fake.timerArms, 10);        // 每分钟：唤醒后取消定时器，帧提交后按下一次内容变化设置
+    CHECK_EQ(fake.timerKills, 10);
+    CHECK_EQ(fake.trims, 10);
+    CHECK_EQ(fake.highResolutionAcquires, 0);
+    CHECK_EQ(fake.moves, 0);
+    CHECK_EQ(fake.occlusionChecks, 0);   // 空闲时不检查遮挡
+    CHECK_EQ(fake.controller.scheduler.stats.idleWakeups, 0);
+}
+
+// 周视图切换到日视图：一次预留起止尺寸中较大者，动画期间持有高精度定时器，
+// 每个动画帧移动一次窗口并渲染一次（WM_SIZE 与动画帧合并），结束后释放预留与高精度定时器
+static void TestViewSwitchAnimation(void) {
+    Fake fake;
+    FakeInit(&fake, 96, 60000);
+    RunUntil(&fake, fake.nowMs);
+    ResetCounts(&fake);
+
+    WidgetRect start = fake.windowRect;
+    WidgetControllerSwitchView(&fake.controller, &start, &fake.metrics);
+    CHECK_EQ(fake.controller.viewMode, 0);
+    CHECK_EQ(fake.reserves, 1);
+    CHECK_EQ(fake.reserveWidth, 420);
+    CHECK_EQ(fake.reserveHeight, 360);
+    CHECK_EQ(fake.highResolutionAcquires, 1);
+    CHECK(fake.highResolution);
+
+    RunUntil(&fake, fake.nowMs + 400);
+    // 16 ms 间隔：0, 16, ..., 288 共 19 帧，300 ms 时停在目标矩形
+    CHECK_EQ(fake.moves, 20);
+    CHECK_EQ(fake.renders, 20);
+    CHECK_EQ(fake.marqueeRenders, 0);
+    CHECK_EQ(fake.posts, 0);
+    CHECK_EQ(fake.controller.scheduler.stats.animationFrames, 20);
+    CHECK_EQ(fake.reserveReleases, 1);
+    CHECK_EQ(fake.highResolutionReleases, 1);
+    CHECK(!fake.highResolution);
+    CHECK(!fake.controller.animating);
+
+    // 贴右边缘收缩：右边不动，宽度为 1/3，高度不变
+    CHECK_EQ(fake.windowRect.right, start.right);
+    CHECK_EQ(fake.windowRect.left, start.right - 140);
+    CHECK_EQ(fake.windowRect.top, start.top);
+    CHECK_EQ(fake.windowRect.bottom, start.bottom);
+    CHECK_EQ(fake.redrawMoves, 0);
+
+    // 切回周视图恢复原始宽度
+    ResetCounts(&fake);
+    WidgetControllerSwitchView(&fake.controller, &fake.windowRect, &fake.metrics);
+    RunUntil(&fake, fake.nowMs + 400);
+    CHECK_EQ(fake.windowRect.left, start.left);
+    CHECK_EQ(fake.windowRect.right, start.right);
+    CHECK_EQ(fake.renders, 20);
+    CHECK_EQ(fake.highResolutionAcquires, 1);
+    CHECK_EQ(fake.highResolutionReleases, 1);
+}
+
+// 有滚动文本时按滚动帧间隔只画滚动帧：40 px/s 时每 25 ms 一帧；
+// 使用电池时档位降到 30 FPS（33 ms），回到交流电后恢复；滚动停止后回到只按内容变化唤醒
+static void TestMarqueeCadence(void) {
+    Fake fake;
+    FakeInit(&fake, 96, 60000);
+    fake.overflow = 1;
+    RunUntil(&fake, fake.nowMs);
+    CHECK_EQ(fake.trims, 0);
+    ResetCounts(&fake);
+
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.marqueeRenders, 40);
+    CHECK_EQ(fake.renders, 0);
+    CHECK_EQ(fake.trims, 0);
+    CHECK_EQ(fake.highResolutionAcquires, 0);
+
+    WidgetControllerSetPower(&fake.controller, 1, 0);
+    CHECK_EQ(fake.controller.governor.tier, FRAME_TIER_30);
+    ResetCounts(&fake);
+    RunUntil(&fake, fake.nowMs + 990);
+    CHECK_EQ(fake.marqueeRenders, 30);
+
+    WidgetControllerSetPower(&fake.controller, 0, 0);
+    CHECK_EQ(fake.controller.governor.tier, FRAME_TIER_60);
+    ResetCounts(&fake);
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.marqueeRenders, 40);
+
+    // 内容变化后的一帧不再有滚动文本：滚动帧停止，空闲时释放资源
+    fake.overflow = 0;
+    WidgetControllerInvalidate(&fake.controller, FRAME_INVALIDATE_CONTENT);
+    ResetCounts(&fake);
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.renders, 1);
+    CHECK_EQ(fake.marqueeRenders, 0);
+    CHECK_EQ(fake.trims, 1);
+}
+
+// 遮挡：有滚动帧时每秒检查一次，被完全遮挡后降到 10 FPS，露出后的下一次检查恢复 40 FPS；
+// 默认（未遮挡、交流电）不限制，HUD 同时显示档位与滚动帧的实际帧率
+static void TestOcclusionCapsMarquee(void) {
+    Fake fake;
+    FakeInit(&fake, 96, 60000);
+    fake.overflow = 1;
+    WidgetControllerSetHud(&fake.controller, 1);
+    fake.contentPeriodMs = -1;
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.controller.governor.tier, FRAME_TIER_60);
+    CHECK_EQ(fake.controller.governor.limits, FRAME_LIMIT_NONE);
+    CHECK(strstr(fake.hudNote, "fps 60 marquee 40 ") != NULL);
+
+    ResetCounts(&fake);
+    RunUntil(&fake, fake.nowMs + 10000);
+    CHECK_EQ(fake.occlusionChecks, 10);
+
+    // 遮挡后最多一秒生效：之后每秒 10 帧
+    fake.occluded = 1;
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.controller.governor.tier, FRAME_TIER_10);
+    CHECK_EQ(fake.controller.governor.limits, FRAME_LIMIT_OCCLUDED);
+    ResetCounts(&fake);
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.marqueeRenders, 10);
+    CHECK_EQ(fake.renders, 2);           // HUD 每 500 ms 完整重绘一次
+    CHECK(strstr(fake.hudNote, "fps 10 marquee 10 ") != NULL);
+    CHECK(strstr(fake.hudNote, " covered") != NULL);
+
+    fake.occluded = 0;
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.controller.governor.tier, FRAME_TIER_60);
+    ResetCounts(&fake);
+    RunUntil(&fake, fake.nowMs + 1000);
+    CHECK_EQ(fake.marqueeRenders + fake.renders, 40);   // HUD 的完整重绘顶替同一时刻的滚动帧
+    CHECK_EQ(fake.renders, 2);
+    CHECK(strstr(fake.hudNote, "fps 60 marquee 40 ") != NULL);
+}
+
+// 拖动结束：距屏幕边缘小于吸附距离时贴到边距处，吸附距离与边距按 DPI 缩放
+static void TestSnapOnDrag(void) {
+    Fake fake;
+    FakeInit(&fake, 144, 60000);   // 吸附距离 30，边距 15
+    RunUntil(&fake, fake.nowMs);
+    ResetCounts(&fake);
+
+    WidgetRect nearTopLeft = {25, 8, 445, 368};
+    WidgetControllerEndMove(&fake.controller, &nearTopLeft, &fake.metrics);
+    CHECK_EQ(fake.moves, 1);
+    CHECK_EQ(fake.redrawMoves, 1);
+    CHECK_EQ(fake.windowRect.left, 15);
+    CHECK_EQ(fake.windowRect.top, 15);
+    CHECK_EQ(fake.windowRect.right, 435);
+    CHECK_EQ(fake.windowRect.bottom, 375);
+    CHECK_EQ(fake.controller.snapEdge, WIDGET_SNAP_LEFT);
+
+    WidgetRect nearBottomRight = {1480, 700, 1900, 1060};
+    WidgetControllerEndMove(&fake.controller, &nearBottomRight, &fake.metrics);
+    CHECK_EQ(fake.windowRect.left, 1920 - 15 - 420);
+    CHECK_EQ(fake.windowRect.top, 1080 - 15 - 360);
+    CHECK_EQ(fake.controller.snapEdge, WIDGET_SNAP_RIGHT);
+
+    // 离边缘 30 像素：不吸附，位置不变；离边距处仍不超过吸附距离，视图切换时按左边贴边收缩
+    WidgetRect nearLeft = {30, 30, 450, 390};
+    WidgetControllerEndMove(&fake.controller, &nearLeft, &fake.metrics);
+    CHECK_EQ(fake.windowRect.left, 30);
+    CHECK_EQ(fake.windowRect.top, 30);
+    CHECK_EQ(fake.controller.snapEdge, WIDGET_SNAP_LEFT);
+
+    WidgetRect free = {60, 60, 480, 420};
+    WidgetControllerEndMove(&fake.controller, &free, &fake.metrics);
+    CHECK_EQ(fake.windowRect.left, 60);
+    CHECK_EQ(fake.controller.snapEdge, WIDGET_SNAP_NONE);
+    CHECK_EQ(fake.moves, 4);
+
+    // 周视图下拖动结束记录新的窗口尺寸，之后的视图切换按它计算
+    WidgetRect resized = {60, 60, 660, 460};
+    WidgetControllerEndMove(&fake.controller, &resized, &fake.metrics);
+    CHECK_EQ(fake.controller.originalWidth, 600);
+    CHECK_EQ(fake.controller.originalHeight, 400);
+
+    // 拖动本身不渲染、不设置定时器（移动引起的重绘由 WM_SIZE / WM_PAINT 请求）
+    CHECK_EQ(fake.renders, 0);
+    CHECK_EQ(fake.timerArms, 0);
+}
+
+// 窗口销毁：动画中途退出也取消定时器并恢复定时器精度
+static void TestShutdownReleasesTimer(void) {
+    Fake fake;
+    FakeInit(&fake, 96, 60000);
+    RunUntil(&fake, fake.nowMs);
+    WidgetControllerSwitchView(&fake.controller, &fake.windowRect, &fake.metrics);
+    RunUntil(&fake, fake.nowMs + 100);
+    CHECK(fake.highResolution);
+    ResetCounts(&fake);
+    WidgetControllerShutdown(&fake.controller);
+    CHECK_EQ(fake.timerKills, 1);
+    CHECK(!fake.timerArmed);
+    CHECK_EQ(fake.highResolutionReleases, 1);
+    CHECK(!fake.highResolution);
+}
+
+int main(void) {
+    TestIdleMinuteTick();
+    TestViewSwitchAnimation();
+    TestMarqueeCadence();
+    TestOcclusionCapsMarquee();
+    TestSnapOnDrag();
+    TestShutdownReleasesTimer();
+    return TestExitCode("test_widget_controller");
+}
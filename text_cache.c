@@ -0,0 +1,221 @@
+#include "text_cache.h"
+#include "pixel_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 一周网格最多 12 节 × 7 天 × 2 行，加上表头、逐字测量与缩放时新旧字号并存，
+// 256 个条目会在每帧淘汰；1024 个足以让整个网格常驻
+#define TEXT_CACHE_CAPACITY 1024
+#define TEXT_CACHE_BUCKETS  2048  // 2 的幂
+#define TEXT_CACHE_NONE     (-1)
+
+typedef struct {
+    TextRun run;
+    TTCHAR *text;
+    int len;
+    int fontHeight;
+    unsigned int dpi;
+    uint32_t hash;
+    int hashNext;
+    int lruPrev;   // 越靠近表头越新
+    int lruNext;
+    int used;
+} TextCacheEntry;
+
+struct TextCache {
+    TextBackend backend;
+    TextCacheEntry entries[TEXT_CACHE_CAPACITY];
+    int buckets[TEXT_CACHE_BUCKETS];
+    int lruHead;
+    int lruTail;
+    int entryCount;
+    TextCacheStats stats;
+    int frameTextCalls;
+    int frameTextCallsAvoided;
+};
+
+static uint32_t HashRun(const TTCHAR *text, int len, int fontHeight, unsigned int dpi) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < len; ++i) {
+        h = (h ^ (uint32_t)text[i]) * 16777619u;
+    }
+    h = (h ^ (uint32_t)fontHeight) * 16777619u;
+    h = (h ^ (uint32_t)dpi) * 16777619u;
+    return h;
+}
+
+static void LruUnlink(TextCache *cache, int index) {
+    TextCacheEntry *e = &cache->entries[index];
+    if (e->lruPrev != TEXT_CACHE_NONE) cache->entries[e->lruPrev].lruNext = e->lruNext;
+    else cache->lruHead = e->lruNext;
+    if (e->lruNext != TEXT_CACHE_NONE) cache->entries[e->lruNext].lruPrev = e->lruPrev;
+    else cache->lruTail = e->lruPrev;
+    e->lruPrev = e->lruNext = TEXT_CACHE_NONE;
+}
+
+static void LruPushFront(TextCache *cache, int index) {
+    TextCacheEntry *e = &cache->entries[index];
+    e->lruPrev = TEXT_CACHE_NONE;
+    e->lruNext = cache->lruHead;
+    if (cache->lruHead != TEXT_CACHE_NONE) cache->entries[cache->lruHead].lruPrev = index;
+    cache->lruHead = index;
+    if (cache->lruTail == TEXT_CACHE_NONE) cache->lruTail = index;
+}
+
+static void BucketUnlink(TextCache *cache, int index) {
+    int *link = &cache->buckets[cache->entries[index].hash & (TEXT_CACHE_BUCKETS - 1)];
+    while (*link != TEXT_CACHE_NONE) {
+        if (*link == index) {
+            *link = cache->entries[index].hashNext;
+            return;
+        }
+        link = &cache->entries[*link].hashNext;
+    }
+}
+
+static void ReleaseEntry(TextCache *cache, int index) {
+    TextCacheEntry *e = &cache->entries[index];
+    BucketUnlink(cache, index);
+    LruUnlink(cache, index);
+    free(e->text);
+    free(e->run.coverage);
+    memset(e, 0, sizeof(*e));
+    e->hashNext = e->lruPrev = e->lruNext = TEXT_CACHE_NONE;
+    cache->entryCount--;
+}
+
+static int AcquireSlot(TextCache *cache) {
+    if (cache->entryCount < TEXT_CACHE_CAPACITY) {
+        for (int i = 0; i < TEXT_CACHE_CAPACITY; ++i) {
+            if (!cache->entries[i].used) return i;
+        }
+    }
+    // 淘汰最久未使用的条目
+    int victim = cache->lruTail;
+    ReleaseEntry(cache, victim);
+    cache->stats.evictions++;
+    return victim;
+}
+
+TextCache *TextCacheCreate(const TextBackend *backend) {
+    if (!backend || !backend->rasterize) return NULL;
+    TextCache *cache = (TextCache*)calloc(1, sizeof(TextCache));
+    if (!cache) return NULL;
+
+    cache->backend = *backend;
+    for (int i = 0; i < TEXT_CACHE_BUCKETS; ++i) {
+        cache->buckets[i] = TEXT_CACHE_NONE;
+    }
+    cache->lruHead = TEXT_CACHE_NONE;
+    cache->lruTail = TEXT_CACHE_NONE;
+    return cache;
+}
+
+void TextCacheDestroy(TextCache *cache) {
+    if (!cache) return;
+    TextCacheClear(cache);
+    free(cache);
+}
+
+const TextRun *TextCacheLookup(TextCache *cache, const TTCHAR *text, int len, int fontHeight, unsigned int dpi) {
+    if (!cache || !text || len <= 0) return NULL;
+
+    uint32_t hash = HashRun(text, len, fontHeight, dpi);
+    for (int i = cache->buckets[hash & (TEXT_CACHE_BUCKETS - 1)]; i != TEXT_CACHE_NONE; i = cache->entries[i].hashNext) {
+        TextCacheEntry *e = &cache->entries[i];
+        if (e->hash == hash && e->len == len && e->fontHeight == fontHeight && e->dpi == dpi &&
+            memcmp(e->text, text, (size_t)len * sizeof(TTCHAR)) == 0) {
+            LruUnlink(cache, i);
+            LruPushFront(cache, i);
+            cache->stats.hits++;
+            cache->frameTextCallsAvoided++; // 省去测量
+            e->run.cached = 1;
+            return &e->run;
+        }
+    }
+
+    cache->stats.misses++;
+    cache->frameTextCalls += 2; // 测量 + 光栅化
+    TextRun run = {0};
+    TTCHAR *copy = (TTCHAR*)malloc((size_t)len * sizeof(TTCHAR));
+    if (!copy || !cache->backend.rasterize(cache->backend.user, text, len, fontHeight, &run)) {
+        free(copy);
+        return NULL;
+    }
+    memcpy(copy, text, (size_t)len * sizeof(TTCHAR));
+
+    int index = AcquireSlot(cache);
+    TextCacheEntry *e = &cache->entries[index];
+    e->run = run;
+    e->run.cached = 0;
+    e->text = copy;
+    e->len = len;
+    e->fontHeight = fontHeight;
+    e->dpi = dpi;
+    e->hash = hash;
+    e->used = 1;
+    int *bucket = &cache->buckets[hash & (TEXT_CACHE_BUCKETS - 1)];
+    e->hashNext = *bucket;
+    *bucket = index;
+    LruPushFront(cache, index);
+    cache->entryCount++;
+    return &e->run;
+}
+
+void TextCacheBlit(TextCache *cache, const TextRun *run, uint32_t *colorDst, uint8_t *coverageDst,
+                   int dstWidth, int dstHeight, int dstStride, int x, int y,
+                   int clipLeft, int clipTop, int clipRight, int clipBottom, uint32_t rgb) {
+    if (!cache || !run || !colorDst || !coverageDst) return;
+
+    int left = x - run->padX;
+    int top = y;
+    int x0 = left > clipLeft ? left : clipLeft;
+    int y0 = top > clipTop ? top : clipTop;
+    int x1 = left + run->stripWidth;
+    int y1 = top + run->stripHeight;
+    if (x1 > clipRight) x1 = clipRight;
+    if (y1 > clipBottom) y1 = clipBottom;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > dstWidth) x1 = dstWidth;
+    if (y1 > dstHeight) y1 = dstHeight;
+
+    if (run->cached) {
+        cache->frameTextCallsAvoided++; // 省去光栅化（TextOutW）；未命中时光栅化已计入 frameTextCalls
+    }
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int row = y0; row < y1; ++row) {
+        const uint8_t *src = run->coverage + (size_t)(row - top) * run->stripWidth + (x0 - left);
+        size_t offset = (size_t)row * dstStride + x0;
+        PixelBlendCoverage(colorDst + offset, coverageDst + offset, src, (size_t)(x1 - x0), rgb);
+    }
+}
+
+void TextCacheBeginFrame(TextCache *cache) {
+    if (!cache) return;
+    cache->frameTextCalls = 0;
+    cache->frameTextCallsAvoided = 0;
+}
+
+void TextCacheEndFrame(TextCache *cache) {
+    if (!cache) return;
+    cache->stats.frameTextCalls = cache->frameTextCalls;
+    cache->stats.frameTextCallsAvoided = cache->frameTextCallsAvoided;
+}
+
+void TextCacheGetStats(const TextCache *cache, TextCacheStats *stats) {
+    if (!cache || !stats) return;
+    *stats = cache->stats;
+    stats->entries = cache->entryCount;
+}
+
+void TextCacheClear(TextCache *cache) {
+    if (!cache) return;
+    for (int i = 0; i < TEXT_CACHE_CAPACITY; ++i) {
+        if (cache->entries[i].used) {
+            ReleaseEntry(cache, i);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include <stdint.h>
+#include "timetable_data.h"
+
+// 文本段缓存：按 (字符串, 字体高度, DPI) 缓存测量结果与预渲染的 8 位覆盖度条带
+// 命中后绘制只是一次带裁剪的覆盖度叠加，不再调用后端的测量与光栅化
+// 颜色在叠加时才使用，同一文本的不同颜色共用一个条目
+// 本模块不依赖 Win32；光栅化由 TextBackend 提供（GDI 或无头软件后端）
+
+typedef struct {
+    int extentWidth;    // 测量宽度（GDI 后端即 GetTextExtentPoint32W 的结果）
+    int extentHeight;
+    int padX;           // 条带左右各留出的余量（字形可能超出测量宽度）
+    int stripWidth;
+    int stripHeight;
+    uint8_t *coverage;  // stripWidth * stripHeight，按行存放，由 malloc 分配
+    int cached;         // 最近一次查找命中缓存；刚光栅化的条目为 0，其绘制不计入省去的调用
+} TextRun;
+
+// 文本光栅化后端：测量 text 并填写 run（含 malloc 分配的覆盖度），成功返回非 0
+typedef struct {
+    void *user;
+    int (*rasterize)(void *user, const TTCHAR *text, int len, int fontHeight, TextRun *run);
+} TextBackend;
+
+typedef struct {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+    int entries;
+    int frameTextCalls;         // 上一帧实际发出的后端文本调用（测量 + 光栅化）
+    int frameTextCallsAvoided;  // 上一帧因命中缓存省去的文本调用（GDI 下即 GetTextExtentPoint32W / TextOutW）
+} TextCacheStats;
+
+typedef struct TextCache TextCache;
+
+TextCache *TextCacheCreate(const TextBackend *backend);
+void TextCacheDestroy(TextCache *cache);
+
+// 查找文本段，未命中时经后端测量并预渲染；失败返回 NULL
+const TextRun *TextCacheLookup(TextCache *cache, const TTCHAR *text, int len, int fontHeight, unsigned int dpi);
+
+// 以 rgb (0x00RRGGBB) 把条带叠加到文本层，(x, y) 为文本起点；只写入 [clipLeft, clipRight) x [clipTop, clipBottom)
+// colorDst 保存文本颜色，coverageDst 保存覆盖度，两者尺寸均为 dstWidth * dstHeight，每行相隔 dstStride 个元素
+void TextCacheBlit(TextCache *cache, const TextRun *run, uint32_t *colorDst, uint8_t *coverageDst,
+                   int dstWidth, int dstHeight, int dstStride, int x, int y,
+                   int clipLeft, int clipTop, int clipRight, int clipBottom, uint32_t rgb);
+
+// 帧计数：BeginFrame 清零本帧计数，EndFrame 锁存到统计结果
+void TextCacheBeginFrame(TextCache *cache);
+void TextCacheEndFrame(TextCache *cache);
+
+void TextCacheGetStats(const TextCache *cache, TextCacheStats *stats);
+
+// 释放所有条目
+void TextCacheClear(TextCache *cache);
+
+#endif // TEXT_CACHE_H
@@ -7,53 +7,36 @@
 #include <windows.h>
 #include <shellapi.h>
 #include <tchar.h>
-#include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <wchar.h>
 #include <mmsystem.h>
 #include "timetable_data.h"
 #include "sys_utils.h"
 #include "renderer.h"
+#include "widget_controller.h"
+#include "frame_trace.h"
 
 #define ID_TRAY_APP_ICON 1001
 #define ID_TRAY_EXIT     1002
 #define ID_TRAY_SWITCH   1003
 #define ID_TRAY_BOTTOM   1004
+#define ID_TRAY_HUD      1005
+#define ID_TRAY_TRACE    1006
 #define WM_SYSICON       (WM_USER + 1)
-#define SNAP_DIST        20
-#define SNAP_MARGIN      10
+#define WM_FRAME_SERVICE (WM_APP + 2)   // 动画之外的重绘请求在消息队列中的这一步统一处理
 
 HWND hWnd;
 NOTIFYICONDATA nid;
-int viewMode = 1; // 0=日视图，1=周视图（默认为周视图）
 
-// 缓动动画相关变量
-BOOL isAnimating = FALSE;
-RECT startRect, targetRect;
-static const double ANIMATION_DURATION_MS = 300.0; // 动画持续时间
-static const double FRAME_INTERVAL_MS = 1000.0 / 60.0;
-
-static BOOL precisionTimerActive = FALSE;
-static double animationStartMs = 0.0;
-static double lastAnimationFrameMs = 0.0;
-static double lastScrollFrameMs = 0.0;
-static ULONGLONG lastMinuteSlot = 0;
+// 计时状态机（动画、吸附、重绘合并、定时器）在 widget_controller.c，这里只实现 Win32 后端并转发消息
+static WidgetController controller;
+static int initialViewMode = 1; // 0=日视图，1=周视图（默认为周视图）
+static double frameBudgetMs = 0.0; // 0 为默认预算
 
 static LARGE_INTEGER perfFreq = {0};
 static LARGE_INTEGER perfBase = {0};
 
-// 原始窗口大小（周视图大小）
-int originalWidth, originalHeight;
-
-typedef enum {
-    SNAP_EDGE_NONE = 0,
-    SNAP_EDGE_LEFT,
-    SNAP_EDGE_RIGHT
-} SnapEdge;
-
-static SnapEdge currentSnapEdge = SNAP_EDGE_RIGHT;
-
-static BOOL scrollTimerActive = FALSE;
-
 static BOOL keepOnBottom = TRUE;
 
 static void EnsureBottomOrder(HWND hwnd) {
@@ -78,30 +61,149 @@ static double GetClockMs(void) {
     return (double)(now.QuadPart - perfBase.QuadPart) * 1000.0 / (double)perfFreq.QuadPart;
 }
 
-static SnapEdge DetectSnapEdge(const RECT *rc, int screenW, int snapMargin, int snapDist) {
-    if (!rc) return SNAP_EDGE_NONE;
-    int left = (int)rc->left;
-    int right = (int)rc->right;
-    if (abs(left - snapMargin) <= snapDist) {
-        return SNAP_EDGE_LEFT;
+static uint64_t SchedulerClockNow(void *user) {
+    (void)user;
+    return (uint64_t)GetClockMs();
+}
+
+static void GetWidgetMetrics(HWND hwnd, WidgetMetrics *metrics) {
+    metrics->screenWidth = GetSystemMetrics(SM_CXSCREEN);
+    metrics->screenHeight = GetSystemMetrics(SM_CYSCREEN);
+    metrics->dpi = GetWindowDpi(hwnd);
+}
+
+static void GetWidgetRect(HWND hwnd, WidgetRect *rect) {
+    RECT rc = {0};
+    GetWindowRect(hwnd, &rc);
+    rect->left = rc.left;
+    rect->top = rc.top;
+    rect->right = rc.right;
+    rect->bottom = rc.bottom;
+}
+
+// Win32 后端：user 为窗口句柄
+static void BackendSetWindowRect(void *user, const WidgetRect *rect, int redraw) {
+    HWND hwnd = (HWND)user;
+    SetWindowPos(hwnd, NULL, rect->left, rect->top, rect->right - rect->left, rect->bottom - rect->top,
+                 SWP_NOZORDER | SWP_NOACTIVATE | (redraw ? 0 : SWP_NOREDRAW));
+    EnsureBottomOrder(hwnd);
+}
+
+static void BackendRender(void *user, int viewMode, int marquee) {
+    if (marquee) {
+        RenderLayeredMarquee((HWND)user, viewMode);
+    } else {
+        RenderLayered((HWND)user, viewMode);
     }
-    if (abs((screenW - snapMargin) - right) <= snapDist) {
-        return SNAP_EDGE_RIGHT;
+}
+
+static void BackendPostService(void *user) {
+    PostMessage((HWND)user, WM_FRAME_SERVICE, 0, 0);
+}
+
+// 只用定时器 1，按最近的截止时间设置
+static void BackendArmTimer(void *user, int64_t delayMs) {
+    HWND hwnd = (HWND)user;
+    if (delayMs == FRAME_SCHEDULER_NO_DEADLINE) {
+        KillTimer(hwnd, 1);
+        return;
     }
-    return SNAP_EDGE_NONE;
+    if (delayMs < USER_TIMER_MINIMUM) delayMs = USER_TIMER_MINIMUM;
+    if (delayMs > USER_TIMER_MAXIMUM) delayMs = USER_TIMER_MAXIMUM;
+    SetTimer(hwnd, 1, (UINT)delayMs, NULL);
 }
 
+static int BackendSetHighResolution(void *user, int enable) {
+    (void)user;
+    if (!enable) {
+        timeEndPeriod(1);
+        return 0;
+    }
+    return timeBeginPeriod(1) == TIMERR_NOERROR;
+}
+
+static void BackendReserveSurfaces(void *user, int width, int height) {
+    (void)user;
+    RendererReserveSurfaces(width, height);
+}
 
-static void UpdateScrollTimer(HWND hwnd) {
-    BOOL needScroll = RendererHasOverflowingText();
-    if (needScroll && !scrollTimerActive) {
-        SetTimer(hwnd, 2, 40, NULL);
-        scrollTimerActive = TRUE;
-        lastScrollFrameMs = GetClockMs();
-    } else if (!needScroll && scrollTimerActive) {
-        KillTimer(hwnd, 2);
-        scrollTimerActive = FALSE;
+static void BackendTrimIdle(void *user) {
+    (void)user;
+    RendererTrimIdle();
+}
+
+static void BackendSetHudNote(void *user, const char *note) {
+    (void)user;
+    RendererSetHudNote(note);
+}
+
+static int BackendHasOverflow(void *user) {
+    (void)user;
+    return RendererHasOverflowingText() ? 1 : 0;
+}
+
+static int64_t BackendMsUntilContentChange(void *user) {
+    (void)user;
+    return RendererMsUntilContentChange();
+}
+
+static double BackendLastFrameCostMs(void *user) {
+    (void)user;
+    RendererPacingStats stats;
+    RendererGetPacingStats(&stats);
+    return stats.lastRenderMs + stats.lastPresentMs;
+}
+
+// 前台窗口完全盖住小组件时视为被遮挡；桌面、任务栏与小组件自身不算
+static int BackendIsOccluded(void *user) {
+    HWND hwnd = (HWND)user;
+    HWND foreground = GetForegroundWindow();
+    if (!foreground || foreground == hwnd || foreground == GetShellWindow() ||
+        !IsWindowVisible(foreground) || IsIconic(foreground)) {
+        return 0;
+    }
+    WCHAR className[32];
+    if (GetClassNameW(foreground, className, (int)(sizeof(className) / sizeof(className[0]))) &&
+        (lstrcmpW(className, L"WorkerW") == 0 || lstrcmpW(className, L"Progman") == 0 ||
+         lstrcmpW(className, L"Shell_TrayWnd") == 0)) {
+        return 0;
     }
+    RECT widget, cover;
+    if (!GetWindowRect(hwnd, &widget) || !GetWindowRect(foreground, &cover)) {
+        return 0;
+    }
+    return cover.left <= widget.left && cover.top <= widget.top &&
+           cover.right >= widget.right && cover.bottom >= widget.bottom;
+}
+
+// 电源状态变化时（含开关节电模式）调整帧率档位
+static void UpdatePowerState(void) {
+    SYSTEM_POWER_STATUS power;
+    if (GetSystemPowerStatus(&power)) {
+        WidgetControllerSetPower(&controller, power.ACLineStatus == 0, power.SystemStatusFlag == 1);
+    }
+}
+
+// 命令行 --frame-budget=<毫秒>：每秒最多用于滚动与动画渲染的时间
+static double ParseFrameBudget(const WCHAR *cmdLine) {
+    static const WCHAR prefix[] = L"--frame-budget=";
+    const WCHAR *option = cmdLine ? wcsstr(cmdLine, prefix) : NULL;
+    return option ? wcstod(option + wcslen(prefix), NULL) : 0.0;
+}
+
+// 帧追踪写到程序目录下的 frame_trace.json，可用 chrome://tracing 或 Perfetto 打开
+static void DumpFrameTrace(void) {
+    WCHAR path[MAX_PATH];
+    DWORD len = GetModuleFileNameW(NULL, path, MAX_PATH);
+    if (len == 0 || len >= MAX_PATH) return;
+    WCHAR *slash = wcsrchr(path, L'\\');
+    if (!slash || (size_t)(slash - path) + 18 >= MAX_PATH) return;
+    lstrcpyW(slash + 1, L"frame_trace.json");
+
+    FILE *file = _wfopen(path, L"w");
+    if (!file) return;
+    FrameTraceWriteChrome(file);
+    fclose(file);
 }
 
 // 窗口过程
@@ -118,164 +220,73 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         lstrcpyW(nid.szTip, L"课程表小组件");
         Shell_NotifyIcon(NIM_ADD, &nid);
 
-        if (!precisionTimerActive) {
-            if (timeBeginPeriod(1) == TIMERR_NOERROR) {
-                precisionTimerActive = TRUE;
-            }
-        }
-
-        SetTimer(hwnd, 1, 16, NULL); // 约 60 FPS 的主动画定时器
+        WidgetBackend backend = {
+            hwnd, BackendSetWindowRect, BackendRender, BackendPostService, BackendArmTimer,
+            BackendSetHighResolution, BackendReserveSurfaces, BackendTrimIdle, BackendSetHudNote,
+            BackendHasOverflow, BackendMsUntilContentChange, BackendLastFrameCostMs, BackendIsOccluded
+        };
+        FrameClock clock = {SchedulerClockNow, NULL};
+        WidgetRect initRect;
+        WidgetMetrics metrics;
+        GetWidgetRect(hwnd, &initRect);
+        GetWidgetMetrics(hwnd, &metrics);
         // ApplyRoundRegion(hwnd); // 已空实现，可不调用
-        // 首次渲染
-        RenderLayered(hwnd, viewMode);
-
-        UpdateScrollTimer(hwnd);
-
-        lastMinuteSlot = GetTickCount64() / 60000ULL;
-        lastAnimationFrameMs = GetClockMs();
-        lastScrollFrameMs = lastAnimationFrameMs;
-
-
-        RECT initRect;
-        if (GetWindowRect(hwnd, &initRect)) {
-            UINT dpi = GetWindowDpi(hwnd);
-            int snapDist = max(1, MulDiv(SNAP_DIST, dpi, 96));
-            int snapMargin = max(1, MulDiv(SNAP_MARGIN, dpi, 96));
-            int screenW = GetSystemMetrics(SM_CXSCREEN);
-            currentSnapEdge = DetectSnapEdge(&initRect, screenW, snapMargin, snapDist);
-        }
+        WidgetControllerInit(&controller, &backend, &clock, initialViewMode, &initRect, &metrics);
+        WidgetControllerSetFrameBudget(&controller, frameBudgetMs);
+        UpdatePowerState();
 
         EnsureBottomOrder(hwnd);
         break;
     }
     case WM_TIMER:
-        if (wParam == 1) { // 主定时器
-            double nowMs = GetClockMs();
-            BOOL shouldRender = FALSE;
-
-            if (isAnimating) {
-                double elapsed = nowMs - animationStartMs;
-                if (elapsed >= ANIMATION_DURATION_MS) {
-                    SetWindowPos(hwnd, NULL, targetRect.left, targetRect.top,
-                                 targetRect.right - targetRect.left,
-                                 targetRect.bottom - targetRect.top,
-                                 SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOREDRAW);
-            EnsureBottomOrder(hwnd);
-                    isAnimating = FALSE;
-                    UINT dpi = GetWindowDpi(hwnd);
-                    int snapDist = max(1, MulDiv(SNAP_DIST, dpi, 96));
-                    int snapMargin = max(1, MulDiv(SNAP_MARGIN, dpi, 96));
-                    int screenW = GetSystemMetrics(SM_CXSCREEN);
-                    currentSnapEdge = DetectSnapEdge(&targetRect, screenW, snapMargin, snapDist);
-                    lastAnimationFrameMs = nowMs;
-                    shouldRender = TRUE;
-                } else if (nowMs - lastAnimationFrameMs >= FRAME_INTERVAL_MS) {
-                    double progress = elapsed / ANIMATION_DURATION_MS;
-                    progress = 1.0 - pow(1.0 - progress, 3.0);
-
-                    int startWidth = startRect.right - startRect.left;
-                    int startHeight = startRect.bottom - startRect.top;
-                    int targetWidth = targetRect.right - targetRect.left;
-                    int targetHeight = targetRect.bottom - targetRect.top;
-
-                    int currentX = startRect.left + (int)((targetRect.left - startRect.left) * progress);
-                    int currentY = startRect.top + (int)((targetRect.top - startRect.top) * progress);
-                    int currentWidth = startWidth + (int)((targetWidth - startWidth) * progress);
-                    int currentHeight = startHeight + (int)((targetHeight - startHeight) * progress);
-
-                    SetWindowPos(hwnd, NULL, currentX, currentY, currentWidth, currentHeight,
-                                 SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOREDRAW);
-            EnsureBottomOrder(hwnd);
-                    lastAnimationFrameMs = nowMs;
-                    shouldRender = TRUE;
-                }
-            } else {
-                ULONGLONG currentSlot = GetTickCount64() / 60000ULL;
-                if (currentSlot != lastMinuteSlot) {
-                    lastMinuteSlot = currentSlot;
-                    shouldRender = TRUE;
-                }
-            }
+        if (wParam == 1) { // 唯一的调度定时器
+            WidgetMetrics metrics;
+            GetWidgetMetrics(hwnd, &metrics);
+            WidgetControllerOnTimer(&controller, &metrics);
+        }
+        break;
 
-            if (shouldRender) {
-                RenderLayered(hwnd, viewMode);
-                UpdateScrollTimer(hwnd);
-                lastScrollFrameMs = nowMs;
-            }
-        } else if (wParam == 2) {
-            if (!isAnimating) {
-                double nowMs = GetClockMs();
-                if (nowMs - lastScrollFrameMs >= FRAME_INTERVAL_MS) {
-                    lastScrollFrameMs = nowMs;
-                    RenderLayered(hwnd, viewMode);
-                    UpdateScrollTimer(hwnd);
-                }
-            }
+    case WM_FRAME_SERVICE:
+        WidgetControllerService(&controller);
+        break;
+
+    case WM_POWERBROADCAST:
+        if (wParam == PBT_APMPOWERSTATUSCHANGE) {
+            UpdatePowerState();
+            return TRUE;
+        }
+        return DefWindowProc(hwnd, msg, wParam, lParam);
+
+    case WM_RENDER_FRAME_READY:
+        if (RendererPresentFrame(hwnd)) {
+            WidgetControllerOnFramePresented(&controller);
         }
         break;
 
     case WM_PAINT: {
         PAINTSTRUCT ps;
         BeginPaint(hwnd, &ps);
-        // 使用 UpdateLayeredWindow 绘制内容
-        RenderLayered(hwnd, viewMode);
-        UpdateScrollTimer(hwnd);
+        // 内容由 UpdateLayeredWindow 提交，这里只记录重绘请求
+        WidgetControllerInvalidate(&controller, FRAME_INVALIDATE_PAINT);
         EndPaint(hwnd, &ps);
         break;
     }
     case WM_SIZE:
         //ApplyRoundRegion(hwnd); // 已空实现
-        // 重新渲染尺寸变化后的图像
-        RenderLayered(hwnd, viewMode);
-        UpdateScrollTimer(hwnd);
+        // 重新渲染尺寸变化后的图像（与同一帧的其他请求合并）
+        WidgetControllerInvalidate(&controller, FRAME_INVALIDATE_SIZE);
         break;
     case WM_LBUTTONDOWN: // 拖动窗口
         ReleaseCapture();
         SendMessage(hwnd, WM_NCLBUTTONDOWN, HTCAPTION, 0);
         break;
 
-    case WM_EXITSIZEMOVE: { // 拖动结束吸附（按窗口 DPI 缩放 SNAP 参数）
-        RECT rc;
-        GetWindowRect(hwnd, &rc);
-        int screenW = GetSystemMetrics(SM_CXSCREEN);
-        int screenH = GetSystemMetrics(SM_CYSCREEN);
-        int winW = rc.right - rc.left;
-        int winH = rc.bottom - rc.top;
-        int newX = rc.left, newY = rc.top;
-
-        // 保存原始窗口大小（周视图大小）
-        if (viewMode == 1) { // 周视图
-            originalWidth = winW;
-            originalHeight = winH;
-        }
-
-        // 按窗口 DPI 缩放距离和边距
-        UINT dpi = GetWindowDpi(hwnd);
-        int snapDist = max(1, MulDiv(SNAP_DIST, dpi, 96));
-        int snapMargin = max(1, MulDiv(SNAP_MARGIN, dpi, 96));
-
-        if (abs(rc.left - 0) < snapDist) {
-            newX = snapMargin;
-        }
-        if (abs(screenW - rc.right) < snapDist) {
-            int snapX = screenW - winW - snapMargin;
-            if (snapX < 0) snapX = 0;
-            newX = snapX;
-        }
-        if (abs(rc.top - 0) < snapDist) {
-            newY = snapMargin;
-        }
-        if (abs(screenH - rc.bottom) < snapDist) {
-            int snapY = screenH - winH - snapMargin;
-            if (snapY < 0) snapY = 0;
-            newY = snapY;
-        }
-        SetWindowPos(hwnd, NULL, newX, newY, winW, winH,
-                     SWP_NOZORDER|SWP_NOACTIVATE);
-        EnsureBottomOrder(hwnd);
-        RECT newRect;
-        GetWindowRect(hwnd, &newRect);
-        currentSnapEdge = DetectSnapEdge(&newRect, screenW, snapMargin, snapDist);
+    case WM_EXITSIZEMOVE: { // 拖动结束吸附（按窗口 DPI 缩放吸附距离）
+        WidgetRect rect;
+        WidgetMetrics metrics;
+        GetWidgetRect(hwnd, &rect);
+        GetWidgetMetrics(hwnd, &metrics);
+        WidgetControllerEndMove(&controller, &rect, &metrics);
         break;
     }
 
@@ -297,9 +308,12 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         if (lParam == WM_RBUTTONUP) {
             HMENU hMenu = CreatePopupMenu();
             AppendMenu(hMenu, MF_STRING, ID_TRAY_SWITCH,
-                       viewMode==0 ? L"切换到周视图" : L"切换到日视图");
+                       controller.viewMode==0 ? L"切换到周视图" : L"切换到日视图");
             AppendMenu(hMenu, MF_STRING | (keepOnBottom ? MF_CHECKED : MF_UNCHECKED),
                        ID_TRAY_BOTTOM, L"窗口总在底层");
+            AppendMenu(hMenu, MF_STRING | (controller.hudEnabled ? MF_CHECKED : MF_UNCHECKED),
+                       ID_TRAY_HUD, L"显示性能 HUD");
+            AppendMenu(hMenu, MF_STRING, ID_TRAY_TRACE, L"导出帧追踪");
             AppendMenu(hMenu, MF_STRING, ID_TRAY_EXIT, L"退出");
             POINT pt;
             GetCursorPos(&pt);
@@ -319,95 +333,30 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             if (keepOnBottom) {
                 EnsureBottomOrder(hwnd);
             }
-        } else if (LOWORD(wParam) == ID_TRAY_SWITCH) {
-            viewMode = 1 - viewMode; // 切换模式
-
-            // 获取当前窗口位置和大小
-            RECT currentRect;
-            GetWindowRect(hwnd, &currentRect);
-
-            // 计算目标位置和大小
-            targetRect = currentRect;
-
-            UINT dpi = GetWindowDpi(hwnd);
-            int snapDist = max(1, MulDiv(SNAP_DIST, dpi, 96));
-            int snapMargin = max(1, MulDiv(SNAP_MARGIN, dpi, 96));
-            int screenW = GetSystemMetrics(SM_CXSCREEN);
-
-            SnapEdge snapEdge = DetectSnapEdge(&currentRect, screenW, snapMargin, snapDist);
-            if (snapEdge != SNAP_EDGE_NONE) {
-                currentSnapEdge = snapEdge;
-            }
-
-            if (viewMode == 0) { // 切换到日视图 - 宽度缩小到1/3，高度不变
-                int newWidth = max(1, originalWidth / 3);
-                targetRect.bottom = targetRect.top + originalHeight;
-
-                if (currentSnapEdge == SNAP_EDGE_LEFT) {
-                    targetRect.left = currentRect.left;
-                    targetRect.right = targetRect.left + newWidth;
-                } else if (currentSnapEdge == SNAP_EDGE_RIGHT) {
-                    targetRect.right = currentRect.right;
-                    targetRect.left = targetRect.right - newWidth;
-                } else {
-                    targetRect.left = currentRect.left;
-                    targetRect.right = targetRect.left + newWidth;
-                    if (targetRect.right > screenW - snapMargin) {
-                        targetRect.right = screenW - snapMargin;
-                        targetRect.left = targetRect.right - newWidth;
-                    }
-                    if (targetRect.left < snapMargin) {
-                        targetRect.left = snapMargin;
-                        targetRect.right = targetRect.left + newWidth;
-                    }
-                }
-            } else { // 切换到周视图 - 恢复原始大小并向外扩展
-                targetRect.bottom = targetRect.top + originalHeight;
-                if (currentSnapEdge == SNAP_EDGE_LEFT) {
-                    targetRect.left = currentRect.left;
-                    targetRect.right = targetRect.left + originalWidth;
-                } else if (currentSnapEdge == SNAP_EDGE_RIGHT) {
-                    targetRect.right = currentRect.right;
-                    targetRect.left = targetRect.right - originalWidth;
-                } else {
-                    targetRect.left = currentRect.left;
-                    targetRect.right = targetRect.left + originalWidth;
-                    if (targetRect.right > screenW - snapMargin) {
-                        targetRect.right = screenW - snapMargin;
-                        targetRect.left = targetRect.right - originalWidth;
-                    }
-                    if (targetRect.left < snapMargin) {
-                        targetRect.left = snapMargin;
-                        targetRect.right = targetRect.left + originalWidth;
-                    }
-                }
-            }
-
-            SnapEdge newEdge = DetectSnapEdge(&targetRect, screenW, snapMargin, snapDist);
-            if (newEdge != SNAP_EDGE_NONE) {
-                currentSnapEdge = newEdge;
+        } else if (LOWORD(wParam) == ID_TRAY_HUD) {
+            BOOL hudEnabled = !controller.hudEnabled;
+            if (hudEnabled) {
+                GetClockMs(); // 在 UI 线程确定时钟起点，之后渲染线程也会读取
+                FrameTraceEnable(GetClockMs);
+            } else {
+                FrameTraceDisable(); // 已记录的事件保留，仍可导出
             }
-
-            // 启动动画
-            startRect = currentRect;
-            animationStartMs = GetClockMs();
-            lastAnimationFrameMs = animationStartMs;
-            lastScrollFrameMs = animationStartMs;
-            isAnimating = TRUE;
+            RendererSetHud(hudEnabled);
+            WidgetControllerSetHud(&controller, hudEnabled);
+        } else if (LOWORD(wParam) == ID_TRAY_TRACE) {
+            DumpFrameTrace();
+        } else if (LOWORD(wParam) == ID_TRAY_SWITCH) {
+            WidgetRect currentRect;
+            WidgetMetrics metrics;
+            GetWidgetRect(hwnd, &currentRect);
+            GetWidgetMetrics(hwnd, &metrics);
+            WidgetControllerSwitchView(&controller, &currentRect, &metrics);
         }
         break;
 
     case WM_DESTROY:
-        KillTimer(hwnd, 1);
-        if (scrollTimerActive) {
-            KillTimer(hwnd, 2);
-            scrollTimerActive = FALSE;
-        }
-
-        if (precisionTimerActive) {
-            timeEndPeriod(1);
-            precisionTimerActive = FALSE;
-        }
+        WidgetControllerShutdown(&controller);
+        RendererShutdown();
 
         Shell_NotifyIcon(NIM_DELETE, &nid);
         PostQuitMessage(0);
@@ -422,6 +371,11 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 // 程序入口
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
                    PWSTR lpCmdLine, int nCmdShow) {
+    // 启动计时：从这里到首次 UpdateLayeredWindow
+    RendererMarkProcessStart();
+
+    frameBudgetMs = ParseFrameBudget(lpCmdLine);
+
     // 建议让进程 DPI aware，以便按正确 DPI 创建初始窗口尺寸
     SetProcessDPIAware();
 
@@ -445,25 +399,17 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
     int x = screenW - winW - MulDiv(10, sysDpi, 96);
     int y = MulDiv(10, sysDpi, 96);
     
-    // 保存原始窗口大小
-    originalWidth = winW;
-    originalHeight = winH;
-
+    // 创建时的窗口尺寸即周视图尺寸
     hWnd = CreateWindowExW(WS_EX_TOOLWINDOW | WS_EX_LAYERED, cls, L"课程表",
                           WS_POPUP, x, y, winW, winH,
                           NULL, NULL, hInstance, NULL);
 
     // 不再使用 SetLayeredWindowAttributes；改为使用 UpdateLayeredWindow 在 RenderLayered 中控制像素 alpha
 
+    // 首帧已在 WM_CREATE 中请求，不再重复渲染
     ShowWindow(hWnd, nCmdShow);
     UpdateWindow(hWnd);
 
-    // 首次确保渲染（如果 WM_CREATE 未触发）
-    if (hWnd) {
-        RenderLayered(hWnd, viewMode);
-        UpdateScrollTimer(hWnd);
-    }
-
     MSG msg;
     while (GetMessage(&msg,NULL,0,0)>0) {
         TranslateMessage(&msg);
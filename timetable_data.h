@@ -1,15 +1,20 @@
 #ifndef TIMETABLE_DATA_H
 #define TIMETABLE_DATA_H
 
-#include <windows.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// UTF-16 文本（Windows 上与 WCHAR 布局相同，可直接传给 W 系列 API）
+typedef uint16_t TTCHAR;
+#define TT_TEXT(s) u##s
 
 #define DAYS 7
 #define CLASSES 8
 
 // 课程信息结构
 typedef struct {
-    WCHAR* name;      // 课程名称
-    WCHAR* location;  // 课程位置
+    const TTCHAR* name;      // 课程名称
+    const TTCHAR* location;  // 课程位置
 } ClassInfo;
 
 // 课程表数据（UTF-16）
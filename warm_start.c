@@ -0,0 +1,140 @@
+#include "warm_start.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define WARM_START_PATH_CHARS 1024
+
+static uint64_t MixWord(uint64_t hash, uint64_t word) {
+    hash ^= word;
+    hash *= 0xFF51AFD7ED558CCDull;
+    return hash ^ (hash >> 32);
+}
+
+uint64_t WarmStartHash(const void *data, size_t size, uint64_t seed) {
+    const uint8_t *bytes = (const uint8_t*)data;
+    uint64_t hash = seed ^ 0x9E3779B97F4A7C15ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = MixWord(hash, word);
+    }
+    uint64_t tail = 0;
+    for (size_t shift = 0; i < size; ++i, shift += 8) {
+        tail |= (uint64_t)bytes[i] << shift;
+    }
+    return MixWord(MixWord(hash, tail), (uint64_t)size);
+}
+
+uint64_t WarmStartScheduleHash(const Schedule *schedule) {
+    if (!schedule || !schedule->header) return 0;
+    return WarmStartHash(schedule->header, schedule->header->fileSize, 0);
+}
+
+static FILE *OpenCacheFile(const char *path, const char *mode) {
+#ifdef _WIN32
+    WCHAR widePath[MAX_PATH];
+    WCHAR wideMode[4];
+    if (!MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH) ||
+        !MultiByteToWideChar(CP_UTF8, 0, mode, -1, wideMode, 4)) {
+        return NULL;
+    }
+    return _wfopen(widePath, wideMode);
+#else
+    return fopen(path, mode);
+#endif
+}
+
+static int ReplaceCacheFile(const char *from, const char *to) {
+#ifdef _WIN32
+    WCHAR wideFrom[MAX_PATH];
+    WCHAR wideTo[MAX_PATH];
+    if (!MultiByteToWideChar(CP_UTF8, 0, from, -1, wideFrom, MAX_PATH) ||
+        !MultiByteToWideChar(CP_UTF8, 0, to, -1, wideTo, MAX_PATH)) {
+        return 0;
+    }
+    return MoveFileExW(wideFrom, wideTo, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+static void RemoveCacheFile(const char *path) {
+#ifdef _WIN32
+    WCHAR widePath[MAX_PATH];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath, MAX_PATH)) {
+        DeleteFileW(widePath);
+    }
+#else
+    remove(path);
+#endif
+}
+
+static int KeyMatches(const WarmStartFileHeader *h, const WarmStartKey *key, int minuteOfDay) {
+    return h->magic == WARM_START_MAGIC && h->version == WARM_START_VERSION &&
+           h->headerSize == sizeof(WarmStartFileHeader) && h->scheduleHash == key->scheduleHash &&
+           h->width == key->width && h->height == key->height && h->dpi == key->dpi &&
+           h->viewMode == key->viewMode && h->today == key->today &&
+           minuteOfDay >= h->firstMinute && minuteOfDay < h->endMinute;
+}
+
+int WarmStartLoad(const char *path, const WarmStartKey *key, int minuteOfDay, uint32_t *pixels, int stride) {
+    if (!path || !key || !pixels || key->width <= 0 || key->height <= 0 || stride < key->width) return 0;
+    FILE *f = OpenCacheFile(path, "rb");
+    if (!f) return 0;
+
+    // 只读文件头即可判断是否命中，未命中时不读像素
+    WarmStartFileHeader h;
+    int ok = fread(&h, sizeof(h), 1, f) == 1 && KeyMatches(&h, key, minuteOfDay);
+    uint64_t hash = 0;
+    size_t rowBytes = sizeof(uint32_t) * (size_t)key->width;
+    for (int y = 0; ok && y < key->height; ++y) {
+        uint32_t *row = pixels + (size_t)y * stride;
+        ok = fread(row, rowBytes, 1, f) == 1;
+        hash = WarmStartHash(row, rowBytes, hash);
+    }
+    fclose(f);
+    return ok && hash == h.pixelHash;
+}
+
+int WarmStartSave(const char *path, const WarmStartKey *key, int firstMinute, int endMinute,
+                  const uint32_t *pixels, int stride) {
+    if (!path || !key || !pixels || key->width <= 0 || key->height <= 0 || stride < key->width) return 0;
+    char tempPath[WARM_START_PATH_CHARS];
+    if (snprintf(tempPath, sizeof(tempPath), "%s.tmp", path) >= (int)sizeof(tempPath)) return 0;
+
+    WarmStartFileHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = WARM_START_MAGIC;
+    h.version = WARM_START_VERSION;
+    h.headerSize = sizeof(WarmStartFileHeader);
+    h.scheduleHash = key->scheduleHash;
+    h.width = key->width;
+    h.height = key->height;
+    h.dpi = key->dpi;
+    h.viewMode = key->viewMode;
+    h.today = key->today;
+    h.firstMinute = firstMinute;
+    h.endMinute = endMinute;
+    size_t rowBytes = sizeof(uint32_t) * (size_t)key->width;
+    for (int y = 0; y < key->height; ++y) {
+        h.pixelHash = WarmStartHash(pixels + (size_t)y * stride, rowBytes, h.pixelHash);
+    }
+
+    FILE *f = OpenCacheFile(tempPath, "wb");
+    if (!f) return 0;
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    for (int y = 0; ok && y < key->height; ++y) {
+        ok = fwrite(pixels + (size_t)y * stride, rowBytes, 1, f) == 1;
+    }
+    if (fclose(f) != 0) ok = 0;
+    if (!ok || !ReplaceCacheFile(tempPath, path)) {
+        RemoveCacheFile(tempPath);
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,57 @@
+#ifndef WARM_START_H
+#define WARM_START_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "schedule.h"
+
+// 预热缓存：把一帧合成好的窗口像素（预乘 BGRA）连同其键写入文件，下次冷启动时在建立字体、
+// 测量文本与布局之前直接读回，先提交这一帧，真实的首帧随后照常渲染并替换它
+// 文件布局（小端）：WarmStartFileHeader，之后是 width * height 个像素，按行紧密存放
+// 键为课程表内容的哈希、窗口尺寸、DPI、视图与星期；另记录该帧有效的时段（当前节次不变的分钟范围）
+// 读取时先只读文件头，键与时段都吻合才读入像素；像素带校验和，截断或损坏的文件不会被提交
+// 本模块只用 stdio，可在 Linux 上编译
+
+#define WARM_START_MAGIC   0x53575454u   // "TTWS"
+#define WARM_START_VERSION 1
+
+typedef struct {
+    uint64_t scheduleHash;   // WarmStartScheduleHash
+    int width;
+    int height;
+    unsigned int dpi;
+    int viewMode;
+    int today;               // 0=周一
+} WarmStartKey;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint64_t scheduleHash;
+    int32_t width;
+    int32_t height;
+    uint32_t dpi;
+    int32_t viewMode;
+    int32_t today;
+    int32_t firstMinute;     // 该帧在 [firstMinute, endMinute) 内与实际渲染一致
+    int32_t endMinute;
+    uint32_t reserved;
+    uint64_t pixelHash;      // 像素数据的 WarmStartHash
+} WarmStartFileHeader;
+
+// 64 位哈希（按 8 字节字混合，用于判断内容是否变化，不用于安全目的）
+uint64_t WarmStartHash(const void *data, size_t size, uint64_t seed);
+
+// 课程表镜像（文件头起的 fileSize 字节）的哈希；内置课程表与内容相同的 .ttb 哈希相同
+uint64_t WarmStartScheduleHash(const Schedule *schedule);
+
+// 读取 path（UTF-8）处的缓存：键一致且 minuteOfDay 落在记录的时段内时，把像素逐行读入 pixels
+// （每行 stride 个像素，至少 key->width）；成功返回 1，失败时 pixels 的内容不确定
+int WarmStartLoad(const char *path, const WarmStartKey *key, int minuteOfDay, uint32_t *pixels, int stride);
+
+// 写入缓存：先写到 path 加 ".tmp" 的临时文件，完整写入后再替换 path，中途失败不会留下半个文件
+int WarmStartSave(const char *path, const WarmStartKey *key, int firstMinute, int endMinute,
+                  const uint32_t *pixels, int stride);
+
+#endif // WARM_START_H
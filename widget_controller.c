@@ -0,0 +1,321 @@
+#include "widget_controller.h"
+#include "render_core.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+WidgetSnapEdge WidgetDetectSnapEdge(const WidgetRect *rect, const WidgetMetrics *metrics) {
+    if (!rect || !metrics) return WIDGET_SNAP_NONE;
+    int snapDist = RenderScaleForDpi(WIDGET_SNAP_DIST, metrics->dpi);
+    int snapMargin = RenderScaleForDpi(WIDGET_SNAP_MARGIN, metrics->dpi);
+    if (abs(rect->left - snapMargin) <= snapDist) {
+        return WIDGET_SNAP_LEFT;
+    }
+    if (abs((metrics->screenWidth - snapMargin) - rect->right) <= snapDist) {
+        return WIDGET_SNAP_RIGHT;
+    }
+    return WIDGET_SNAP_NONE;
+}
+
+// 按最近的截止时间设置定时器；只在动画期间提高系统定时器精度
+static void ScheduleNextWake(WidgetController *controller) {
+    const WidgetBackend *backend = &controller->backend;
+    int wantHighResolution = FrameSchedulerWantsHighResolution(&controller->scheduler);
+    if (wantHighResolution && !controller->highResolution) {
+        controller->highResolution = backend->setHighResolution(backend->user, 1);
+    } else if (!wantHighResolution && controller->highResolution) {
+        backend->setHighResolution(backend->user, 0);
+        controller->highResolution = 0;
+    }
+    backend->armTimer(backend->user, FrameSchedulerNextDelay(&controller->scheduler));
+}
+
+// 按当前档位设置动画与滚动帧间隔；滚动速度按时间计算，不随帧率变化
+static void ApplyFrameTier(WidgetController *controller) {
+    FrameSchedulerSetIntervals(&controller->scheduler, FrameTierIntervalMs(controller->governor.tier),
+                               FrameGovernorMarqueeIntervalMs(&controller->governor, RENDER_MARQUEE_PIXELS_PER_SECOND));
+}
+
+// HUD 中显示各原因的重绘请求数与合并后的实际重绘数，以及帧率档位与限制它的原因
+static void UpdateHudNote(WidgetController *controller) {
+    static const char *const names[FRAME_INVALIDATE_REASON_COUNT] = {
+        "create", "size", "paint", "anim", "content", "settings"
+    };
+    const FrameSchedulerStats *stats = &controller->scheduler.stats;
+    char note[160];
+    int length = snprintf(note, sizeof(note), "inval");
+    for (int i = 0; i < FRAME_INVALIDATE_REASON_COUNT && length > 0 && length < (int)sizeof(note); ++i) {
+        if (stats->invalidations[i]) {
+            length += snprintf(note + length, sizeof(note) - length, " %s %llu", names[i], stats->invalidations[i]);
+        }
+    }
+    if (length > 0 && length < (int)sizeof(note)) {
+        length += snprintf(note + length, sizeof(note) - length, " -> %llu", stats->invalidatedFrames);
+    }
+
+    // 档位是上限；滚动帧的实际帧率另受文本移动速度限制
+    static const char *const limitNames[] = {"cost", "battery", "saver", "covered"};
+    const FrameGovernor *governor = &controller->governor;
+    if (length > 0 && length < (int)sizeof(note)) {
+        length += snprintf(note + length, sizeof(note) - length, "\nfps %u marquee %u cost %.2fms",
+                           FrameTierFps(governor->tier), 1000u / controller->scheduler.marqueeIntervalMs,
+                           governor->avgCostMs);
+    }
+    for (int i = 0; i < (int)(sizeof(limitNames) / sizeof(limitNames[0])) && length > 0 && length < (int)sizeof(note); ++i) {
+        if (governor->limits & (1u << i)) {
+            length += snprintf(note + length, sizeof(note) - length, " %s", limitNames[i]);
+        }
+    }
+    controller->backend.setHudNote(controller->backend.user, note);
+}
+
+// 帧截止时间：有重绘请求时完整重绘一次，否则按需只画滚动帧
+// 帧由后端异步完成，滚动与内容截止时间在 WidgetControllerOnFramePresented 中更新
+static void ServiceFrame(WidgetController *controller, unsigned int due) {
+    const WidgetBackend *backend = &controller->backend;
+    if (FrameSchedulerTakeInvalidations(&controller->scheduler)) {
+        if (controller->hudEnabled) {
+            UpdateHudNote(controller);
+            controller->nextHudRefreshMs = FrameSchedulerNow(&controller->scheduler) + WIDGET_HUD_REFRESH_MS;
+        }
+        backend->render(backend->user, controller->viewMode, 0);
+    } else if (due & FRAME_WAKE_MARQUEE) {
+        backend->render(backend->user, controller->viewMode, 1);
+    }
+}
+
+void WidgetControllerInit(WidgetController *controller, const WidgetBackend *backend, const FrameClock *clock,
+                          int viewMode, const WidgetRect *windowRect, const WidgetMetrics *metrics) {
+    memset(controller, 0, sizeof(*controller));
+    controller->backend = *backend;
+    controller->viewMode = viewMode;
+    controller->snapEdge = WIDGET_SNAP_RIGHT;
+    controller->originalWidth = windowRect->right - windowRect->left;
+    controller->originalHeight = windowRect->bottom - windowRect->top;
+    FrameGovernorInit(&controller->governor, FRAME_GOVERNOR_DEFAULT_BUDGET_MS);
+    FrameSchedulerInit(&controller->scheduler, clock, FrameTierIntervalMs(controller->governor.tier),
+                       FrameGovernorMarqueeIntervalMs(&controller->governor, RENDER_MARQUEE_PIXELS_PER_SECOND));
+
+    // 首次渲染：与随后显示窗口引起的 WM_SIZE / WM_PAINT 合并为一次
+    WidgetControllerInvalidate(controller, FRAME_INVALIDATE_CREATE);
+    controller->snapEdge = WidgetDetectSnapEdge(windowRect, metrics);
+}
+
+void WidgetControllerInvalidate(WidgetController *controller, FrameInvalidateReason reason) {
+    if (FrameSchedulerInvalidate(&controller->scheduler, reason) && !controller->animating) {
+        controller->backend.postService(controller->backend.user);
+    }
+}
+
+void WidgetControllerService(WidgetController *controller) {
+    // 动画期间的请求由动画帧处理
+    if (!controller->animating) {
+        ServiceFrame(controller, 0);
+    }
+}
+
+// 缩放动画的一帧：三次缓出插值，到时后停在目标矩形
+static int StepAnimation(WidgetController *controller, const WidgetMetrics *metrics) {
+    const WidgetBackend *backend = &controller->backend;
+    const WidgetRect *from = &controller->startRect;
+    const WidgetRect *to = &controller->targetRect;
+    double elapsed = (double)(FrameSchedulerNow(&controller->scheduler) - controller->animationStartMs);
+    if (elapsed >= WIDGET_ANIMATION_DURATION_MS) {
+        backend->setWindowRect(backend->user, to, 0);
+        controller->animating = 0;
+        FrameSchedulerStopAnimation(&controller->scheduler);
+        controller->snapEdge = WidgetDetectSnapEdge(to, metrics);
+        return 1;
+    }
+
+    double progress = elapsed / WIDGET_ANIMATION_DURATION_MS;
+    progress = 1.0 - pow(1.0 - progress, 3.0);
+
+    int startWidth = from->right - from->left;
+    int startHeight = from->bottom - from->top;
+    int targetWidth = to->right - to->left;
+    int targetHeight = to->bottom - to->top;
+
+    WidgetRect current;
+    current.left = from->left + (int)((to->left - from->left) * progress);
+    current.top = from->top + (int)((to->top - from->top) * progress);
+    current.right = current.left + startWidth + (int)((targetWidth - startWidth) * progress);
+    current.bottom = current.top + startHeight + (int)((targetHeight - startHeight) * progress);
+    backend->setWindowRect(backend->user, &current, 0);
+    return 0;
+}
+
+void WidgetControllerOnTimer(WidgetController *controller, const WidgetMetrics *metrics) {
+    unsigned int due = FrameSchedulerDispatch(&controller->scheduler);
+    int animationFinished = 0;
+
+    // 下面的 ServiceFrame 立即处理这些请求，不必再投递服务消息
+    if (controller->animating && (due & FRAME_WAKE_ANIMATION)) {
+        animationFinished = StepAnimation(controller, metrics);
+        // 移动窗口引起的 WM_SIZE 已记录为 size，与动画帧合并为一次重绘
+        FrameSchedulerInvalidate(&controller->scheduler, FRAME_INVALIDATE_ANIMATION);
+    }
+    if (due & FRAME_WAKE_CONTENT) {
+        FrameSchedulerInvalidate(&controller->scheduler, FRAME_INVALIDATE_CONTENT);
+    }
+
+    ServiceFrame(controller, due);
+    if (animationFinished) {
+        // 最后一帧仍使用预留的表面；之后的渲染可按实际尺寸收缩
+        controller->backend.reserveSurfaces(controller->backend.user, 0, 0);
+    }
+    ScheduleNextWake(controller);
+}
+
+// 没有动画与滚动文本、下一次重绘又还远时进入空闲，释放渲染资源，到下一次截止时间再重建
+void WidgetControllerOnFramePresented(WidgetController *controller) {
+    const WidgetBackend *backend = &controller->backend;
+    // 只有动画与滚动帧的成本决定档位；空闲时偶尔的完整重绘不计入，也不必检查遮挡
+    if (controller->animating || controller->scheduler.marqueeActive) {
+        int changed = FrameGovernorRecordFrame(&controller->governor, backend->lastFrameCostMs(backend->user));
+        uint64_t now = FrameSchedulerNow(&controller->scheduler);
+        if (now >= controller->nextOcclusionCheckMs) {
+            controller->nextOcclusionCheckMs = now + WIDGET_OCCLUSION_POLL_MS;
+            changed |= FrameGovernorSetOccluded(&controller->governor, backend->isOccluded(backend->user));
+        }
+        if (changed) {
+            ApplyFrameTier(controller);
+        }
+    }
+    int marquee = backend->hasOverflow(backend->user);
+    FrameSchedulerSetMarquee(&controller->scheduler, marquee);
+    int64_t contentDelay = backend->msUntilContentChange(backend->user);
+    if (controller->hudEnabled) {
+        // 按上次完整重绘计时：滚动帧不推迟 HUD 的刷新
+        uint64_t now = FrameSchedulerNow(&controller->scheduler);
+        int64_t hudDelay = controller->nextHudRefreshMs > now ? (int64_t)(controller->nextHudRefreshMs - now) : 0;
+        if (contentDelay < 0 || contentDelay > hudDelay) {
+            contentDelay = hudDelay;
+        }
+    }
+    FrameSchedulerSetContentDelay(&controller->scheduler, contentDelay);
+    ScheduleNextWake(controller);
+    if (!controller->animating && !marquee && contentDelay >= WIDGET_IDLE_TRIM_MIN_MS) {
+        backend->trimIdle(backend->user);
+    }
+}
+
+// 按贴边方向放置宽度为 width 的目标矩形；未贴边时保持左边并限制在屏幕内
+static void PlaceTarget(WidgetRect *target, const WidgetRect *current, WidgetSnapEdge edge,
+                        int width, int screenWidth, int snapMargin) {
+    if (edge == WIDGET_SNAP_LEFT) {
+        target->left = current->left;
+        target->right = target->left + width;
+    } else if (edge == WIDGET_SNAP_RIGHT) {
+        target->right = current->right;
+        target->left = target->right - width;
+    } else {
+        target->left = current->left;
+        target->right = target->left + width;
+        if (target->right > screenWidth - snapMargin) {
+            target->right = screenWidth - snapMargin;
+            target->left = target->right - width;
+        }
+        if (target->left < snapMargin) {
+            target->left = snapMargin;
+            target->right = target->left + width;
+        }
+    }
+}
+
+void WidgetControllerSwitchView(WidgetController *controller, const WidgetRect *current, const WidgetMetrics *metrics) {
+    controller->viewMode = 1 - controller->viewMode;
+
+    WidgetSnapEdge edge = WidgetDetectSnapEdge(current, metrics);
+    if (edge != WIDGET_SNAP_NONE) {
+        controller->snapEdge = edge;
+    }
+
+    // 日视图宽度缩小到 1/3，周视图恢复原始大小；高度不变，沿贴边方向收缩或展开
+    WidgetRect *target = &controller->targetRect;
+    *target = *current;
+    target->bottom = target->top + controller->originalHeight;
+    int width = controller->originalWidth;
+    if (controller->viewMode == 0) {
+        width = controller->originalWidth >= 3 ? controller->originalWidth / 3 : 1;
+    }
+    PlaceTarget(target, current, controller->snapEdge, width, metrics->screenWidth,
+                RenderScaleForDpi(WIDGET_SNAP_MARGIN, metrics->dpi));
+
+    edge = WidgetDetectSnapEdge(target, metrics);
+    if (edge != WIDGET_SNAP_NONE) {
+        controller->snapEdge = edge;
+    }
+
+    // 按起止尺寸中较大者预留表面，动画各帧只改变使用的子矩形
+    int reserveWidth = current->right - current->left;
+    int reserveHeight = current->bottom - current->top;
+    if (target->right - target->left > reserveWidth) reserveWidth = target->right - target->left;
+    if (target->bottom - target->top > reserveHeight) reserveHeight = target->bottom - target->top;
+    controller->backend.reserveSurfaces(controller->backend.user, reserveWidth, reserveHeight);
+
+    controller->startRect = *current;
+    controller->animationStartMs = FrameSchedulerNow(&controller->scheduler);
+    controller->animating = 1;
+    FrameSchedulerStartAnimation(&controller->scheduler);
+    ScheduleNextWake(controller);
+}
+
+void WidgetControllerEndMove(WidgetController *controller, const WidgetRect *rect, const WidgetMetrics *metrics) {
+    int width = rect->right - rect->left;
+    int height = rect->bottom - rect->top;
+    if (controller->viewMode == 1) {
+        controller->originalWidth = width;
+        controller->originalHeight = height;
+    }
+
+    int snapDist = RenderScaleForDpi(WIDGET_SNAP_DIST, metrics->dpi);
+    int snapMargin = RenderScaleForDpi(WIDGET_SNAP_MARGIN, metrics->dpi);
+    int x = rect->left, y = rect->top;
+    if (abs(rect->left) < snapDist) {
+        x = snapMargin;
+    }
+    if (abs(metrics->screenWidth - rect->right) < snapDist) {
+        x = metrics->screenWidth - width - snapMargin;
+        if (x < 0) x = 0;
+    }
+    if (abs(rect->top) < snapDist) {
+        y = snapMargin;
+    }
+    if (abs(metrics->screenHeight - rect->bottom) < snapDist) {
+        y = metrics->screenHeight - height - snapMargin;
+        if (y < 0) y = 0;
+    }
+
+    WidgetRect snapped = {x, y, x + width, y + height};
+    controller->backend.setWindowRect(controller->backend.user, &snapped, 1);
+    controller->snapEdge = WidgetDetectSnapEdge(&snapped, metrics);
+}
+
+void WidgetControllerSetHud(WidgetController *controller, int enabled) {
+    controller->hudEnabled = enabled ? 1 : 0;
+    WidgetControllerInvalidate(controller, FRAME_INVALIDATE_SETTINGS);
+    ScheduleNextWake(controller);
+}
+
+void WidgetControllerSetFrameBudget(WidgetController *controller, double budgetMs) {
+    controller->governor.budgetMs = budgetMs > 0.0 ? budgetMs : FRAME_GOVERNOR_DEFAULT_BUDGET_MS;
+}
+
+void WidgetControllerSetPower(WidgetController *controller, int onBattery, int batterySaver) {
+    if (FrameGovernorSetPower(&controller->governor, onBattery, batterySaver)) {
+        ApplyFrameTier(controller);
+        ScheduleNextWake(controller);
+    }
+}
+
+void WidgetControllerShutdown(WidgetController *controller) {
+    FrameSchedulerStopAnimation(&controller->scheduler);
+    controller->animating = 0;
+    controller->backend.armTimer(controller->backend.user, FRAME_SCHEDULER_NO_DEADLINE);
+    if (controller->highResolution) {
+        controller->backend.setHighResolution(controller->backend.user, 0);
+        controller->highResolution = 0;
+    }
+}
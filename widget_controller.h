@@ -0,0 +1,110 @@
+#ifndef WIDGET_CONTROLLER_H
+#define WIDGET_CONTROLLER_H
+
+#include <stdint.h>
+#include "frame_scheduler.h"
+#include "frame_governor.h"
+
+// 窗口的计时状态机：视图切换的缩放动画、贴边吸附、重绘请求合并、空闲释放、帧率档位与定时器截止时间
+// 移动窗口、渲染与定时器经 WidgetBackend 回调完成，时间取自 FrameClock；本模块不依赖 Win32，
+// timetable.c 的 WndProc 只把消息转发到这里，也可在 Linux 上用虚拟时钟与假的后端按脚本驱动，
+// 统计每个场景的渲染、表面预留与定时器设置次数
+
+#define WIDGET_ANIMATION_DURATION_MS 300
+#define WIDGET_HUD_REFRESH_MS        500   // HUD 打开时至少每隔这么久完整重绘一次
+#define WIDGET_IDLE_TRIM_MIN_MS      2000  // 距下一次重绘至少这么久才在空闲时释放表面与缓存
+#define WIDGET_SNAP_DIST             20    // 96 DPI 下的吸附距离与贴边边距，按窗口 DPI 缩放
+#define WIDGET_SNAP_MARGIN           10
+#define WIDGET_OCCLUSION_POLL_MS     1000  // 有动画或滚动帧时检查遮挡的最短间隔，空闲时不检查
+
+typedef struct {
+    int left;
+    int top;
+    int right;
+    int bottom;
+} WidgetRect;
+
+typedef enum {
+    WIDGET_SNAP_NONE = 0,
+    WIDGET_SNAP_LEFT,
+    WIDGET_SNAP_RIGHT
+} WidgetSnapEdge;
+
+// 事件发生时的屏幕尺寸与窗口 DPI
+typedef struct {
+    int screenWidth;
+    int screenHeight;
+    unsigned int dpi;
+} WidgetMetrics;
+
+// 平台操作；回调可以同步回到本模块（例如 setWindowRect 引起的 WM_SIZE 调用 WidgetControllerInvalidate）
+typedef struct {
+    void *user;
+    void (*setWindowRect)(void *user, const WidgetRect *rect, int redraw);   // 移动/缩放窗口并保持在底层
+    void (*render)(void *user, int viewMode, int marquee);   // 请求完整渲染；marquee 为 1 时只画滚动帧
+    void (*postService)(void *user);        // 当前这批消息处理完后调用一次 WidgetControllerService
+    void (*armTimer)(void *user, int64_t delayMs);   // delayMs 后调用 WidgetControllerOnTimer；FRAME_SCHEDULER_NO_DEADLINE 为取消
+    int (*setHighResolution)(void *user, int enable);   // 提高/恢复系统定时器精度，返回是否生效
+    void (*reserveSurfaces)(void *user, int width, int height);
+    void (*trimIdle)(void *user);
+    void (*setHudNote)(void *user, const char *note);
+    int (*hasOverflow)(void *user);                 // 最近一帧是否有滚动文本
+    int64_t (*msUntilContentChange)(void *user);    // 距下一次内容变化的毫秒数，尚未渲染为 -1
+    double (*lastFrameCostMs)(void *user);          // 最近一帧的渲染与提交耗时
+    int (*isOccluded)(void *user);                  // 窗口是否被其他窗口完全遮挡
+} WidgetBackend;
+
+typedef struct {
+    WidgetBackend backend;
+    FrameScheduler scheduler;   // 只用一个定时器，按最近的截止时间设置
+    FrameGovernor governor;     // 动画与滚动帧的帧率档位
+    int viewMode;               // 0=日视图，1=周视图
+    int hudEnabled;
+    int animating;
+    uint64_t animationStartMs;
+    WidgetRect startRect;
+    WidgetRect targetRect;
+    int originalWidth;          // 周视图的窗口尺寸
+    int originalHeight;
+    WidgetSnapEdge snapEdge;
+    int highResolution;         // 已提高系统定时器精度
+    uint64_t nextOcclusionCheckMs;
+    uint64_t nextHudRefreshMs;  // HUD 打开时下一次必须完整重绘的时刻
+} WidgetController;
+
+// windowRect 为创建后的窗口矩形（周视图尺寸）；检测贴边并请求首帧
+void WidgetControllerInit(WidgetController *controller, const WidgetBackend *backend, const FrameClock *clock,
+                          int viewMode, const WidgetRect *windowRect, const WidgetMetrics *metrics);
+
+// 记录重绘请求；同一帧截止时间之前的请求合并为一次完整重绘
+// 动画期间由下一动画帧处理，否则经 postService 在当前这批消息之后处理
+void WidgetControllerInvalidate(WidgetController *controller, FrameInvalidateReason reason);
+
+// postService 的回调：处理动画之外合并的重绘请求
+void WidgetControllerService(WidgetController *controller);
+
+// 定时器到期：推进动画、处理内容截止时间与滚动帧，再按最近的截止时间重新设置定时器
+void WidgetControllerOnTimer(WidgetController *controller, const WidgetMetrics *metrics);
+
+// 新帧提交后：更新滚动状态与内容截止时间；空闲时释放渲染资源
+void WidgetControllerOnFramePresented(WidgetController *controller);
+
+// 切换日/周视图：按贴边方向计算目标矩形并开始缩放动画
+void WidgetControllerSwitchView(WidgetController *controller, const WidgetRect *current, const WidgetMetrics *metrics);
+
+// 拖动结束：靠近屏幕边缘时吸附；周视图下记录新的窗口尺寸
+void WidgetControllerEndMove(WidgetController *controller, const WidgetRect *rect, const WidgetMetrics *metrics);
+
+void WidgetControllerSetHud(WidgetController *controller, int enabled);
+
+// 帧率档位的输入：每秒渲染预算（<= 0 为默认值）与电源状态；档位变化时立即调整帧间隔
+// 窗口是否被完全遮挡由 WidgetControllerOnFramePresented 在有动画或滚动帧时经 isOccluded 定期检查
+void WidgetControllerSetFrameBudget(WidgetController *controller, double budgetMs);
+void WidgetControllerSetPower(WidgetController *controller, int onBattery, int batterySaver);
+
+// 取消定时器并恢复系统定时器精度（窗口销毁时调用）
+void WidgetControllerShutdown(WidgetController *controller);
+
+WidgetSnapEdge WidgetDetectSnapEdge(const WidgetRect *rect, const WidgetMetrics *metrics);
+
+#endif // WIDGET_CONTROLLER_H